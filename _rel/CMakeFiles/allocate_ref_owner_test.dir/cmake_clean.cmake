@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/allocate_ref_owner_test.dir/test/allocate_ref_owner_test.cpp.o"
+  "CMakeFiles/allocate_ref_owner_test.dir/test/allocate_ref_owner_test.cpp.o.d"
+  "allocate_ref_owner_test"
+  "allocate_ref_owner_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/allocate_ref_owner_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/atomic_reference_test.dir/test/atomic_reference_test.cpp.o"
+  "CMakeFiles/atomic_reference_test.dir/test/atomic_reference_test.cpp.o.d"
+  "atomic_reference_test"
+  "atomic_reference_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/atomic_reference_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/flight_recorder_test.dir/test/flight_recorder_test.cpp.o"
+  "CMakeFiles/flight_recorder_test.dir/test/flight_recorder_test.cpp.o.d"
+  "flight_recorder_test"
+  "flight_recorder_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/flight_recorder_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
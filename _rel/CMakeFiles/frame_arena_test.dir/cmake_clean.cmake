@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/frame_arena_test.dir/test/frame_arena_test.cpp.o"
+  "CMakeFiles/frame_arena_test.dir/test/frame_arena_test.cpp.o.d"
+  "frame_arena_test"
+  "frame_arena_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/frame_arena_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/frame_executor_test.dir/test/frame_executor_test.cpp.o"
+  "CMakeFiles/frame_executor_test.dir/test/frame_executor_test.cpp.o.d"
+  "frame_executor_test"
+  "frame_executor_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/frame_executor_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/hello_world.dir/src/main.cpp.o"
+  "CMakeFiles/hello_world.dir/src/main.cpp.o.d"
+  "hello_world"
+  "hello_world.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/hello_world.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
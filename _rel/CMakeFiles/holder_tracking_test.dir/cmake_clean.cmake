@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/holder_tracking_test.dir/test/holder_tracking_test.cpp.o"
+  "CMakeFiles/holder_tracking_test.dir/test/holder_tracking_test.cpp.o.d"
+  "holder_tracking_test"
+  "holder_tracking_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/holder_tracking_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
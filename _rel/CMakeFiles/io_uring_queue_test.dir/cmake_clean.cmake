@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/io_uring_queue_test.dir/test/io_uring_queue_test.cpp.o"
+  "CMakeFiles/io_uring_queue_test.dir/test/io_uring_queue_test.cpp.o.d"
+  "io_uring_queue_test"
+  "io_uring_queue_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/io_uring_queue_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
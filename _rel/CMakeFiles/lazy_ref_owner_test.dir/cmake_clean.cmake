@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/lazy_ref_owner_test.dir/test/lazy_ref_owner_test.cpp.o"
+  "CMakeFiles/lazy_ref_owner_test.dir/test/lazy_ref_owner_test.cpp.o.d"
+  "lazy_ref_owner_test"
+  "lazy_ref_owner_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/lazy_ref_owner_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/mapped_file_test.dir/test/mapped_file_test.cpp.o"
+  "CMakeFiles/mapped_file_test.dir/test/mapped_file_test.cpp.o.d"
+  "mapped_file_test"
+  "mapped_file_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/mapped_file_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/pinned_memory_test.dir/test/pinned_memory_test.cpp.o"
+  "CMakeFiles/pinned_memory_test.dir/test/pinned_memory_test.cpp.o.d"
+  "pinned_memory_test"
+  "pinned_memory_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/pinned_memory_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/recycling_pool_test.dir/test/recycling_pool_test.cpp.o"
+  "CMakeFiles/recycling_pool_test.dir/test/recycling_pool_test.cpp.o.d"
+  "recycling_pool_test"
+  "recycling_pool_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/recycling_pool_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
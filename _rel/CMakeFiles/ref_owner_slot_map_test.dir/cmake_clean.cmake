@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/ref_owner_slot_map_test.dir/test/ref_owner_slot_map_test.cpp.o"
+  "CMakeFiles/ref_owner_slot_map_test.dir/test/ref_owner_slot_map_test.cpp.o.d"
+  "ref_owner_slot_map_test"
+  "ref_owner_slot_map_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/ref_owner_slot_map_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
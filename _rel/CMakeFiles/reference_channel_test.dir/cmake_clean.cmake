@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/reference_channel_test.dir/test/reference_channel_test.cpp.o"
+  "CMakeFiles/reference_channel_test.dir/test/reference_channel_test.cpp.o.d"
+  "reference_channel_test"
+  "reference_channel_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/reference_channel_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
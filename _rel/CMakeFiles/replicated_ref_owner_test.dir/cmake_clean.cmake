@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/replicated_ref_owner_test.dir/test/replicated_ref_owner_test.cpp.o"
+  "CMakeFiles/replicated_ref_owner_test.dir/test/replicated_ref_owner_test.cpp.o.d"
+  "replicated_ref_owner_test"
+  "replicated_ref_owner_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/replicated_ref_owner_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/shared_ptr_bridge_test.dir/test/shared_ptr_bridge_test.cpp.o"
+  "CMakeFiles/shared_ptr_bridge_test.dir/test/shared_ptr_bridge_test.cpp.o.d"
+  "shared_ptr_bridge_test"
+  "shared_ptr_bridge_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/shared_ptr_bridge_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
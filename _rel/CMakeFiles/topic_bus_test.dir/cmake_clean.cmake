@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/topic_bus_test.dir/test/topic_bus_test.cpp.o"
+  "CMakeFiles/topic_bus_test.dir/test/topic_bus_test.cpp.o.d"
+  "topic_bus_test"
+  "topic_bus_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/topic_bus_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/usdt_probes_test.dir/test/usdt_probes_test.cpp.o"
+  "CMakeFiles/usdt_probes_test.dir/test/usdt_probes_test.cpp.o.d"
+  "usdt_probes_test"
+  "usdt_probes_test.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/usdt_probes_test.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,57 @@
+# CMake generated Testfile for 
+# Source directory: /root/repo
+# Build directory: /root/repo/_rel
+# 
+# This file includes the relevant testing commands required for 
+# testing this directory and lists subdirectories to be tested as well.
+add_test(hello_world_runs "/root/repo/_rel/hello_world")
+set_tests_properties(hello_world_runs PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;368;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(ref_owner_test "/root/repo/_rel/ref_owner_test")
+set_tests_properties(ref_owner_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;369;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(atomic_reference_test "/root/repo/_rel/atomic_reference_test")
+set_tests_properties(atomic_reference_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;370;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(replicated_ref_owner_test "/root/repo/_rel/replicated_ref_owner_test")
+set_tests_properties(replicated_ref_owner_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;371;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(lazy_ref_owner_test "/root/repo/_rel/lazy_ref_owner_test")
+set_tests_properties(lazy_ref_owner_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;372;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(ref_owner_pool_test "/root/repo/_rel/ref_owner_pool_test")
+set_tests_properties(ref_owner_pool_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;373;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(recycling_pool_test "/root/repo/_rel/recycling_pool_test")
+set_tests_properties(recycling_pool_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;374;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(allocate_ref_owner_test "/root/repo/_rel/allocate_ref_owner_test")
+set_tests_properties(allocate_ref_owner_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;375;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(frame_arena_test "/root/repo/_rel/frame_arena_test")
+set_tests_properties(frame_arena_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;376;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(pinned_memory_test "/root/repo/_rel/pinned_memory_test")
+set_tests_properties(pinned_memory_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;377;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(ref_owner_map_test "/root/repo/_rel/ref_owner_map_test")
+set_tests_properties(ref_owner_map_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;378;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(ref_owner_cache_test "/root/repo/_rel/ref_owner_cache_test")
+set_tests_properties(ref_owner_cache_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;379;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(ref_owner_slot_map_test "/root/repo/_rel/ref_owner_slot_map_test")
+set_tests_properties(ref_owner_slot_map_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;380;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(ref_owner_skip_list_test "/root/repo/_rel/ref_owner_skip_list_test")
+set_tests_properties(ref_owner_skip_list_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;381;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(reference_channel_test "/root/repo/_rel/reference_channel_test")
+set_tests_properties(reference_channel_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;382;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(topic_bus_test "/root/repo/_rel/topic_bus_test")
+set_tests_properties(topic_bus_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;383;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(frame_executor_test "/root/repo/_rel/frame_executor_test")
+set_tests_properties(frame_executor_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;384;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(shared_memory_owner_test "/root/repo/_rel/shared_memory_owner_test")
+set_tests_properties(shared_memory_owner_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;385;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(mapped_file_test "/root/repo/_rel/mapped_file_test")
+set_tests_properties(mapped_file_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;386;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(io_uring_queue_test "/root/repo/_rel/io_uring_queue_test")
+set_tests_properties(io_uring_queue_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;387;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(shared_ptr_bridge_test "/root/repo/_rel/shared_ptr_bridge_test")
+set_tests_properties(shared_ptr_bridge_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;388;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(ref_owner_stats_test "/root/repo/_rel/ref_owner_stats_test")
+set_tests_properties(ref_owner_stats_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;389;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(usdt_probes_test "/root/repo/_rel/usdt_probes_test")
+set_tests_properties(usdt_probes_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;390;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(flight_recorder_test "/root/repo/_rel/flight_recorder_test")
+set_tests_properties(flight_recorder_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;391;add_test;/root/repo/CMakeLists.txt;0;")
+add_test(holder_tracking_test "/root/repo/_rel/holder_tracking_test")
+set_tests_properties(holder_tracking_test PROPERTIES  _BACKTRACE_TRIPLES "/root/repo/CMakeLists.txt;392;add_test;/root/repo/CMakeLists.txt;0;")
+subdirs("_deps/googletest-build")
@@ -0,0 +1,147 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Allocator-aware and std::pmr construction of ref_owner
+ */
+#ifndef ZOOX_ALLOCATE_REF_OWNER_H
+#define ZOOX_ALLOCATE_REF_OWNER_H
+
+// =============================================================================
+// zoox::allocate_ref_owner - ref_owner construction through an allocator
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// ref_owner can only adopt a T* or a unique_ptr, which leaves allocation to
+// the caller (docs/ref_owner_proposal.md, open question 4). These helpers
+// allocate and construct T through any standard Allocator and install an
+// allocator_deleter that destroys and deallocates through a copy of the same
+// allocator when delete_if_deleteable() runs.
+//
+// ref_owner keeps all of its own state (count, flags, deleter) inline, so the
+// managed object is the only allocation. Nothing touches the global heap when
+// alloc doesn't.
+//
+// BASIC USAGE
+// -----------
+//
+//   // Any standard allocator
+//   auto owner = zoox::allocate_ref_owner<Track>(my_alloc, id, state);
+//
+//   // std::pmr, e.g. a per-subsystem monotonic arena
+//   std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+//   auto owner = zoox::pmr::allocate_ref_owner<Track>(&arena, id, state);
+//   zoox::pmr::ref_owner<Track>& same_type = owner;
+//
+//   // For waitable_ref_owner (or any owner taking a unique_ptr)
+//   zoox::waitable_ref_owner<Track, std::optional, zoox::allocator_deleter<Track, Alloc>> w(
+//       zoox::allocate_owned<Track>(my_alloc, id, state));
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <memory>
+#include <utility>
+
+#if defined(__has_include)
+#    if __has_include(<memory_resource>)
+#        include <memory_resource>
+#    endif
+#endif
+
+namespace zoox
+{
+
+// Deleter that destroys and deallocates through a stored allocator
+template <typename T, typename Alloc>
+class allocator_deleter
+{
+public:
+    using allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<T>;
+
+    explicit allocator_deleter(const Alloc& alloc) noexcept
+        : alloc_(alloc)
+    {
+    }
+
+    void operator()(T* p) noexcept
+    {
+        using traits = std::allocator_traits<allocator_type>;
+        traits::destroy(alloc_, p);
+        traits::deallocate(alloc_, p, 1);
+    }
+
+    const allocator_type& get_allocator() const noexcept
+    {
+        return alloc_;
+    }
+
+private:
+    allocator_type alloc_;
+};
+
+// Allocates and constructs T(args...) through alloc. The returned unique_ptr
+// can be adopted by ref_owner or waitable_ref_owner.
+template <typename T, typename Alloc, typename... Args>
+std::unique_ptr<T, allocator_deleter<T, Alloc>> allocate_owned(const Alloc& alloc, Args&&... args)
+{
+    using deleter = allocator_deleter<T, Alloc>;
+    using traits  = std::allocator_traits<typename deleter::allocator_type>;
+
+    typename deleter::allocator_type rebound(alloc);
+    T*                               p = traits::allocate(rebound, 1);
+#ifdef __cpp_exceptions
+    try
+    {
+#endif
+        traits::construct(rebound, p, std::forward<Args>(args)...);
+#ifdef __cpp_exceptions
+    }
+    catch (...)
+    {
+        traits::deallocate(rebound, p, 1);
+        throw;
+    }
+#endif
+    return std::unique_ptr<T, deleter>(p, deleter(alloc));
+}
+
+// Allocates and constructs T(args...) through alloc and returns an owner that
+// deallocates through the same allocator at delete_if_deleteable()
+template <typename T, template <typename> class OptionalT = std::optional, typename Alloc, typename... Args>
+ref_owner<T, OptionalT, allocator_deleter<T, Alloc>> allocate_ref_owner(const Alloc& alloc, Args&&... args)
+{
+    return ref_owner<T, OptionalT, allocator_deleter<T, Alloc>>(
+        allocate_owned<T>(alloc, std::forward<Args>(args)...));
+}
+
+#if defined(__cpp_lib_memory_resource)
+namespace pmr
+{
+
+template <typename T>
+using allocator_deleter = zoox::allocator_deleter<T, std::pmr::polymorphic_allocator<T>>;
+
+// ref_owner whose object lives in a std::pmr::memory_resource
+template <typename T, template <typename> class OptionalT = std::optional>
+using ref_owner = zoox::ref_owner<T, OptionalT, allocator_deleter<T>>;
+
+template <typename T, template <typename> class OptionalT = std::optional>
+using waitable_ref_owner = zoox::waitable_ref_owner<T, OptionalT, allocator_deleter<T>>;
+
+template <typename T, template <typename> class OptionalT = std::optional, typename... Args>
+ref_owner<T, OptionalT> allocate_ref_owner(std::pmr::memory_resource* resource, Args&&... args)
+{
+    return zoox::allocate_ref_owner<T, OptionalT>(std::pmr::polymorphic_allocator<T>(resource),
+                                                  std::forward<Args>(args)...);
+}
+
+}  // namespace pmr
+#endif
+
+}  // namespace zoox
+
+#endif  // ZOOX_ALLOCATE_REF_OWNER_H
@@ -0,0 +1,168 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Lock-free slot for publishing and exchanging unique_reference instances
+ */
+#ifndef ZOOX_ATOMIC_REFERENCE_H
+#define ZOOX_ATOMIC_REFERENCE_H
+
+// =============================================================================
+// zoox::atomic_reference - A lock-free mailbox for unique_reference
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// unique_reference is move-only and not atomic, so handing one between
+// threads normally needs a mutex around the slot that holds it.
+// atomic_reference<T> is that slot without the mutex: it stores the owner
+// pointer of a registered reference in a single std::atomic, and every
+// operation transfers the registration (the +1 in ref_count_) with one
+// atomic exchange or CAS. The owner's count is never incremented or
+// decremented by a transfer, only by the final release.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::atomic_reference<Frame> mailbox;
+//
+//   // Producer
+//   mailbox.store(owner.make_ref());           // Releases any previous occupant
+//
+//   // Consumer
+//   if (auto frame = mailbox.take()) {         // Slot is empty afterwards
+//       (*frame)->process();
+//   }
+//
+//   // Publish only into an empty slot
+//   const zoox::ref_owner<Frame>* expected = nullptr;
+//   mailbox.compare_exchange_strong(expected, std::move(ref));
+//
+// While a reference sits in the slot it counts as outstanding, so the owner
+// cannot delete the object. Destroying the slot releases its reference.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <atomic>
+#include <utility>
+
+namespace zoox
+{
+
+template <typename ReferenceType, typename BaseType, template <typename> class OptionalT, typename Deleter>
+class atomic_reference
+{
+public:
+    using reference_type = unique_reference<ReferenceType, BaseType, OptionalT, Deleter>;
+    using owner_type     = ref_owner<BaseType, OptionalT, Deleter>;
+
+    // Empty slot
+    atomic_reference() noexcept = default;
+
+    // Slot initially holding ref (ref is moved-from)
+    explicit atomic_reference(reference_type&& ref) noexcept
+        : slot_(release_owner(ref))
+    {
+    }
+
+    ~atomic_reference() noexcept
+    {
+        release(slot_.load(std::memory_order_acquire));
+    }
+
+    // Like std::atomic: neither copyable nor movable
+    atomic_reference(const atomic_reference&)            = delete;
+    atomic_reference& operator=(const atomic_reference&) = delete;
+    atomic_reference(atomic_reference&&)                 = delete;
+    atomic_reference& operator=(atomic_reference&&)      = delete;
+
+    static constexpr bool is_always_lock_free = std::atomic<owner_type*>::is_always_lock_free;
+
+    bool is_lock_free() const noexcept
+    {
+        return slot_.is_lock_free();
+    }
+
+    // Publish ref, releasing whatever reference the slot held before
+    void store(reference_type&& ref) noexcept
+    {
+        release(slot_.exchange(release_owner(ref), std::memory_order_acq_rel));
+    }
+
+    // Publish ref and return the previous occupant (empty if the slot was empty)
+    OptionalT<reference_type> exchange(reference_type&& ref) noexcept
+    {
+        return adopt(slot_.exchange(release_owner(ref), std::memory_order_acq_rel));
+    }
+
+    // Remove and return the current occupant, leaving the slot empty
+    OptionalT<reference_type> take() noexcept
+    {
+        return adopt(slot_.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+    // If the slot holds a reference to *expected (or is empty when expected is
+    // nullptr), replace it with desired and release the displaced reference.
+    // On failure, expected is updated to the current occupant's owner and
+    // desired is left untouched.
+    bool compare_exchange_strong(const owner_type*& expected, reference_type&& desired) noexcept
+    {
+        owner_type* current = const_cast<owner_type*>(expected);  // NOLINT: identity comparison only
+        // Once published the owner may be released by another thread, so the
+        // holder record (if tracking) has to go first, even if the exchange fails
+        desired.forget_holder();
+        if (slot_.compare_exchange_strong(current, desired.owner_, std::memory_order_acq_rel))
+        {
+            desired.owner_ = nullptr;
+            release(current);
+            return true;
+        }
+        expected = current;
+        return false;
+    }
+
+    // Owner of the current occupant, for identity comparison only. The
+    // pointer must not be dereferenced: another thread may take and release
+    // the reference at any time.
+    const owner_type* peek() const noexcept
+    {
+        return slot_.load(std::memory_order_acquire);
+    }
+
+    bool has_value() const noexcept
+    {
+        return peek() != nullptr;
+    }
+
+private:
+    static owner_type* release_owner(reference_type& ref) noexcept
+    {
+        return ref.detach();
+    }
+
+    static OptionalT<reference_type> adopt(owner_type* owner) noexcept
+    {
+        if (owner == nullptr)
+        {
+            return {};
+        }
+        return OptionalT<reference_type>(reference_type(owner));
+    }
+
+    static void release(owner_type* owner) noexcept
+    {
+        if (owner != nullptr)
+        {
+            owner->on_ref_released();
+        }
+    }
+
+    std::atomic<owner_type*> slot_{nullptr};
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_ATOMIC_REFERENCE_H
@@ -0,0 +1,405 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Lock-free per-thread flight recorder of ref_owner events, with a Chrome trace converter
+ */
+#ifndef ZOOX_FLIGHT_RECORDER_H
+#define ZOOX_FLIGHT_RECORDER_H
+
+// =============================================================================
+// zoox::flight_recorder - What happened just before the reclaim phase overran
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// The recorder keeps the last EventsPerThread ref_owner events of every
+// thread in fixed memory, allocated once when the recorder is constructed.
+// Each event is a 24-byte record: TSC timestamp, owner address, operation
+// and reference count.
+//
+//   - record() writes to the calling thread's own ring (indexed like
+//     ref_owner_pool's thread caches): no locks, no shared cache lines, no
+//     read-modify-write. Threads beyond detail::max_cached_threads share one
+//     extra ring through a fetch_add. When a thread exits, its ring passes
+//     to the next thread that takes its index.
+//   - dump() copies every ring into one time-ordered flight_dump while
+//     recording continues; records overwritten mid-copy are skipped.
+//   - write_chrome_trace() renders a dump as Chrome trace JSON (also read by
+//     Perfetto): one instant event per operation, a reference-count counter
+//     track per owner, a "drain" span from mark to delete, and wait spans.
+//
+// RECORDING REF_OWNER EVENTS
+// --------------------------
+// Define ZOOX_ENABLE_FLIGHT_RECORDER for the whole program (it changes the
+// code of every ref_owner, so every translation unit must agree):
+//
+//   add_compile_definitions(ZOOX_ENABLE_FLIGHT_RECORDER)
+//
+// ref_owner then records registrations, releases, marks, deletes and
+// waitable_ref_owner waits into global_flight_recorder(). Call it once at
+// startup so its rings are allocated before the real-time loop runs.
+//
+// DUMPING
+// -------
+//
+//   executor.on_violation([](const zoox::frame_violation&) {
+//       std::ofstream out("/var/log/ref_owner.zfr", std::ios::binary);
+//       zoox::write_flight_dump(out, zoox::global_flight_recorder().dump());
+//   });
+//
+//   // Later, offline
+//   zoox::flight_dump dump;
+//   std::ifstream in("ref_owner.zfr", std::ios::binary);
+//   if (zoox::read_flight_dump(in, dump)) {
+//       std::ofstream json("ref_owner.json");
+//       zoox::write_chrome_trace(json, dump);    // Open in ui.perfetto.dev
+//   }
+//
+// The binary dump is in host byte order. dump() allocates and is meant for
+// failure paths and tooling, not the hot loop.
+//
+// =============================================================================
+
+#include "zoox/thread_index_registry.hpp"
+#include "zoox/tsc.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <unordered_set>
+#include <vector>
+
+namespace zoox
+{
+
+enum class flight_op : std::uint8_t
+{
+    ref_register        = 0,  // count: references before the registration
+    ref_register_failed = 1,  // count: references before the rolled-back registration
+    ref_release         = 2,  // count: references before the release
+    mark                = 3,  // count: references at the mark
+    deleted             = 4,  // count: 0
+    delete_blocked      = 5,  // count: references still outstanding
+    wait_begin          = 6,  // count: references when the wait started
+    wait_end            = 7   // count: 1 if deleted, 0 on timeout
+};
+
+inline const char* to_string(flight_op op) noexcept
+{
+    switch (op)
+    {
+        case flight_op::ref_register:
+            return "ref_register";
+        case flight_op::ref_register_failed:
+            return "ref_register_failed";
+        case flight_op::ref_release:
+            return "ref_release";
+        case flight_op::mark:
+            return "mark";
+        case flight_op::deleted:
+            return "deleted";
+        case flight_op::delete_blocked:
+            return "delete_blocked";
+        case flight_op::wait_begin:
+            return "wait_begin";
+        case flight_op::wait_end:
+            return "wait_end";
+    }
+    return "unknown";
+}
+
+struct flight_event
+{
+    std::uint64_t tsc;
+    std::uint64_t owner;
+    std::uint32_t count;     // Saturates at 2^32 - 1
+    std::uint16_t thread;    // Ring index; detail::max_cached_threads for the shared ring
+    flight_op     op;
+    std::uint8_t  reserved;  // 0
+};
+
+static_assert(sizeof(flight_event) == 24, "flight_event is a compact 24-byte record");
+
+struct flight_dump
+{
+    double                    ticks_per_us = 1000.0;  // TSC ticks per microsecond
+    std::vector<flight_event> events;                 // Oldest first
+};
+
+// =============================================================================
+// basic_flight_recorder - Per-thread rings of the last EventsPerThread events
+// =============================================================================
+template <std::size_t EventsPerThread = 1024>
+class basic_flight_recorder
+{
+    static_assert(EventsPerThread > 0 && (EventsPerThread & (EventsPerThread - 1)) == 0,
+                  "EventsPerThread must be a power of two");
+
+public:
+    static constexpr std::size_t events_per_thread = EventsPerThread;
+
+    basic_flight_recorder()
+        : rings_(new ring[ring_count])
+        , start_tsc_(detail::read_tsc())
+        , start_time_(std::chrono::steady_clock::now())
+    {
+    }
+
+    basic_flight_recorder(const basic_flight_recorder&)            = delete;
+    basic_flight_recorder& operator=(const basic_flight_recorder&) = delete;
+
+    void record(flight_op op, const void* owner, std::size_t count) noexcept
+    {
+        const std::size_t thread = detail::thread_index_registry::current();
+        const std::size_t index  = thread < detail::max_cached_threads ? thread : shared_ring;
+        ring&             r      = rings_[index];
+
+        const std::uint64_t position = index == shared_ring ? r.head.fetch_add(1, std::memory_order_relaxed)
+                                                            : r.head.load(std::memory_order_relaxed);
+        slot&               s        = r.slots[position & (EventsPerThread - 1)];
+
+        // Invalidate, write, then publish: a reader that sees the new meta
+        // word also sees this record's timestamp and owner
+        s.meta.store(0, std::memory_order_relaxed);
+        s.tsc.store(detail::read_tsc(), std::memory_order_release);
+        s.owner.store(static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(owner)), std::memory_order_release);
+        s.meta.store(pack(op, count, position), std::memory_order_release);
+        if (index != shared_ring)
+        {
+            r.head.store(position + 1, std::memory_order_release);
+        }
+    }
+
+    // Copies the recorded events of every thread, oldest first
+    flight_dump dump() const
+    {
+        flight_dump d;
+        d.ticks_per_us = ticks_per_us();
+        d.events.reserve(EventsPerThread * 4);
+        for (std::size_t index = 0; index < ring_count; ++index)
+        {
+            const ring&         r     = rings_[index];
+            const std::uint64_t head  = r.head.load(std::memory_order_acquire);
+            const std::uint64_t first = head > EventsPerThread ? head - EventsPerThread : 0;
+            for (std::uint64_t position = first; position < head; ++position)
+            {
+                const slot&         s     = r.slots[position & (EventsPerThread - 1)];
+                const std::uint64_t meta  = s.meta.load(std::memory_order_acquire);
+                const std::uint64_t tsc   = s.tsc.load(std::memory_order_acquire);
+                const std::uint64_t owner = s.owner.load(std::memory_order_acquire);
+                if (meta != s.meta.load(std::memory_order_relaxed) || !is_record_of(meta, position))
+                {
+                    continue;  // Being overwritten, or not written yet
+                }
+                flight_event e;
+                e.tsc      = tsc;
+                e.owner    = owner;
+                e.count    = static_cast<std::uint32_t>(meta & 0xFFFFFFFFU);
+                e.thread   = static_cast<std::uint16_t>(index);
+                e.op       = static_cast<flight_op>((meta >> 32U) & 0xFFU);
+                e.reserved = 0;
+                d.events.push_back(e);
+            }
+        }
+        std::stable_sort(d.events.begin(), d.events.end(),
+                         [](const flight_event& a, const flight_event& b) { return a.tsc < b.tsc; });
+        return d;
+    }
+
+    // TSC ticks per microsecond, measured against steady_clock since construction
+    double ticks_per_us() const noexcept
+    {
+        using std::chrono::steady_clock;
+        steady_clock::time_point now = steady_clock::now();
+        while (now - start_time_ < std::chrono::milliseconds(1))
+        {
+            now = steady_clock::now();  // Too short a baseline for a stable ratio
+        }
+        const std::uint64_t ticks = detail::read_tsc() - start_tsc_;
+        const double        us    = std::chrono::duration<double, std::micro>(now - start_time_).count();
+        return static_cast<double>(ticks) / us;
+    }
+
+private:
+    static constexpr std::size_t   ring_count  = detail::max_cached_threads + 1;
+    static constexpr std::size_t   shared_ring = detail::max_cached_threads;
+    static constexpr std::uint64_t valid_bit   = std::uint64_t{1} << 63U;
+
+    // meta: count (32 bits) | op (8) | low 15 bits of position + 1 | valid
+    static std::uint64_t pack(flight_op op, std::size_t count, std::uint64_t position) noexcept
+    {
+        const std::uint64_t saturated = count > 0xFFFFFFFFU ? 0xFFFFFFFFU : count;
+        return saturated | (std::uint64_t{static_cast<std::uint8_t>(op)} << 32U) |
+               (((position + 1) & 0x7FFFU) << 48U) | valid_bit;
+    }
+
+    static bool is_record_of(std::uint64_t meta, std::uint64_t position) noexcept
+    {
+        return (meta & valid_bit) != 0 && ((meta >> 48U) & 0x7FFFU) == ((position + 1) & 0x7FFFU);
+    }
+
+    struct slot
+    {
+        std::atomic<std::uint64_t> meta{0};
+        std::atomic<std::uint64_t> tsc{0};
+        std::atomic<std::uint64_t> owner{0};
+    };
+
+    struct alignas(64) ring
+    {
+        std::atomic<std::uint64_t> head{0};
+        slot                       slots[EventsPerThread];
+    };
+
+    std::unique_ptr<ring[]>               rings_;
+    std::uint64_t                         start_tsc_;
+    std::chrono::steady_clock::time_point start_time_;
+};
+
+using flight_recorder = basic_flight_recorder<>;
+
+// The recorder ref_owner writes to under ZOOX_ENABLE_FLIGHT_RECORDER
+inline flight_recorder& global_flight_recorder()
+{
+    static flight_recorder recorder;
+    return recorder;
+}
+
+// =============================================================================
+// Binary dump format: "ZXFR", version, ticks_per_us, event count, events
+// =============================================================================
+namespace detail
+{
+constexpr char          flight_dump_magic[4] = {'Z', 'X', 'F', 'R'};
+constexpr std::uint32_t flight_dump_version  = 1;
+}  // namespace detail
+
+inline void write_flight_dump(std::ostream& out, const flight_dump& dump)
+{
+    const std::uint64_t count = dump.events.size();
+    out.write(detail::flight_dump_magic, sizeof(detail::flight_dump_magic));
+    out.write(reinterpret_cast<const char*>(&detail::flight_dump_version), sizeof(detail::flight_dump_version));
+    out.write(reinterpret_cast<const char*>(&dump.ticks_per_us), sizeof(dump.ticks_per_us));
+    out.write(reinterpret_cast<const char*>(&count), sizeof(count));
+    out.write(reinterpret_cast<const char*>(dump.events.data()),
+              static_cast<std::streamsize>(count * sizeof(flight_event)));
+}
+
+// Returns false (leaving dump unspecified) if in does not hold a valid dump
+inline bool read_flight_dump(std::istream& in, flight_dump& dump)
+{
+    char          magic[4];
+    std::uint32_t version = 0;
+    std::uint64_t count   = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&version), sizeof(version));
+    in.read(reinterpret_cast<char*>(&dump.ticks_per_us), sizeof(dump.ticks_per_us));
+    in.read(reinterpret_cast<char*>(&count), sizeof(count));
+    if (!in || std::memcmp(magic, detail::flight_dump_magic, sizeof(magic)) != 0 ||
+        version != detail::flight_dump_version || !(dump.ticks_per_us > 0.0))
+    {
+        return false;
+    }
+    dump.events.clear();
+    for (std::uint64_t i = 0; i < count; ++i)
+    {
+        flight_event e;
+        if (!in.read(reinterpret_cast<char*>(&e), sizeof(e)))
+        {
+            return false;
+        }
+        dump.events.push_back(e);
+    }
+    return true;
+}
+
+// =============================================================================
+// write_chrome_trace - Chrome trace event JSON, viewable in Perfetto
+// =============================================================================
+inline void write_chrome_trace(std::ostream& out, const flight_dump& dump)
+{
+    const std::uint64_t               origin = dump.events.empty() ? 0 : dump.events.front().tsc;
+    std::unordered_set<std::uint64_t> draining;  // Owners marked but not yet deleted
+
+    char line[256];
+    bool first = true;
+    auto emit  = [&](int length)
+    {
+        if (length <= 0)
+        {
+            return;
+        }
+        out << (first ? "\n" : ",\n");
+        out.write(line, length < static_cast<int>(sizeof(line)) ? length : static_cast<int>(sizeof(line)) - 1);
+        first = false;
+    };
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    for (const flight_event& e : dump.events)
+    {
+        const double tsc_delta = static_cast<double>(e.tsc >= origin ? e.tsc - origin : 0);
+        const double ts        = tsc_delta / dump.ticks_per_us;
+        const auto   owner     = static_cast<unsigned long long>(e.owner);
+        const auto   count     = static_cast<unsigned long>(e.count);
+
+        emit(std::snprintf(line, sizeof(line),
+                           "{\"name\":\"%s\",\"cat\":\"ref_owner\",\"ph\":\"i\",\"s\":\"t\",\"ts\":%.3f,\"pid\":1,"
+                           "\"tid\":%u,\"args\":{\"owner\":\"0x%llx\",\"count\":%lu}}",
+                           to_string(e.op), ts, static_cast<unsigned>(e.thread), owner, count));
+
+        switch (e.op)
+        {
+            case flight_op::ref_register:
+            case flight_op::ref_release:
+            {
+                const unsigned long after = e.op == flight_op::ref_register ? count + 1 : (count > 0 ? count - 1 : 0);
+                emit(std::snprintf(line, sizeof(line),
+                                   "{\"name\":\"refs 0x%llx\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"args\":{\"refs\":%lu}}",
+                                   owner, ts, after));
+                break;
+            }
+            case flight_op::mark:
+                if (draining.insert(e.owner).second)
+                {
+                    emit(std::snprintf(line, sizeof(line),
+                                       "{\"name\":\"drain\",\"cat\":\"ref_owner\",\"ph\":\"b\",\"id\":\"0x%llx\","
+                                       "\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                                       owner, ts, static_cast<unsigned>(e.thread)));
+                }
+                break;
+            case flight_op::deleted:
+                if (draining.erase(e.owner) != 0)
+                {
+                    emit(std::snprintf(line, sizeof(line),
+                                       "{\"name\":\"drain\",\"cat\":\"ref_owner\",\"ph\":\"e\",\"id\":\"0x%llx\","
+                                       "\"ts\":%.3f,\"pid\":1,\"tid\":%u}",
+                                       owner, ts, static_cast<unsigned>(e.thread)));
+                }
+                break;
+            case flight_op::wait_begin:
+            case flight_op::wait_end:
+                emit(std::snprintf(line, sizeof(line),
+                                   "{\"name\":\"wait\",\"cat\":\"ref_owner\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,"
+                                   "\"tid\":%u}",
+                                   e.op == flight_op::wait_begin ? "B" : "E", ts, static_cast<unsigned>(e.thread)));
+                break;
+            case flight_op::ref_register_failed:
+            case flight_op::delete_blocked:
+                break;
+        }
+    }
+    out << "\n]}\n";
+}
+
+}  // namespace zoox
+
+#endif  // ZOOX_FLIGHT_RECORDER_H
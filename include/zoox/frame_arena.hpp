@@ -0,0 +1,418 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Per-frame bump arena with bulk reclamation of frame-scoped owners
+ */
+#ifndef ZOOX_FRAME_ARENA_H
+#define ZOOX_FRAME_ARENA_H
+
+// =============================================================================
+// zoox::frame_arena - Allocate in phases 1-4, reclaim everything in phase 5
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// docs/ref_owner_concept.md describes a fixed-period frame in which messages
+// are created and borrowed during phases 1-4 and must all be reclaimed in
+// phase 5. frame_arena bump-allocates each object together with its owner
+// (a frame_owner) from one preallocated buffer, so creating a message is a
+// pointer bump and there is no per-object free.
+//
+// The arena keeps one aggregate counter: the number of frame owners that have
+// not yet drained (marked with zero references). Each owner decrements it
+// exactly once, either when reclaim() marks an owner that has no references
+// or when the last reference to a marked owner is released. reclaim() marks
+// every owner, checks that single counter, and when it is zero runs the
+// destructors and resets the buffer in O(1).
+//
+// If some owner still has references, reclaim() destroys the objects that
+// did drain and reports the rest. Those are carried over: the buffer is not
+// reset, allocation continues above them, and the next reclaim() tries
+// again.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::frame_arena<> arena(1 << 20);   // One allocation, up front
+//
+//   // Phases 1-4 (any thread)
+//   auto* msg = arena.make<Message>(args...);
+//   consumer.process(msg->make_ref());
+//
+//   // Phase 5 (one thread, no concurrent make())
+//   auto result = arena.reclaim();
+//   if (!result.reclaimed) {
+//       arena.for_each_outstanding([](const void* object, size_t refs) { log(object, refs); });
+//   }
+//
+// The buffer comes from MemorySource (zoox/memory_source.hpp); use
+// pinned_memory_source to keep frame storage on locked, NUMA-local huge pages.
+//
+// weak_observer must not be used with frame owners: reclaim() reuses their
+// storage for objects of other types.
+//
+// =============================================================================
+
+#include "zoox/memory_source.hpp"
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+
+namespace zoox
+{
+
+template <template <typename> class OptionalT = std::optional, typename MemorySource = new_delete_memory_source>
+class frame_arena;
+
+namespace detail
+{
+
+// Type-erased view of a frame_owner used by frame_arena
+class frame_entry
+{
+public:
+    frame_entry()                              = default;
+    frame_entry(const frame_entry&)            = delete;
+    frame_entry& operator=(const frame_entry&) = delete;
+
+    virtual void        entry_mark() noexcept            = 0;
+    virtual bool        entry_delete() noexcept          = 0;
+    virtual bool        entry_drained() const noexcept   = 0;
+    virtual std::size_t entry_ref_count() const noexcept = 0;
+    virtual const void* entry_object() const noexcept    = 0;
+    // Follows ref_owner's destructor policy if references are outstanding
+    virtual void entry_destroy() = 0;
+
+    frame_entry* next_in_frame = nullptr;
+
+protected:
+    ~frame_entry() = default;
+};
+
+}  // namespace detail
+
+struct frame_reclaim_result
+{
+    // True if every owner drained and the arena was reset
+    bool reclaimed;
+    // Owners carried over because they still have references
+    std::size_t outstanding_owners;
+    // Objects destroyed by this call (earlier carry-overs are not recounted)
+    std::size_t deleted_owners;
+};
+
+// =============================================================================
+// frame_owner - ref_owner that reports its drain to the frame_arena
+// =============================================================================
+template <typename T, template <typename> class OptionalT = std::optional>
+class frame_owner final
+    : public ref_owner<T, OptionalT, destruct_only<T>>
+    , public detail::frame_entry
+{
+public:
+    using base      = ref_owner<T, OptionalT, destruct_only<T>>;
+    using reference = unique_reference<T, T, OptionalT, destruct_only<T>>;
+
+    template <typename... Args>
+    explicit frame_owner(std::atomic<std::size_t>& pending, Args&&... args)
+        : base(nullptr)
+        , pending_(&pending)
+    {
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            base::owned_ptr_.reset(new (storage_) T(std::forward<Args>(args)...));
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            // Leave the owner deleted so its destructor accepts it
+            base::mark_and_delete_if_ready();
+            throw;
+        }
+#endif
+    }
+
+    ~frame_owner() = default;
+
+    frame_owner(const frame_owner&)            = delete;
+    frame_owner& operator=(const frame_owner&) = delete;
+
+protected:
+    void on_ref_released() noexcept override
+    {
+        const size_t prev = base::ref_count_.fetch_sub(1, std::memory_order_seq_cst);
+        base::trace_ref_released(prev);
+        if (prev == 1 && base::marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            signal_drained();
+        }
+    }
+
+    void on_exclusive_ref_released() noexcept override
+    {
+        const size_t prev = base::ref_count_.fetch_sub(base::exclusive_ref_flag, std::memory_order_seq_cst);
+        base::trace_ref_released(prev);
+        if (prev == base::exclusive_ref_flag && base::marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            signal_drained();
+        }
+    }
+
+    void on_registration_rolled_back(size_t amount) noexcept override
+    {
+        const size_t prev = base::ref_count_.fetch_sub(amount, std::memory_order_seq_cst);
+        if (prev == amount && base::marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            signal_drained();
+        }
+    }
+
+private:
+    // Mark first, then look at the count; a releaser decrements first, then
+    // looks at the mark. With seq_cst at least one side sees the drain, and
+    // the exchange makes sure the arena counter moves exactly once.
+    void entry_mark() noexcept override
+    {
+        base::mark_for_deletion();
+        if (base::ref_count_.load(std::memory_order_seq_cst) == 0)
+        {
+            signal_drained();
+        }
+    }
+
+    bool entry_delete() noexcept override
+    {
+        return base::delete_if_deleteable();
+    }
+
+    bool entry_drained() const noexcept override
+    {
+        return drained_.load(std::memory_order_acquire);
+    }
+
+    std::size_t entry_ref_count() const noexcept override
+    {
+        return base::ref_count();
+    }
+
+    const void* entry_object() const noexcept override
+    {
+        return storage_;
+    }
+
+    void entry_destroy() override
+    {
+        this->~frame_owner();
+    }
+
+    void signal_drained() noexcept
+    {
+        if (!drained_.exchange(true, std::memory_order_acq_rel))
+        {
+            pending_->fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    std::atomic<std::size_t>* pending_;
+    std::atomic<bool>         drained_{false};
+    alignas(T) unsigned char storage_[sizeof(T)];
+};
+
+// =============================================================================
+// frame_arena
+// =============================================================================
+template <template <typename> class OptionalT, typename MemorySource>
+class frame_arena
+{
+public:
+    // Allocates a buffer of capacity bytes from source once, up front
+    explicit frame_arena(std::size_t capacity, MemorySource source = MemorySource())
+        : source_(std::move(source))
+        , buffer_(static_cast<unsigned char*>(source_.allocate(capacity, alignment)))
+        , capacity_(capacity)
+        , owns_buffer_(true)
+    {
+        if (buffer_ == nullptr)
+        {
+            detail::throw_bad_alloc();
+        }
+    }
+
+    // Uses caller-provided storage (static buffer, hugepage mapping, ...)
+    frame_arena(void* buffer, std::size_t capacity) noexcept
+        : buffer_(static_cast<unsigned char*>(buffer))
+        , capacity_(capacity)
+        , owns_buffer_(false)
+    {
+    }
+
+    // Runs a final reclaim; owners still referenced follow ref_owner's
+    // destructor policy
+    ~frame_arena() noexcept(false)
+    {
+        reclaim();
+        for (detail::frame_entry* entry = head_.load(std::memory_order_acquire); entry != nullptr;)
+        {
+            detail::frame_entry* next = entry->next_in_frame;
+            entry->entry_destroy();
+            entry = next;
+        }
+        if (owns_buffer_)
+        {
+            source_.deallocate(buffer_, capacity_, alignment);
+        }
+    }
+
+    // Non-copyable, non-movable (owners point into the buffer)
+    frame_arena(const frame_arena&)            = delete;
+    frame_arena& operator=(const frame_arena&) = delete;
+    frame_arena(frame_arena&&)                 = delete;
+    frame_arena& operator=(frame_arena&&)      = delete;
+
+    // Bump-allocates T and its owner. Returns nullptr if the arena is full.
+    // Thread-safe with respect to other make() calls.
+    template <typename T, typename... Args>
+    frame_owner<T, OptionalT>* make(Args&&... args)
+    {
+        using owner_type = frame_owner<T, OptionalT>;
+        void* memory     = bump(sizeof(owner_type), alignof(owner_type));
+        if (memory == nullptr)
+        {
+            return nullptr;
+        }
+        pending_.fetch_add(1, std::memory_order_relaxed);
+#ifdef __cpp_exceptions
+        owner_type* owner = nullptr;
+        try
+        {
+            owner = new (memory) owner_type(pending_, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            // The bytes stay bumped until the next reset
+            pending_.fetch_sub(1, std::memory_order_relaxed);
+            throw;
+        }
+#else
+        owner_type* owner = new (memory) owner_type(pending_, std::forward<Args>(args)...);
+#endif
+        detail::frame_entry* entry = owner;
+        entry->next_in_frame       = head_.load(std::memory_order_relaxed);
+        while (!head_.compare_exchange_weak(
+            entry->next_in_frame, entry, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return owner;
+    }
+
+    // Phase 5: mark every owner, check the aggregate drain counter, and reset
+    // the arena if everything drained. Must not run concurrently with make().
+    frame_reclaim_result reclaim() noexcept
+    {
+        detail::frame_entry* head = head_.load(std::memory_order_acquire);
+        for (detail::frame_entry* entry = head; entry != nullptr; entry = entry->next_in_frame)
+        {
+            entry->entry_mark();
+        }
+
+        frame_reclaim_result result{false, 0, 0};
+        const bool           all_drained = pending_.load(std::memory_order_acquire) == 0;
+        for (detail::frame_entry* entry = head; entry != nullptr; entry = entry->next_in_frame)
+        {
+            if (!entry->entry_drained())
+            {
+                ++result.outstanding_owners;
+            }
+            else if (entry->entry_delete())
+            {
+                ++result.deleted_owners;
+            }
+        }
+
+        if (all_drained)
+        {
+            for (detail::frame_entry* entry = head; entry != nullptr;)
+            {
+                detail::frame_entry* next = entry->next_in_frame;
+                entry->entry_destroy();
+                entry = next;
+            }
+            head_.store(nullptr, std::memory_order_relaxed);
+            offset_.store(0, std::memory_order_release);
+            result.reclaimed = true;
+        }
+        return result;
+    }
+
+    // Visits owners that still have references: f(const void* object, size_t ref_count)
+    template <typename F>
+    void for_each_outstanding(F&& f) const
+    {
+        for (detail::frame_entry* entry = head_.load(std::memory_order_acquire); entry != nullptr;
+             entry                      = entry->next_in_frame)
+        {
+            if (!entry->entry_drained())
+            {
+                f(entry->entry_object(), entry->entry_ref_count());
+            }
+        }
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    std::size_t bytes_in_use() const noexcept
+    {
+        return offset_.load(std::memory_order_acquire);
+    }
+
+    // Owners allocated since the last reset that have not drained yet
+    std::size_t pending_owners() const noexcept
+    {
+        return pending_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t alignment = 64;
+
+    void* bump(std::size_t size, std::size_t align) noexcept
+    {
+        std::size_t offset = offset_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            const std::uintptr_t base    = reinterpret_cast<std::uintptr_t>(buffer_);  // NOLINT: alignment math
+            const std::uintptr_t aligned = (base + offset + align - 1) & ~(std::uintptr_t{align} - 1);
+            const std::size_t    start   = static_cast<std::size_t>(aligned - base);
+            if (start + size > capacity_)
+            {
+                return nullptr;
+            }
+            if (offset_.compare_exchange_weak(offset, start + size, std::memory_order_relaxed))
+            {
+                return buffer_ + start;
+            }
+        }
+    }
+
+    MemorySource                      source_;
+    unsigned char*                    buffer_;
+    std::size_t                       capacity_;
+    bool                              owns_buffer_;
+    std::atomic<std::size_t>          offset_{0};
+    std::atomic<std::size_t>          pending_{0};
+    std::atomic<detail::frame_entry*> head_{nullptr};
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_FRAME_ARENA_H
@@ -0,0 +1,382 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Fixed-period frame executor with budgeted phases and a reclaim phase
+ */
+#ifndef ZOOX_FRAME_EXECUTOR_H
+#define ZOOX_FRAME_EXECUTOR_H
+
+// =============================================================================
+// zoox::frame_executor - The frame from docs/ref_owner_concept.md, enforced
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// docs/ref_owner_concept.md describes a fixed-period frame: phases 1-4 load,
+// process and transmit messages and do optional work, phase 5 reclaims
+// memory, and phase 6 is a guard band of slack that must never reach zero.
+// frame_executor runs that frame:
+//
+//   - add_phase() registers the work phases in order, each with a budget.
+//   - The reclaim phase always runs last. It is the only place where the
+//     executor deletes: it calls mark_and_delete_if_ready() on every owner
+//     registered with track(), and runs the reclaimers registered with
+//     add_reclaimer() (e.g. frame_arena::reclaim, topic_bus::reclaim).
+//   - What is left of the period is the guard band.
+//
+// Every phase is timed against its budget. The executor reports, through the
+// handler given to on_violation():
+//
+//   phase_overrun         - a phase (reclaim included) exceeded its budget
+//   reference_past_phase  - a tracked owner still had references after the
+//                           phase by which they had to be released
+//   reclaim_outstanding   - a reclaimer reported objects still borrowed
+//   guard_band_overrun    - the frame left less slack than the guard band
+//
+// Owners that could not be deleted stay tracked and are retried (and
+// reported again) in the next reclaim phase.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::frame_executor<> frame({std::chrono::milliseconds(10), std::chrono::milliseconds(1),
+//                                 std::chrono::microseconds(500)});
+//   const auto process = frame.add_phase("process", std::chrono::milliseconds(4), [&](std::uint64_t) {
+//       frame.track(reading, process);     // References must be gone when "process" ends
+//       run_pipeline(reading.make_ref());
+//   });
+//   frame.add_reclaimer([&] { return arena.reclaim().outstanding_owners; });
+//   frame.on_violation([](const zoox::frame_violation& v) { log(v); });
+//
+//   frame.run(stop_flag);                  // Or run_frame() from an existing loop
+//
+// The executor is single-threaded: phases, track() and the handler run on
+// the thread calling run() / run_frame(). Registration allocates; running a
+// frame does not, except when track() grows its list.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace zoox
+{
+
+struct frame_executor_options
+{
+    // Length of one frame
+    std::chrono::nanoseconds period;
+    // Budget of the reclaim phase
+    std::chrono::nanoseconds reclaim_budget;
+    // Minimum slack left at the end of every frame
+    std::chrono::nanoseconds guard_band;
+};
+
+enum class frame_violation_kind
+{
+    phase_overrun,
+    reference_past_phase,
+    reclaim_outstanding,
+    guard_band_overrun
+};
+
+struct frame_violation
+{
+    frame_violation_kind     kind;
+    std::uint64_t            frame;
+    std::size_t              phase;       // Phase index; reclaim_phase() for the reclaim phase
+    const char*              phase_name;  // Empty for guard_band_overrun
+    std::chrono::nanoseconds elapsed;     // Phase time, or frame time for guard_band_overrun
+    std::chrono::nanoseconds budget;      // Phase budget, or period - guard band
+    const void*              object;      // The borrowed object for reference_past_phase
+    std::size_t              count;       // References, or objects still borrowed
+};
+
+struct frame_phase_stats
+{
+    std::chrono::nanoseconds budget;
+    std::chrono::nanoseconds last;
+    std::chrono::nanoseconds max;
+    std::uint64_t            overruns;
+};
+
+struct frame_report
+{
+    std::uint64_t            frame;
+    std::chrono::nanoseconds elapsed;
+    // period - elapsed; negative if the frame ran past its boundary
+    std::chrono::nanoseconds slack;
+    std::size_t              violations;
+};
+
+template <typename Clock = std::chrono::steady_clock>
+class frame_executor
+{
+public:
+    using phase_function = std::function<void(std::uint64_t frame)>;
+    using reclaimer      = std::function<std::size_t()>;
+
+    explicit frame_executor(const frame_executor_options& options)
+        : options_(options)
+    {
+        reclaim_.name   = "reclaim";
+        reclaim_.budget = options.reclaim_budget;
+    }
+
+    // Non-copyable, non-movable (phases usually capture the executor)
+    frame_executor(const frame_executor&)            = delete;
+    frame_executor& operator=(const frame_executor&) = delete;
+    frame_executor(frame_executor&&)                 = delete;
+    frame_executor& operator=(frame_executor&&)      = delete;
+
+    // Appends a work phase and returns its index. Returns reclaim_phase()
+    // (adding nothing) if the budgets, reclaim and guard band included,
+    // would no longer fit in the period.
+    std::size_t add_phase(std::string name, std::chrono::nanoseconds budget, phase_function run)
+    {
+        if (budgeted_ + budget + options_.reclaim_budget + options_.guard_band > options_.period)
+        {
+            return reclaim_phase();
+        }
+        phases_.push_back(phase{std::move(name), budget, std::move(run)});
+        budgeted_ += budget;
+        return phases_.size() - 1;
+    }
+
+    // Called in the reclaim phase; returns the number of objects it could
+    // not reclaim because they are still borrowed
+    void add_reclaimer(reclaimer reclaim)
+    {
+        reclaimers_.push_back(std::move(reclaim));
+    }
+
+    void on_violation(std::function<void(const frame_violation&)> handler)
+    {
+        handler_ = std::move(handler);
+    }
+
+    // Deletes owner (mark_and_delete_if_ready) in the next reclaim phase;
+    // if it still has references then, it is retried every frame. With
+    // release_by set to a work phase, references still held when that phase
+    // ends are reported as well. owner must outlive its deletion.
+    template <typename T, template <typename> class OptionalT, typename Deleter>
+    void track(ref_owner<T, OptionalT, Deleter>& owner, std::size_t release_by = static_cast<std::size_t>(-1))
+    {
+        using owner_type = ref_owner<T, OptionalT, Deleter>;
+        tracked_.push_back(tracked{&owner,
+                                   release_by < phases_.size() ? release_by : reclaim_phase(),
+                                   [](void* o)
+                                   {
+                                       owner_type* typed = static_cast<owner_type*>(o);
+                                       return typed->mark_and_delete_if_ready() || typed->is_deleted();
+                                   },
+                                   [](const void* o) { return static_cast<const owner_type*>(o)->ref_count(); },
+                                   [](const void* o) -> const void*
+                                   { return static_cast<const owner_type*>(o)->get(); }});
+    }
+
+    // Runs one frame: the work phases, the reclaim phase, and the guard band
+    // check. Does not wait for the end of the period.
+    frame_report run_frame()
+    {
+        const std::uint64_t            frame      = frame_++;
+        const std::size_t              violations = violations_;
+        const typename Clock::time_point start    = Clock::now();
+
+        for (std::size_t i = 0; i < phases_.size(); ++i)
+        {
+            const typename Clock::time_point phase_start = Clock::now();
+            phases_[i].run(frame);
+            finish_phase(frame, i, phases_[i], Clock::now() - phase_start);
+            check_references(frame, i);
+        }
+
+        const typename Clock::time_point reclaim_start = Clock::now();
+        std::size_t                      outstanding   = 0;
+        for (reclaimer& reclaim : reclaimers_)
+        {
+            outstanding += reclaim();
+        }
+        reclaim_tracked(frame);
+        finish_phase(frame, reclaim_phase(), reclaim_, Clock::now() - reclaim_start);
+        if (outstanding != 0)
+        {
+            report(frame_violation{frame_violation_kind::reclaim_outstanding, frame, reclaim_phase(),
+                                   reclaim_.name.c_str(), reclaim_.last, reclaim_.budget, nullptr, outstanding});
+        }
+
+        const std::chrono::nanoseconds elapsed = Clock::now() - start;
+        const std::chrono::nanoseconds slack   = options_.period - elapsed;
+        if (slack < options_.guard_band)
+        {
+            report(frame_violation{frame_violation_kind::guard_band_overrun, frame, reclaim_phase() + 1, "", elapsed,
+                                   options_.period - options_.guard_band, nullptr, 0});
+        }
+        return frame_report{frame, elapsed, slack, violations_ - violations};
+    }
+
+    // Runs frames on a fixed schedule until stop is set; returns the number
+    // of frames run. A frame that runs past its boundary restarts the
+    // schedule from its end instead of running the missed frames back to back.
+    std::uint64_t run(const std::atomic<bool>& stop)
+    {
+        std::uint64_t              frames = 0;
+        typename Clock::time_point next   = Clock::now();
+        while (!stop.load(std::memory_order_acquire))
+        {
+            run_frame();
+            ++frames;
+            next += std::chrono::duration_cast<typename Clock::duration>(options_.period);
+            const typename Clock::time_point now = Clock::now();
+            if (now < next)
+            {
+                std::this_thread::sleep_until(next);
+            }
+            else
+            {
+                next = now;
+            }
+        }
+        return frames;
+    }
+
+    // Index used for the reclaim phase in violations and phase_stats()
+    std::size_t reclaim_phase() const noexcept
+    {
+        return phases_.size();
+    }
+
+    // Timing of a work phase, or of the reclaim phase
+    frame_phase_stats phase_stats(std::size_t index) const noexcept
+    {
+        const phase& p = index < phases_.size() ? phases_[index] : reclaim_;
+        return frame_phase_stats{p.budget, p.last, p.max, p.overruns};
+    }
+
+    // Owners waiting for their reclaim phase, or still borrowed
+    std::size_t tracked_count() const noexcept
+    {
+        return tracked_.size();
+    }
+
+    std::uint64_t frame_count() const noexcept
+    {
+        return frame_;
+    }
+
+    // Total violations reported so far
+    std::size_t violation_count() const noexcept
+    {
+        return violations_;
+    }
+
+    const frame_executor_options& options() const noexcept
+    {
+        return options_;
+    }
+
+private:
+    struct phase
+    {
+        std::string              name;
+        std::chrono::nanoseconds budget{0};
+        phase_function           run;
+        std::chrono::nanoseconds last{0};
+        std::chrono::nanoseconds max{0};
+        std::uint64_t            overruns = 0;
+    };
+
+    // Type-erased ref_owner
+    struct tracked
+    {
+        void*       owner;
+        std::size_t release_by;
+        bool (*mark_and_delete)(void*);
+        std::size_t (*ref_count)(const void*);
+        const void* (*object)(const void*);
+    };
+
+    void finish_phase(std::uint64_t frame, std::size_t index, phase& p, std::chrono::nanoseconds elapsed)
+    {
+        p.last = elapsed;
+        p.max  = elapsed > p.max ? elapsed : p.max;
+        if (elapsed > p.budget)
+        {
+            ++p.overruns;
+            report(frame_violation{frame_violation_kind::phase_overrun, frame, index, p.name.c_str(), elapsed,
+                                   p.budget, nullptr, 0});
+        }
+    }
+
+    // Owners due after phase index that are still borrowed
+    void check_references(std::uint64_t frame, std::size_t index)
+    {
+        for (const tracked& t : tracked_)
+        {
+            if (t.release_by == index)
+            {
+                report_borrowed(frame, index, t);
+            }
+        }
+    }
+
+    void reclaim_tracked(std::uint64_t frame)
+    {
+        std::size_t kept = 0;
+        for (tracked& t : tracked_)
+        {
+            if (!t.mark_and_delete(t.owner))
+            {
+                report_borrowed(frame, reclaim_phase(), t);
+                t.release_by     = reclaim_phase();
+                tracked_[kept++] = t;
+            }
+        }
+        tracked_.resize(kept);
+    }
+
+    void report_borrowed(std::uint64_t frame, std::size_t index, const tracked& t)
+    {
+        const std::size_t refs = t.ref_count(t.owner);
+        if (refs != 0)
+        {
+            const phase& p = index < phases_.size() ? phases_[index] : reclaim_;
+            report(frame_violation{frame_violation_kind::reference_past_phase, frame, index, p.name.c_str(), p.last,
+                                   p.budget, t.object(t.owner), refs});
+        }
+    }
+
+    void report(const frame_violation& violation)
+    {
+        ++violations_;
+        if (handler_)
+        {
+            handler_(violation);
+        }
+    }
+
+    frame_executor_options                       options_;
+    std::vector<phase>                           phases_;
+    phase                                        reclaim_;
+    std::chrono::nanoseconds                     budgeted_{0};
+    std::vector<reclaimer>                       reclaimers_;
+    std::vector<tracked>                         tracked_;
+    std::function<void(const frame_violation&)> handler_;
+    std::uint64_t                                frame_      = 0;
+    std::size_t                                  violations_ = 0;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_FRAME_EXECUTOR_H
@@ -0,0 +1,298 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Diagnostic records of who holds a ref_owner's outstanding references
+ */
+#ifndef ZOOX_HOLDER_TRACKING_H
+#define ZOOX_HOLDER_TRACKING_H
+
+// =============================================================================
+// Holder tracking - Which call sites are keeping an owner from draining
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// When mark_and_delete_if_ready() returns false, ref_count() says how many
+// references are outstanding but not who holds them. Define
+// ZOOX_TRACK_HOLDERS for the whole program (like ZOOX_ENABLE_FLIGHT_RECORDER
+// it changes ref_owner and unique_reference, so every translation unit must
+// agree) and each unique_reference records a holder:
+//
+//   - the call site of try_make_ref()/make_ref()/try_make_refs()
+//     (std::source_location in C++20, __builtin_FILE/__builtin_LINE before)
+//   - the creating thread's id
+//   - the TSC at creation
+//
+//   if (!frame.mark_and_delete_if_ready()) {
+//       frame.dump_holders(std::cerr);
+//   }
+//
+//   ref_owner 0x7f3a...: 2 references outstanding, 0 untracked
+//     planner.cpp:118 in void plan(const Frame&), thread 4121, held 1843021 ticks
+//     logger.cpp:57 in void Logger::enqueue(...), thread 4123, held 22034 ticks
+//
+// COST
+// ----
+// Records live in a per-owner array of ZOOX_HOLDER_SLOTS (default 64)
+// slots, allocated on the owner's first borrow. A borrow claims a free slot
+// with one CAS, probing at most holder_probe_limit slots from a per-thread
+// cursor, then writes the record with plain stores; a release is one store.
+// The per-borrow overhead is therefore bounded regardless of how many
+// references are outstanding. A borrow that finds no free slot within the
+// probe limit is not recorded and shows up as "untracked" in the dump, as do
+// references that entered an atomic_reference.
+//
+// References created inside the library (pools, maps, weak_observer
+// upgrades) record the library's call site.
+//
+// =============================================================================
+
+#include "zoox/tsc.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <ostream>
+#include <thread>
+#include <vector>
+
+#if defined(__has_include)
+#    if __has_include(<version>)
+#        include <version>
+#    endif
+#endif
+#ifdef __cpp_lib_source_location
+#    include <source_location>
+#endif
+
+#ifdef __linux__
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+#ifndef ZOOX_HOLDER_SLOTS
+#    define ZOOX_HOLDER_SLOTS 64
+#endif
+
+namespace zoox
+{
+
+// Where a reference was created
+struct holder_site
+{
+    const char*   file;
+    const char*   function;
+    std::uint32_t line;
+
+#ifdef __cpp_lib_source_location
+    static constexpr holder_site current(std::source_location location = std::source_location::current()) noexcept
+    {
+        return holder_site{location.file_name(), location.function_name(), location.line()};
+    }
+#else
+    static constexpr holder_site current(const char*   file     = __builtin_FILE(),
+                                         const char*   function = __builtin_FUNCTION(),
+                                         std::uint32_t line     = __builtin_LINE()) noexcept
+    {
+        return holder_site{file, function, line};
+    }
+#endif
+};
+
+// One outstanding reference, as returned by ref_owner::holders()
+struct holder_info
+{
+    holder_site   site;
+    std::uint64_t thread;  // OS thread id on Linux, hashed std::thread::id elsewhere
+    std::uint64_t tsc;     // detail::read_tsc() at creation
+};
+
+namespace detail
+{
+
+constexpr std::uint32_t no_holder          = 0xFFFFFFFFU;
+constexpr std::size_t   holder_slots       = ZOOX_HOLDER_SLOTS;
+constexpr std::size_t   holder_probe_limit = holder_slots < 8 ? holder_slots : 8;
+
+static_assert(holder_slots > 0 && holder_slots < no_holder, "ZOOX_HOLDER_SLOTS out of range");
+
+inline std::uint64_t current_thread_id() noexcept
+{
+#ifdef __linux__
+    thread_local const std::uint64_t id = static_cast<std::uint64_t>(::syscall(SYS_gettid));
+#else
+    thread_local const std::uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+#endif
+    return id;
+}
+
+// Where this thread starts probing for a free slot; spreads threads apart
+inline std::uint32_t& holder_cursor() noexcept
+{
+    thread_local std::uint32_t cursor = static_cast<std::uint32_t>(current_thread_id() * 0x9E3779B9U);
+    return cursor;
+}
+
+// Lock-free array of holder records. A record's state word is 0 while free,
+// 1 while being claimed, and (tsc << 1) | 1 once published; readers check
+// that it is unchanged around their copy of the fields.
+class holder_list
+{
+public:
+    holder_list() noexcept = default;
+
+    ~holder_list()
+    {
+        delete[] slots_.load(std::memory_order_acquire);
+    }
+
+    holder_list(const holder_list&)            = delete;
+    holder_list& operator=(const holder_list&) = delete;
+
+    // Owners are moved only while no references exist
+    holder_list(holder_list&& other) noexcept
+        : slots_(other.slots_.exchange(nullptr, std::memory_order_acq_rel))
+    {
+    }
+
+    holder_list& operator=(holder_list&& other) noexcept
+    {
+        if (this != &other)
+        {
+            delete[] slots_.exchange(other.slots_.exchange(nullptr, std::memory_order_acq_rel),
+                                     std::memory_order_acq_rel);
+        }
+        return *this;
+    }
+
+    // Returns the claimed slot, or no_holder if none was free within the probe limit
+    std::uint32_t claim(const holder_site& site) noexcept
+    {
+        record* slots = ensure_slots();
+        if (slots == nullptr)
+        {
+            return no_holder;
+        }
+        std::uint32_t& cursor = holder_cursor();
+        for (std::size_t i = 0; i < holder_probe_limit; ++i)
+        {
+            const auto    index    = static_cast<std::uint32_t>((cursor + i) % holder_slots);
+            record&       r        = slots[index];
+            std::uint64_t expected = 0;
+            if (r.state.load(std::memory_order_relaxed) != 0 ||
+                !r.state.compare_exchange_strong(expected, claiming, std::memory_order_acquire))
+            {
+                continue;
+            }
+            const std::uint64_t tsc = read_tsc();
+            r.file.store(site.file, std::memory_order_release);
+            r.function.store(site.function, std::memory_order_release);
+            r.line.store(site.line, std::memory_order_release);
+            r.thread.store(current_thread_id(), std::memory_order_release);
+            r.state.store((tsc << 1U) | 1U, std::memory_order_release);
+            cursor = index + 1;
+            return index;
+        }
+        return no_holder;
+    }
+
+    void release(std::uint32_t index) noexcept
+    {
+        if (index != no_holder)
+        {
+            slots_.load(std::memory_order_acquire)[index].state.store(0, std::memory_order_release);
+        }
+    }
+
+    // Published records; concurrent claims and releases may or may not be included
+    std::vector<holder_info> snapshot() const
+    {
+        std::vector<holder_info> holders;
+        const record*            slots = slots_.load(std::memory_order_acquire);
+        if (slots == nullptr)
+        {
+            return holders;
+        }
+        for (std::size_t i = 0; i < holder_slots; ++i)
+        {
+            const record&       r     = slots[i];
+            const std::uint64_t state = r.state.load(std::memory_order_acquire);
+            if ((state & 1U) == 0 || state == claiming)
+            {
+                continue;
+            }
+            holder_info info;
+            info.site.file     = r.file.load(std::memory_order_acquire);
+            info.site.function = r.function.load(std::memory_order_acquire);
+            info.site.line     = r.line.load(std::memory_order_acquire);
+            info.thread        = r.thread.load(std::memory_order_acquire);
+            info.tsc           = state >> 1U;
+            if (r.state.load(std::memory_order_relaxed) == state)
+            {
+                holders.push_back(info);
+            }
+        }
+        return holders;
+    }
+
+private:
+    static constexpr std::uint64_t claiming = 1;
+
+    struct record
+    {
+        std::atomic<std::uint64_t> state{0};
+        std::atomic<const char*>   file{nullptr};
+        std::atomic<const char*>   function{nullptr};
+        std::atomic<std::uint32_t> line{0};
+        std::atomic<std::uint64_t> thread{0};
+    };
+
+    // Allocated on first use; a losing racer frees its copy
+    record* ensure_slots() noexcept
+    {
+        record* slots = slots_.load(std::memory_order_acquire);
+        if (slots != nullptr)
+        {
+            return slots;
+        }
+        record* fresh = new (std::nothrow) record[holder_slots];
+        if (fresh == nullptr)
+        {
+            return nullptr;
+        }
+        if (slots_.compare_exchange_strong(slots, fresh, std::memory_order_acq_rel))
+        {
+            return fresh;
+        }
+        delete[] fresh;
+        return slots;
+    }
+
+    std::atomic<record*> slots_{nullptr};
+};
+
+// Writes the header line and one line per holder
+inline void write_holders(std::ostream&                   out,
+                          const void*                     owner,
+                          std::size_t                     ref_count,
+                          const std::vector<holder_info>& holders)
+{
+    const std::uint64_t now       = read_tsc();
+    const std::size_t   untracked = ref_count > holders.size() ? ref_count - holders.size() : 0;
+    out << "ref_owner " << owner << ": " << ref_count << " references outstanding, " << untracked << " untracked\n";
+    for (const holder_info& h : holders)
+    {
+        out << "  " << (h.site.file != nullptr ? h.site.file : "?") << ':' << h.site.line << " in "
+            << (h.site.function != nullptr ? h.site.function : "?") << ", thread " << h.thread << ", held "
+            << (now >= h.tsc ? now - h.tsc : 0) << " ticks\n";
+    }
+}
+
+}  // namespace detail
+}  // namespace zoox
+
+#endif  // ZOOX_HOLDER_TRACKING_H
@@ -0,0 +1,657 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief io_uring submissions that hold unique_references until completion
+ */
+#ifndef ZOOX_IO_URING_QUEUE_H
+#define ZOOX_IO_URING_QUEUE_H
+
+// =============================================================================
+// zoox::io_uring_queue / zoox::io_uring_fixed_buffers - Async I/O lifetimes
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// An asynchronous write reads its buffer after the submitting call has
+// returned, until the completion arrives. The buffer's owner must not delete
+// it in between. Here the submission carries the proof:
+//
+//   - write() / read() take a unique_reference (or any move-only reference
+//     type) to the object that contains the buffer and keep it in the
+//     request until the completion is reaped. The owner's reclaim phase
+//     cannot delete the buffer while the kernel may still touch it.
+//   - io_uring_fixed_buffers registers a set of buffers with the ring
+//     (IORING_REGISTER_BUFFERS) and owns them through a ref_owner.
+//     write_fixed() / read_fixed() hold a reference to the set, so
+//     unregister() - the set's mark_and_delete_if_ready() - only
+//     unregisters and frees the buffers once every fixed I/O has completed.
+//
+// The ring is driven through the raw system calls (<linux/io_uring.h>);
+// liburing is not required.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::io_uring_queue<> ring(64);
+//
+//   auto frame = dump_owner.make_ref();             // Buffer lives in the owner
+//   ring.write(log_fd, std::move(frame), frame_bytes, frame_size, file_offset);
+//   ring.submit();
+//
+//   // Later, on the same thread
+//   ring.reap([](const zoox::io_uring_completion& c) { check(c.result); });
+//   // Each reaped request released its reference; the owner can now be
+//   // deleted in its reclaim phase.
+//
+// An io_uring_queue is used from one thread: submit and reap on the thread
+// that owns it. Destroying it waits for the requests still in flight, since
+// their buffers are in use until then. Fixed buffers are unregistered before
+// their queue is destroyed.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace zoox
+{
+
+struct io_uring_completion
+{
+    std::uint64_t tag;     // Value passed at submission
+    std::int32_t  result;  // Bytes transferred, or -errno
+};
+
+namespace detail
+{
+
+// Owns the ring fd and its three shared mappings
+class io_ring
+{
+public:
+    explicit io_ring(unsigned entries) noexcept
+    {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const long fd = syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+        {
+            error_ = errno;
+            return;
+        }
+        fd_ = static_cast<int>(fd);
+
+        sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        single_mmap_  = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (single_mmap_)
+        {
+            sq_ring_size_ = cq_ring_size_ = sq_ring_size_ > cq_ring_size_ ? sq_ring_size_ : cq_ring_size_;
+        }
+        sq_ring_ = map(sq_ring_size_, IORING_OFF_SQ_RING);
+        cq_ring_ = single_mmap_ ? sq_ring_ : map(cq_ring_size_, IORING_OFF_CQ_RING);
+        sqes_    = static_cast<io_uring_sqe*>(map(params.sq_entries * sizeof(io_uring_sqe), IORING_OFF_SQES));
+        if (sq_ring_ == nullptr || cq_ring_ == nullptr || sqes_ == nullptr)
+        {
+            error_ = errno;
+            release();
+            return;
+        }
+        sq_entries_ = params.sq_entries;
+        cq_entries_ = params.cq_entries;
+
+        auto* sq  = static_cast<unsigned char*>(sq_ring_);
+        auto* cq  = static_cast<unsigned char*>(cq_ring_);
+        sq_head_  = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_  = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_  = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cq_head_  = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_  = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_  = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_     = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+    }
+
+    ~io_ring()
+    {
+        release();
+    }
+
+    io_ring(const io_ring&)            = delete;
+    io_ring& operator=(const io_ring&) = delete;
+
+    int fd() const noexcept
+    {
+        return fd_;
+    }
+
+    int error() const noexcept
+    {
+        return error_;
+    }
+
+    unsigned cq_entries() const noexcept
+    {
+        return cq_entries_;
+    }
+
+    // Next free submission entry (zeroed), or nullptr if the queue is full.
+    // It is queued by commit_sqe().
+    io_uring_sqe* next_sqe() noexcept
+    {
+        const unsigned head = __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        if (local_tail_ - head >= sq_entries_)
+        {
+            return nullptr;
+        }
+        io_uring_sqe* sqe = &sqes_[local_tail_ & sq_mask_];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    void commit_sqe() noexcept
+    {
+        sq_array_[local_tail_ & sq_mask_] = local_tail_ & sq_mask_;
+        ++local_tail_;
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        ++unsubmitted_;
+    }
+
+    // Submits queued entries and waits for wait_for completions. Returns
+    // the number submitted or -errno.
+    int enter(unsigned wait_for) noexcept
+    {
+        const unsigned flags  = wait_for != 0 ? IORING_ENTER_GETEVENTS : 0U;
+        long           result = 0;
+        do
+        {
+            result = syscall(__NR_io_uring_enter, fd_, unsubmitted_, wait_for, flags, nullptr, 0);
+        } while (result < 0 && errno == EINTR);
+        if (result < 0)
+        {
+            return -errno;
+        }
+        unsubmitted_ -= static_cast<unsigned>(result);
+        return static_cast<int>(result);
+    }
+
+    // Calls f(const io_uring_cqe&) for each available completion
+    template <typename F>
+    std::size_t for_each_cqe(F&& f)
+    {
+        unsigned       head = *cq_head_;
+        const unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        std::size_t    seen = 0;
+        for (; head != tail; ++head, ++seen)
+        {
+            // Consumed before f runs, so a throwing f cannot see it twice
+            const io_uring_cqe cqe = cqes_[head & cq_mask_];
+            __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+            f(cqe);
+        }
+        return seen;
+    }
+
+    int register_op(unsigned opcode, const void* arg, unsigned count) noexcept
+    {
+        const long result = syscall(__NR_io_uring_register, fd_, opcode, arg, count);
+        return result < 0 ? -errno : 0;
+    }
+
+private:
+    void* map(std::size_t size, std::uint64_t offset) noexcept
+    {
+        void* memory =
+            mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, static_cast<off_t>(offset));
+        return memory == MAP_FAILED ? nullptr : memory;
+    }
+
+    void release() noexcept
+    {
+        if (sqes_ != nullptr)
+        {
+            munmap(sqes_, sq_entries_ * sizeof(io_uring_sqe));
+        }
+        if (cq_ring_ != nullptr && cq_ring_ != sq_ring_)
+        {
+            munmap(cq_ring_, cq_ring_size_);
+        }
+        if (sq_ring_ != nullptr)
+        {
+            munmap(sq_ring_, sq_ring_size_);
+        }
+        if (fd_ >= 0)
+        {
+            close(fd_);
+        }
+        sqes_    = nullptr;
+        cq_ring_ = nullptr;
+        sq_ring_ = nullptr;
+        fd_      = -1;
+    }
+
+    int           fd_           = -1;
+    int           error_        = 0;
+    bool          single_mmap_  = false;
+    void*         sq_ring_      = nullptr;
+    void*         cq_ring_      = nullptr;
+    std::size_t   sq_ring_size_ = 0;
+    std::size_t   cq_ring_size_ = 0;
+    io_uring_sqe* sqes_         = nullptr;
+    io_uring_cqe* cqes_         = nullptr;
+    unsigned*     sq_head_      = nullptr;
+    unsigned*     sq_tail_      = nullptr;
+    unsigned*     sq_array_     = nullptr;
+    unsigned*     cq_head_      = nullptr;
+    unsigned*     cq_tail_      = nullptr;
+    unsigned      sq_mask_      = 0;
+    unsigned      cq_mask_      = 0;
+    unsigned      sq_entries_   = 0;
+    unsigned      cq_entries_   = 0;
+    unsigned      local_tail_   = 0;
+    unsigned      unsubmitted_  = 0;
+};
+
+// A reference of any type, held by a request until its completion
+class held_reference
+{
+public:
+    static constexpr std::size_t capacity = 4 * sizeof(void*);
+
+    held_reference() noexcept = default;
+
+    ~held_reference()
+    {
+        release();
+    }
+
+    held_reference(const held_reference&)            = delete;
+    held_reference& operator=(const held_reference&) = delete;
+
+    template <typename Reference>
+    void hold(Reference&& ref) noexcept
+    {
+        using stored = typename std::decay<Reference>::type;
+        static_assert(sizeof(stored) <= capacity && alignof(stored) <= alignof(std::max_align_t),
+                      "reference type too large to hold in a request");
+        static_assert(std::is_nothrow_move_constructible<stored>::value, "references move without throwing");
+        ::new (static_cast<void*>(storage_)) stored(std::move(ref));
+        destroy_ = [](void* p) noexcept { static_cast<stored*>(p)->~stored(); };
+    }
+
+    // Releases the reference
+    void release() noexcept
+    {
+        if (destroy_ != nullptr)
+        {
+            destroy_(storage_);
+            destroy_ = nullptr;
+        }
+    }
+
+private:
+    alignas(std::max_align_t) unsigned char storage_[capacity];
+    void (*destroy_)(void*) noexcept = nullptr;
+};
+
+// Buffers registered with a ring; destroying them unregisters and frees
+class registered_buffers
+{
+public:
+    registered_buffers(io_ring& ring, std::size_t count, std::size_t buffer_size) noexcept
+        : ring_(&ring)
+    {
+        const std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        stride_                = (buffer_size + page - 1) / page * page;
+        if (count == 0 || buffer_size == 0 || ring.fd() < 0)
+        {
+            return;
+        }
+        void* memory = mmap(nullptr, stride_ * count, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            return;
+        }
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            iovecs_.resize(count);
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            munmap(memory, stride_ * count);
+            return;
+        }
+#endif
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            iovecs_[i].iov_base = static_cast<unsigned char*>(memory) + i * stride_;
+            iovecs_[i].iov_len  = buffer_size;
+        }
+        if (ring.register_op(IORING_REGISTER_BUFFERS, iovecs_.data(), static_cast<unsigned>(count)) != 0)
+        {
+            munmap(memory, stride_ * count);
+            iovecs_.clear();
+            return;
+        }
+        memory_ = memory;
+    }
+
+    ~registered_buffers()
+    {
+        if (memory_ != nullptr)
+        {
+            ring_->register_op(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+            munmap(memory_, stride_ * iovecs_.size());
+        }
+    }
+
+    registered_buffers(const registered_buffers&)            = delete;
+    registered_buffers& operator=(const registered_buffers&) = delete;
+
+    bool registered() const noexcept
+    {
+        return memory_ != nullptr;
+    }
+
+    std::size_t count() const noexcept
+    {
+        return iovecs_.size();
+    }
+
+    unsigned char* buffer(std::size_t index) const noexcept
+    {
+        return static_cast<unsigned char*>(iovecs_[index].iov_base);
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return iovecs_.empty() ? 0 : iovecs_.front().iov_len;
+    }
+
+private:
+    io_ring*           ring_;
+    void*              memory_ = nullptr;
+    std::size_t        stride_ = 0;
+    std::vector<iovec> iovecs_;
+};
+
+}  // namespace detail
+
+template <template <typename> class OptionalT>
+class io_uring_fixed_buffers;
+
+// =============================================================================
+// io_uring_queue - Submission/completion ring whose requests hold references
+// =============================================================================
+template <template <typename> class OptionalT = std::optional>
+class io_uring_queue
+{
+public:
+    // Check operator bool (or error()) for failure, e.g. where io_uring is
+    // disabled by seccomp or sysctl
+    explicit io_uring_queue(unsigned entries = 64)
+        : ring_(entries)
+    {
+        if (ring_.fd() >= 0)
+        {
+            requests_ = std::vector<request>(ring_.cq_entries());
+            free_.reserve(requests_.size());
+            for (std::size_t i = requests_.size(); i > 0; --i)
+            {
+                free_.push_back(static_cast<std::uint32_t>(i - 1));
+            }
+        }
+    }
+
+    // Waits for the requests still in flight: their buffers are in use
+    ~io_uring_queue()
+    {
+        while (in_flight() != 0)
+        {
+            if (ring_.enter(1) < 0)
+            {
+                break;
+            }
+            reap([](const io_uring_completion&) {});
+        }
+    }
+
+    io_uring_queue(const io_uring_queue&)            = delete;
+    io_uring_queue& operator=(const io_uring_queue&) = delete;
+
+    explicit operator bool() const noexcept
+    {
+        return ring_.fd() >= 0;
+    }
+
+    // errno from ring setup, 0 on success
+    int error() const noexcept
+    {
+        return ring_.error();
+    }
+
+    // Queues a write of [data, data + length) to fd at offset. ref must
+    // borrow the object holding the data; it is released when the
+    // completion is reaped. Returns false, leaving ref with the caller, if
+    // the submission queue or the request table is full.
+    template <typename Reference>
+    bool write(int fd, Reference&& ref, const void* data, std::size_t length, std::uint64_t offset,
+               std::uint64_t tag = 0) noexcept
+    {
+        static_assert(!std::is_lvalue_reference<Reference>::value, "pass the reference with std::move");
+        return queue(IORING_OP_WRITE, fd, std::move(ref), data, length, offset, tag, 0);
+    }
+
+    // Queues a read into [data, data + length); ref as for write()
+    template <typename Reference>
+    bool read(int fd, Reference&& ref, void* data, std::size_t length, std::uint64_t offset,
+              std::uint64_t tag = 0) noexcept
+    {
+        static_assert(!std::is_lvalue_reference<Reference>::value, "pass the reference with std::move");
+        return queue(IORING_OP_READ, fd, std::move(ref), data, length, offset, tag, 0);
+    }
+
+    // Writes from registered buffer index of the set ref borrows. Returns
+    // false, leaving ref with the caller, if index or length is out of range.
+    bool write_fixed(int fd, typename io_uring_fixed_buffers<OptionalT>::reference&& ref, unsigned index,
+                     std::size_t length, std::uint64_t offset, std::uint64_t tag = 0) noexcept
+    {
+        if (!fixed_in_bounds(ref.get(), index, length))
+        {
+            return false;
+        }
+        unsigned char* data = ref.get().buffer(index);
+        return queue(IORING_OP_WRITE_FIXED, fd, std::move(ref), data, length, offset, tag, index);
+    }
+
+    bool read_fixed(int fd, typename io_uring_fixed_buffers<OptionalT>::reference&& ref, unsigned index,
+                    std::size_t length, std::uint64_t offset, std::uint64_t tag = 0) noexcept
+    {
+        if (!fixed_in_bounds(ref.get(), index, length))
+        {
+            return false;
+        }
+        unsigned char* data = ref.get().buffer(index);
+        return queue(IORING_OP_READ_FIXED, fd, std::move(ref), data, length, offset, tag, index);
+    }
+
+    // Submits everything queued. Returns the number submitted or -errno.
+    int submit() noexcept
+    {
+        return ring_.enter(0);
+    }
+
+    // Submits and blocks until at least count completions are available
+    int submit_and_wait(unsigned count) noexcept
+    {
+        return ring_.enter(count);
+    }
+
+    // Releases the reference each available completion's request held and
+    // recycles its slot, then passes the completion to on_complete. If
+    // on_complete throws, the completions after it stay for the next reap().
+    // Never blocks. Returns the number reaped.
+    template <typename F>
+    std::size_t reap(F&& on_complete)
+    {
+        return ring_.for_each_cqe(
+            [&](const io_uring_cqe& cqe)
+            {
+                const std::uint32_t slot    = static_cast<std::uint32_t>(cqe.user_data);
+                request&            pending = requests_[slot];
+                const std::uint64_t tag     = pending.tag;
+                pending.held.release();
+                free_.push_back(slot);  // Never reallocates: reserved for every slot
+                on_complete(io_uring_completion{tag, cqe.res});
+            });
+    }
+
+    // Requests queued or submitted whose completion has not been reaped
+    std::size_t in_flight() const noexcept
+    {
+        return requests_.size() - free_.size();
+    }
+
+private:
+    template <template <typename> class Opt>
+    friend class io_uring_fixed_buffers;
+
+    struct request
+    {
+        detail::held_reference held;
+        std::uint64_t          tag = 0;
+    };
+
+    static bool fixed_in_bounds(const detail::registered_buffers& buffers, unsigned index, std::size_t length) noexcept
+    {
+        return index < buffers.count() && length <= buffers.buffer_size();
+    }
+
+    template <typename Reference>
+    bool queue(std::uint8_t opcode, int fd, Reference&& ref, const void* data, std::size_t length,
+               std::uint64_t offset, std::uint64_t tag, unsigned buffer_index) noexcept
+    {
+        if (free_.empty())
+        {
+            return false;
+        }
+        io_uring_sqe* sqe = ring_.next_sqe();
+        if (sqe == nullptr)
+        {
+            return false;
+        }
+        const std::uint32_t slot = free_.back();
+        free_.pop_back();
+        requests_[slot].held.hold(std::move(ref));
+        requests_[slot].tag = tag;
+
+        sqe->opcode    = opcode;
+        sqe->fd        = fd;
+        sqe->addr      = reinterpret_cast<std::uintptr_t>(data);
+        sqe->len       = static_cast<std::uint32_t>(length);
+        sqe->off       = offset;
+        sqe->buf_index = static_cast<std::uint16_t>(buffer_index);
+        sqe->user_data = slot;
+        ring_.commit_sqe();
+        return true;
+    }
+
+    detail::io_ring            ring_;
+    std::vector<request>       requests_;
+    std::vector<std::uint32_t> free_;
+};
+
+// =============================================================================
+// io_uring_fixed_buffers - Registered buffers owned through a ref_owner
+// =============================================================================
+template <template <typename> class OptionalT = std::optional>
+class io_uring_fixed_buffers
+{
+public:
+    using owner_type = ref_owner<detail::registered_buffers, OptionalT, destruct_only<detail::registered_buffers>>;
+    using reference  = unique_reference<detail::registered_buffers, detail::registered_buffers, OptionalT,
+                                       destruct_only<detail::registered_buffers>>;
+
+    // Registers count buffers of buffer_size bytes with queue's ring (a ring
+    // has one registered set at a time). Check operator bool for failure.
+    io_uring_fixed_buffers(io_uring_queue<OptionalT>& queue, std::size_t count, std::size_t buffer_size) noexcept
+        : owner_(new (storage_) detail::registered_buffers(queue.ring_, count, buffer_size))
+    {
+        if (!owner_.get()->registered())
+        {
+            owner_.mark_and_delete_if_ready();
+        }
+    }
+
+    io_uring_fixed_buffers(const io_uring_fixed_buffers&)            = delete;
+    io_uring_fixed_buffers& operator=(const io_uring_fixed_buffers&) = delete;
+
+    // True while registered
+    explicit operator bool() const noexcept
+    {
+        return owner_.get() != nullptr;
+    }
+
+    std::size_t count() const noexcept
+    {
+        return *this ? owner_.get()->count() : 0;
+    }
+
+    std::size_t buffer_size() const noexcept
+    {
+        return *this ? owner_.get()->buffer_size() : 0;
+    }
+
+    // Buffer to fill before write_fixed() (or read after read_fixed())
+    unsigned char* buffer(std::size_t index) const noexcept
+    {
+        return owner_.get()->buffer(index);
+    }
+
+    // Borrow for one fixed I/O; empty once unregister() has been called
+    OptionalT<reference> try_make_ref() noexcept
+    {
+        return owner_.try_make_ref();
+    }
+
+    // Marks the set and, once no fixed I/O holds it, unregisters and frees
+    // the buffers. Returns false while I/O is in flight; call again (e.g. in
+    // the reclaim phase) after reaping.
+    bool unregister() noexcept
+    {
+        return owner_.mark_and_delete_if_ready();
+    }
+
+    std::size_t ref_count() const noexcept
+    {
+        return owner_.ref_count();
+    }
+
+private:
+    owner_type owner_;
+    alignas(detail::registered_buffers) unsigned char storage_[sizeof(detail::registered_buffers)];
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_IO_URING_QUEUE_H
@@ -0,0 +1,311 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Constant-initialized ref_owner that constructs its object on first use
+ */
+#ifndef ZOOX_LAZY_REF_OWNER_H
+#define ZOOX_LAZY_REF_OWNER_H
+
+// =============================================================================
+// zoox::lazy_ref_owner - constinit owner for process-wide services
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// ref_owner takes a T* in every constructor, so a global ref_owner is built by
+// a dynamic initializer and participates in the static-initialization-order
+// problem. lazy_ref_owner has a constexpr constructor and holds no object
+// until the first try_make_ref()/make_ref(), which constructs T in inline
+// storage using a lock-free once-protocol (one CAS, no mutex). After that it
+// is an ordinary ref_owner with the usual mark/delete lifecycle.
+//
+// BASIC USAGE
+// -----------
+//
+//   ZOOX_CONSTINIT zoox::lazy_ref_owner<Logger> g_logger;  // No code runs at startup
+//
+//   auto ref = g_logger.make_ref();    // Constructs Logger on first call
+//
+//   // Non-default construction: any callable returning T
+//   Config load_config();
+//   ZOOX_CONSTINIT zoox::lazy_ref_owner<Config, std::optional, Config (*)()> g_config(&load_config);
+//
+//   // Shutdown: same protocol as ref_owner
+//   g_logger.mark_and_delete_if_ready();
+//
+// Marking an owner that was never used retires it: no object is constructed
+// afterwards and delete_if_deleteable() reports it as deleted.
+//
+// ZOOX_CONSTINIT is constinit in C++20 and [[clang::require_constant_
+// initialization]] on Clang. On GCC in C++17 it expands to nothing: the
+// constexpr constructor still gives constant initialization, but nothing
+// checks it, so a Factory that cannot be constructed at compile time
+// silently falls back to a dynamic initializer there.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+
+#if defined(__cpp_constinit)
+#    define ZOOX_CONSTINIT constinit
+#elif defined(__clang__)
+#    define ZOOX_CONSTINIT [[clang::require_constant_initialization]]
+#else
+#    define ZOOX_CONSTINIT
+#endif
+
+namespace zoox
+{
+
+// Default factory for lazy_ref_owner: value-initializes T
+template <typename T>
+struct default_construct
+{
+    constexpr T operator()() const noexcept(std::is_nothrow_default_constructible<T>::value)
+    {
+        return T();
+    }
+};
+
+template <typename T,
+          template <typename> class OptionalT = std::optional,
+          typename Factory                    = default_construct<T>>
+class lazy_ref_owner
+{
+public:
+    using owner_type = ref_owner<T, OptionalT, destruct_only<T>>;
+    using reference  = unique_reference<T, T, OptionalT, destruct_only<T>>;
+
+    constexpr lazy_ref_owner() noexcept(std::is_nothrow_default_constructible<Factory>::value) = default;
+
+    constexpr explicit lazy_ref_owner(Factory factory) noexcept(std::is_nothrow_move_constructible<Factory>::value)
+        : factory_(std::move(factory))
+    {
+    }
+
+    ~lazy_ref_owner() noexcept(std::is_nothrow_destructible<owner_type>::value)
+    {
+        if (state_.load(std::memory_order_acquire) == state::ready)
+        {
+            // Same outstanding-reference policy as ref_owner's destructor
+            owner()->~owner_type();
+        }
+    }
+
+    // Non-copyable, non-movable (references point into inline storage)
+    lazy_ref_owner(const lazy_ref_owner&)            = delete;
+    lazy_ref_owner& operator=(const lazy_ref_owner&) = delete;
+    lazy_ref_owner(lazy_ref_owner&&)                 = delete;
+    lazy_ref_owner& operator=(lazy_ref_owner&&)      = delete;
+
+    // Constructs T on first use. Returns empty optional if marked for deletion
+    // (including when marked before ever being constructed).
+    OptionalT<reference> try_make_ref() noexcept(std::is_nothrow_invocable<Factory&>::value)
+    {
+        owner_type* constructed = ensure_constructed();
+        if (constructed == nullptr)
+        {
+            return {};
+        }
+        return constructed->try_make_ref();
+    }
+
+#ifdef __cpp_exceptions
+    reference make_ref()
+    {
+        owner_type* constructed = ensure_constructed();
+        if (constructed == nullptr)
+        {
+            throw ref_owner_marked_exception();
+        }
+        return constructed->make_ref();
+    }
+#endif
+
+    // True once T has been constructed (stays true after deletion)
+    bool is_constructed() const noexcept
+    {
+        return state_.load(std::memory_order_acquire) == state::ready;
+    }
+
+    // Query methods - an owner that was never constructed has no references
+    bool has_outstanding_references() const noexcept
+    {
+        const owner_type* constructed = constructed_owner();
+        return constructed != nullptr && constructed->has_outstanding_references();
+    }
+
+    size_t ref_count() const noexcept
+    {
+        const owner_type* constructed = constructed_owner();
+        return constructed != nullptr ? constructed->ref_count() : 0;
+    }
+
+    bool is_marked_for_deletion() const noexcept
+    {
+        const owner_type* constructed = constructed_owner();
+        return constructed != nullptr ? constructed->is_marked_for_deletion() : is_retired();
+    }
+
+    bool is_deleted() const noexcept
+    {
+        const owner_type* constructed = constructed_owner();
+        return constructed != nullptr ? constructed->is_deleted()
+                                      : state_.load(std::memory_order_acquire) == state::retired_deleted;
+    }
+
+    // Marks the constructed owner, or retires an owner that was never used so
+    // that it is never constructed
+    void mark_for_deletion() noexcept
+    {
+        std::uint8_t current = state_.load(std::memory_order_acquire);
+        for (;;)
+        {
+            if (current == state::ready)
+            {
+                owner()->mark_for_deletion();
+                return;
+            }
+            if (current == state::retired || current == state::retired_deleted)
+            {
+                return;
+            }
+            if (current == state::constructing)
+            {
+                std::this_thread::yield();
+                current = state_.load(std::memory_order_acquire);
+                continue;
+            }
+            if (state_.compare_exchange_weak(current, state::retired, std::memory_order_acq_rel))
+            {
+                return;
+            }
+        }
+    }
+
+    // Returns true if deletion occurred. A retired owner has nothing to
+    // destroy and reports true the first time it is asked.
+    bool delete_if_deleteable() noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        owner_type* constructed = constructed_owner();
+        if (constructed != nullptr)
+        {
+            return constructed->delete_if_deleteable();
+        }
+        std::uint8_t expected = state::retired;
+        return state_.compare_exchange_strong(expected, state::retired_deleted, std::memory_order_acq_rel);
+    }
+
+    bool mark_and_delete_if_ready() noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        mark_for_deletion();
+        return delete_if_deleteable();
+    }
+
+private:
+    struct state
+    {
+        static constexpr std::uint8_t uninitialized   = 0;
+        static constexpr std::uint8_t constructing    = 1;
+        static constexpr std::uint8_t ready           = 2;
+        static constexpr std::uint8_t retired         = 3;
+        static constexpr std::uint8_t retired_deleted = 4;
+    };
+
+    // Once-protocol: the thread that wins the CAS constructs; others wait for
+    // ready. Returns nullptr if the owner was retired before construction.
+    owner_type* ensure_constructed() noexcept(std::is_nothrow_invocable<Factory&>::value)
+    {
+        std::uint8_t current = state_.load(std::memory_order_acquire);
+        while (current != state::ready)
+        {
+            if (current == state::retired || current == state::retired_deleted)
+            {
+                return nullptr;
+            }
+            if (current == state::uninitialized &&
+                state_.compare_exchange_weak(current, state::constructing, std::memory_order_acq_rel))
+            {
+                construct();
+                state_.store(state::ready, std::memory_order_release);
+                break;
+            }
+            if (current == state::constructing)
+            {
+                std::this_thread::yield();
+                current = state_.load(std::memory_order_acquire);
+            }
+        }
+        return owner();
+    }
+
+    void construct() noexcept(std::is_nothrow_invocable<Factory&>::value)
+    {
+#ifdef __cpp_exceptions
+        // Only a throwing factory needs the rollback; in a noexcept function
+        // the rethrow would be a guaranteed terminate (and a -Wterminate error)
+        if constexpr (!std::is_nothrow_invocable<Factory&>::value)
+        {
+            try
+            {
+                emplace();
+            }
+            catch (...)
+            {
+                // Let the next caller retry
+                state_.store(state::uninitialized, std::memory_order_release);
+                throw;
+            }
+            return;
+        }
+#endif
+        emplace();
+    }
+
+    void emplace() noexcept(std::is_nothrow_invocable<Factory&>::value)
+    {
+        T* object = new (object_storage_) T(factory_());
+        new (owner_storage_) owner_type(object);
+    }
+
+    bool is_retired() const noexcept
+    {
+        const std::uint8_t current = state_.load(std::memory_order_acquire);
+        return current == state::retired || current == state::retired_deleted;
+    }
+
+    owner_type* owner() noexcept
+    {
+        return std::launder(reinterpret_cast<owner_type*>(owner_storage_));  // NOLINT: inline storage
+    }
+
+    const owner_type* constructed_owner() const noexcept
+    {
+        if (state_.load(std::memory_order_acquire) != state::ready)
+        {
+            return nullptr;
+        }
+        return std::launder(reinterpret_cast<const owner_type*>(owner_storage_));  // NOLINT: inline storage
+    }
+
+    owner_type* constructed_owner() noexcept
+    {
+        return state_.load(std::memory_order_acquire) == state::ready ? owner() : nullptr;
+    }
+
+    std::atomic<std::uint8_t> state_{state::uninitialized};
+    Factory                   factory_{};
+    alignas(owner_type) unsigned char owner_storage_[sizeof(owner_type)]{};
+    alignas(T) unsigned char object_storage_[sizeof(T)]{};
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_LAZY_REF_OWNER_H
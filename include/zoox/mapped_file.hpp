@@ -0,0 +1,359 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Memory-mapped file owner that lends out ranges and unmaps deterministically
+ */
+#ifndef ZOOX_MAPPED_FILE_H
+#define ZOOX_MAPPED_FILE_H
+
+// =============================================================================
+// zoox::mapped_file - Zero-copy file ranges under the ref_owner protocol
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Map tiles and logs are large, read-mostly, and served to many readers.
+// mapped_file mmaps the file once and lends out byte ranges of it. Each
+// mapped_range holds a unique_reference to the mapping, so the mapping
+// cannot go away under a reader:
+//
+//   - try_borrow(offset, length) checks the range, registers a reference,
+//     and optionally passes an access hint to madvise() for the pages the
+//     range covers (e.g. prefetch with will_need).
+//   - munmap() runs only in delete_if_deleteable(), after the owner is
+//     marked and every range has been released - i.e. in the reclaim phase
+//     that calls it, never on a reader's thread.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::mapped_file tiles("/maps/city.tiles");
+//   if (!tiles) { /* open or mmap failed */ }
+//
+//   auto range = tiles.try_borrow(index.offset, index.length, zoox::access_hint::will_need);
+//   decode(range->data(), range->size());          // Straight from the page cache
+//
+//   // Reclaim phase
+//   tiles.mark_and_delete_if_ready();              // munmap once the ranges are gone
+//
+// The mapping is read-only and private. As with ref_owner, delete before
+// destroying: destroying a mapped_file that is not deleted follows
+// ref_owner's destructor policy. A file that failed to map starts deleted.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <utility>
+
+#ifdef __cpp_exceptions
+#    include <stdexcept>
+#endif
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace zoox
+{
+
+// madvise() advice applied to the pages of a borrowed range
+enum class access_hint
+{
+    none,
+    will_need,   // MADV_WILLNEED: start reading the pages in now
+    sequential,  // MADV_SEQUENTIAL: aggressive read-ahead, early reclaim
+    random       // MADV_RANDOM: no read-ahead
+};
+
+struct mapped_file_options
+{
+    // MAP_POPULATE: read the whole file in at open
+    bool populate = false;
+};
+
+namespace detail
+{
+
+// The mapping itself; destroyed (unmapped) only by the owner's delete
+class file_mapping
+{
+public:
+    file_mapping(int fd, const mapped_file_options& options) noexcept
+    {
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            return;
+        }
+        const std::size_t size  = static_cast<std::size_t>(st.st_size);
+        int               flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+        if (options.populate)
+        {
+            flags |= MAP_POPULATE;
+        }
+#else
+        (void) options;
+#endif
+        void* memory = mmap(nullptr, size, PROT_READ, flags, fd, 0);
+        if (memory != MAP_FAILED)
+        {
+            data_ = static_cast<const unsigned char*>(memory);
+            size_ = size;
+        }
+    }
+
+    ~file_mapping()
+    {
+        if (data_ != nullptr)
+        {
+            munmap(const_cast<unsigned char*>(data_), size_);
+        }
+    }
+
+    file_mapping(const file_mapping&)            = delete;
+    file_mapping& operator=(const file_mapping&) = delete;
+
+    const unsigned char* data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    // Best effort; a failed madvise() does not affect the borrow
+    void advise(std::size_t offset, std::size_t length, access_hint hint) const noexcept
+    {
+        int advice = 0;
+        switch (hint)
+        {
+            case access_hint::none:
+                return;
+            case access_hint::will_need:
+                advice = MADV_WILLNEED;
+                break;
+            case access_hint::sequential:
+                advice = MADV_SEQUENTIAL;
+                break;
+            case access_hint::random:
+                advice = MADV_RANDOM;
+                break;
+        }
+        // madvise() takes page-aligned ranges: cover every page of the range
+        const std::size_t page  = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        const std::size_t begin = offset / page * page;
+        const std::size_t end   = offset + length;
+        madvise(const_cast<unsigned char*>(data_) + begin, end - begin, advice);
+    }
+
+private:
+    const unsigned char* data_ = nullptr;
+    std::size_t          size_ = 0;
+};
+
+}  // namespace detail
+
+// =============================================================================
+// mapped_range - A borrowed byte range of a mapped_file
+// =============================================================================
+template <template <typename> class OptionalT = std::optional>
+class basic_mapped_range
+{
+public:
+    using reference = unique_reference<const detail::file_mapping, detail::file_mapping, OptionalT,
+                                       destruct_only<detail::file_mapping>>;
+
+    basic_mapped_range(reference&& ref, std::size_t offset, std::size_t length) noexcept
+        : ref_(std::move(ref))
+        , data_(ref_.get().data() + offset)
+        , size_(length)
+        , offset_(offset)
+    {
+    }
+
+    const unsigned char* data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    // Position of the range in the file
+    std::size_t offset() const noexcept
+    {
+        return offset_;
+    }
+
+    const unsigned char* begin() const noexcept
+    {
+        return data_;
+    }
+
+    const unsigned char* end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+    unsigned char operator[](std::size_t i) const noexcept
+    {
+        return data_[i];
+    }
+
+private:
+    reference            ref_;  // Pins the mapping
+    const unsigned char* data_;
+    std::size_t          size_;
+    std::size_t          offset_;
+};
+
+// =============================================================================
+// mapped_file - Owns a read-only file mapping
+// =============================================================================
+template <template <typename> class OptionalT = std::optional>
+class basic_mapped_file
+{
+public:
+    using range = basic_mapped_range<OptionalT>;
+
+    // Maps the file at path. Check operator bool for failure.
+    explicit basic_mapped_file(const char* path, const mapped_file_options& options = mapped_file_options()) noexcept
+        : basic_mapped_file(open_read_only(path), options, true)
+    {
+    }
+
+    // Maps an open descriptor; fd stays open and owned by the caller
+    explicit basic_mapped_file(int fd, const mapped_file_options& options = mapped_file_options()) noexcept
+        : basic_mapped_file(fd, options, false)
+    {
+    }
+
+    // Non-copyable, non-movable (ranges reference the owner)
+    basic_mapped_file(const basic_mapped_file&)            = delete;
+    basic_mapped_file& operator=(const basic_mapped_file&) = delete;
+    basic_mapped_file(basic_mapped_file&&)                 = delete;
+    basic_mapped_file& operator=(basic_mapped_file&&)      = delete;
+
+    // True while the file is mapped. Reads only the owner's flags: the
+    // mapping itself may be unmapped concurrently and is not touched.
+    explicit operator bool() const noexcept
+    {
+        return !owner_.is_deleted();
+    }
+
+    // Mapped length (the file size at open); 0 if not mapped
+    std::size_t size() const noexcept
+    {
+        return owner_.is_deleted() ? 0 : size_;
+    }
+
+    // Borrows [offset, offset + length). Returns empty if the range is out
+    // of bounds, the file is not mapped, or the owner is marked for deletion.
+    OptionalT<range> try_borrow(std::size_t offset, std::size_t length, access_hint hint = access_hint::none) noexcept
+    {
+        // Register before touching the mapping so it cannot be unmapped
+        // under the bounds check; an out-of-bounds reference is dropped
+        auto ref = owner_.try_make_ref();
+        if (!ref || !in_bounds(ref->get(), offset, length))
+        {
+            return {};
+        }
+        ref->get().advise(offset, length, hint);
+        return OptionalT<range>(range(typename range::reference(std::move(*ref)), offset, length));
+    }
+
+#ifdef __cpp_exceptions
+    // Throws std::out_of_range for a bad range, or the ref_owner exceptions
+    range borrow(std::size_t offset, std::size_t length, access_hint hint = access_hint::none)
+    {
+        typename range::reference ref(owner_.make_ref());
+        if (!in_bounds(ref.get(), offset, length))
+        {
+            throw std::out_of_range("mapped_file range out of bounds");
+        }
+        ref.get().advise(offset, length, hint);
+        return range(std::move(ref), offset, length);
+    }
+#endif
+
+    // Deletion protocol of the underlying ref_owner; deleting unmaps
+    void mark_for_deletion() noexcept
+    {
+        owner_.mark_for_deletion();
+    }
+
+    bool delete_if_deleteable() noexcept
+    {
+        return owner_.delete_if_deleteable();
+    }
+
+    bool mark_and_delete_if_ready() noexcept
+    {
+        return owner_.mark_and_delete_if_ready();
+    }
+
+    bool is_marked_for_deletion() const noexcept
+    {
+        return owner_.is_marked_for_deletion();
+    }
+
+    // Ranges currently borrowed
+    std::size_t ref_count() const noexcept
+    {
+        return owner_.ref_count();
+    }
+
+private:
+    using owner_type = ref_owner<detail::file_mapping, OptionalT, destruct_only<detail::file_mapping>>;
+
+    basic_mapped_file(int fd, const mapped_file_options& options, bool close_fd) noexcept
+        : owner_(new (storage_) detail::file_mapping(fd, options))
+    {
+        if (close_fd && fd >= 0)
+        {
+            close(fd);
+        }
+        if (owner_.get()->data() == nullptr)
+        {
+            // Nothing to lend out; leave the owner deleted
+            owner_.mark_and_delete_if_ready();
+            return;
+        }
+        size_ = owner_.get()->size();
+    }
+
+    static int open_read_only(const char* path) noexcept
+    {
+        return open(path, O_RDONLY | O_CLOEXEC);
+    }
+
+    static bool in_bounds(const detail::file_mapping& mapping, std::size_t offset, std::size_t length) noexcept
+    {
+        const std::size_t mapped = mapping.size();
+        return mapped != 0 && offset <= mapped && length <= mapped - offset;
+    }
+
+    owner_type  owner_;
+    std::size_t size_ = 0;  // Mapped length, set once at open
+    alignas(detail::file_mapping) unsigned char storage_[sizeof(detail::file_mapping)];
+};
+
+using mapped_range = basic_mapped_range<>;
+using mapped_file  = basic_mapped_file<>;
+
+}  // namespace zoox
+
+#endif  // ZOOX_MAPPED_FILE_H
@@ -0,0 +1,138 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Memory source policy for pool and arena backing storage
+ */
+#ifndef ZOOX_MEMORY_SOURCE_H
+#define ZOOX_MEMORY_SOURCE_H
+
+// =============================================================================
+// zoox memory sources - Where ref_owner_pool, recycling_pool and frame_arena
+// get their one up-front block of storage
+// =============================================================================
+//
+// A memory source is any movable type with
+//
+//   void* allocate(std::size_t bytes, std::size_t alignment);   // nullptr on failure
+//   void  deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept;
+//
+// The pools and the arena call allocate() once, in their constructor, and
+// deallocate() once, in their destructor. Nothing on the borrow or
+// dereference path touches the source.
+//
+// Provided sources:
+//
+//   inline_memory             - Tag for the pools: slots live inside the pool
+//                               object itself (the default, no allocation)
+//   new_delete_memory_source  - Aligned operator new (frame_arena default)
+//   pinned_memory_source      - Huge pages, NUMA-local, prefaulted and mlocked
+//                               (zoox/pinned_memory.hpp)
+//
+// =============================================================================
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace zoox
+{
+
+// Tag: keep pool slots inline in the pool object
+struct inline_memory
+{};
+
+class new_delete_memory_source
+{
+public:
+    void* allocate(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        return ::operator new(bytes, std::align_val_t{alignment}, std::nothrow);
+    }
+
+    void deallocate(void* p, std::size_t /*bytes*/, std::size_t alignment) noexcept
+    {
+        ::operator delete(p, std::align_val_t{alignment});
+    }
+};
+
+namespace detail
+{
+
+[[noreturn]] inline void throw_bad_alloc()
+{
+#ifdef __cpp_exceptions
+    throw std::bad_alloc();
+#else
+    std::abort();
+#endif
+}
+
+// Capacity slots obtained from MemorySource, constructed and destroyed by the
+// owning pool
+template <typename Slot, std::size_t Capacity, typename MemorySource>
+class slot_storage
+{
+public:
+    explicit slot_storage(MemorySource source)
+        : source_(std::move(source))
+        , slots_(static_cast<Slot*>(source_.allocate(sizeof(Slot) * Capacity, alignof(Slot))))
+    {
+        if (slots_ == nullptr)
+        {
+            throw_bad_alloc();
+        }
+    }
+
+    ~slot_storage()
+    {
+        source_.deallocate(slots_, sizeof(Slot) * Capacity, alignof(Slot));
+    }
+
+    slot_storage(const slot_storage&)            = delete;
+    slot_storage& operator=(const slot_storage&) = delete;
+
+    Slot& operator[](std::size_t index) noexcept
+    {
+        return slots_[index];
+    }
+
+    const MemorySource& source() const noexcept
+    {
+        return source_;
+    }
+
+private:
+    MemorySource source_;
+    Slot*        slots_;
+};
+
+template <typename Slot, std::size_t Capacity>
+class slot_storage<Slot, Capacity, inline_memory>
+{
+public:
+    explicit slot_storage(inline_memory) noexcept {}
+
+    ~slot_storage() {}
+
+    slot_storage(const slot_storage&)            = delete;
+    slot_storage& operator=(const slot_storage&) = delete;
+
+    Slot& operator[](std::size_t index) noexcept
+    {
+        return slots_[index];
+    }
+
+private:
+    union
+    {
+        Slot slots_[Capacity];
+    };
+};
+
+}  // namespace detail
+}  // namespace zoox
+
+#endif  // ZOOX_MEMORY_SOURCE_H
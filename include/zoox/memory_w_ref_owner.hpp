@@ -30,7 +30,9 @@
 // ------------
 // 1. ref_owner<T>    - The owning pointer (like unique_ptr with ref tracking)
 // 2. unique_reference<T> - A non-copyable reference (like reference_wrapper)
-// 3. Explicit deletion   - Owner calls mark_for_deletion() + delete_if_deleteable()
+// 3. exclusive_reference<T> - A move-only mutable borrow that excludes all others
+// 4. weak_observer<T>   - A non-counting handle that can upgrade to a reference
+// 5. Explicit deletion   - Owner calls mark_for_deletion() + delete_if_deleteable()
 //
 // BASIC USAGE
 // -----------
@@ -76,6 +78,41 @@
 //   - Automatically decrements ref count on destruction
 //   - Provides get(), operator*, operator->, and implicit conversion
 //
+// EXCLUSIVE REFERENCES
+// --------------------
+// exclusive_reference<T> is a reader/writer style borrow that shares the
+// ref_count_ state word with unique_reference. It can only be taken when no
+// other reference exists, and while it is held no new unique_reference can be
+// created. No separate mutex is needed to mutate the owned object in place:
+//
+//   if (auto writer = owner.try_make_exclusive_ref()) {
+//       (*writer)->mutate();                  // No other borrower can exist
+//   }
+//
+//   auto reader = owner.make_ref();
+//   auto maybe_writer = zoox::try_upgrade_reference(std::move(reader));
+//   if (maybe_writer) {                       // reader was the only borrower
+//       auto reader_again = zoox::downgrade_reference(std::move(*maybe_writer));
+//   }
+//
+// WEAK OBSERVERS
+// --------------
+// weak_observer<T> remembers an owner without holding a reference, so it never
+// blocks deletion and costs nothing while idle. try_upgrade() registers a
+// unique_reference only if the owner is still live:
+//
+//   zoox::weak_observer<MyClass> observer(owner);   // ref_count() unchanged
+//   if (auto ref = observer.try_upgrade()) {
+//       (*ref)->doSomething();
+//   }
+//
+// The owner must outlive the observer. Pools may recycle it with rearm():
+// every rearm gives the owner a new generation that the observer checks
+// after registering, so a recycled slot is never mistaken for the object
+// that was observed. Destroying the owner and placement-new'ing another in
+// its storage is not supported: the observer may still be touching the old
+// owner's counter while the storage is rebuilt.
+//
 // Example with polymorphism:
 //
 //   zoox::ref_owner<Derived> ptr(new Derived());
@@ -108,6 +145,10 @@
 //   zoox::ref_owner<MyClass, std::optional, decltype(deleter)>
 //       ptr(new MyClass(), deleter);
 //
+//   // Destructor only, for objects placement-new'd into managed storage
+//   zoox::ref_owner<MyClass, std::optional, zoox::destruct_only<MyClass>>
+//       ptr(new (buffer) MyClass());
+//
 //   // From unique_ptr with custom deleter
 //   auto uptr = std::unique_ptr<MyClass, MyDeleter>(new MyClass());
 //   zoox::ref_owner<MyClass, std::optional, MyDeleter> ptr(std::move(uptr));
@@ -158,6 +199,7 @@
 
 #include <memory>
 #include <atomic>
+#include <cstdint>
 #include <cassert>
 #include <chrono>
 #include <type_traits>
@@ -170,6 +212,35 @@
 #    include <stdexcept>
 #endif
 
+#include "zoox/usdt_probes.hpp"
+
+// Opt-in event recording (zoox/flight_recorder.hpp); must be defined the
+// same way in every translation unit
+#ifdef ZOOX_ENABLE_FLIGHT_RECORDER
+#    include "zoox/flight_recorder.hpp"
+#    define ZOOX_FLIGHT_RECORD(op, owner, count) \
+        ::zoox::global_flight_recorder().record(::zoox::flight_op::op, owner, count)
+#else
+#    define ZOOX_FLIGHT_RECORD(op, owner, count) static_cast<void>(0)
+#endif
+
+// Opt-in records of who holds each reference (zoox/holder_tracking.hpp);
+// must be defined the same way in every translation unit. The SITE macros
+// add a defaulted call-site parameter to the reference-creating functions
+// and forward it, and expand to nothing when tracking is off.
+#ifdef ZOOX_TRACK_HOLDERS
+#    include "zoox/holder_tracking.hpp"
+#    define ZOOX_HOLDER_SITE ::zoox::holder_site site = ::zoox::holder_site::current()
+#    define ZOOX_HOLDER_SITE_NEXT , ZOOX_HOLDER_SITE
+#    define ZOOX_HOLDER_SITE_ARG site
+#    define ZOOX_HOLDER_SITE_NEXT_ARG , site
+#else
+#    define ZOOX_HOLDER_SITE
+#    define ZOOX_HOLDER_SITE_NEXT
+#    define ZOOX_HOLDER_SITE_ARG
+#    define ZOOX_HOLDER_SITE_NEXT_ARG
+#endif
+
 namespace zoox
 {
 
@@ -185,6 +256,43 @@ template <typename T,
           typename Deleter                    = std::default_delete<T>>
 class waitable_ref_owner;
 
+template <typename T,
+          template <typename> class OptionalT = std::optional,
+          typename Deleter                    = std::default_delete<T>>
+class exclusive_reference;
+
+template <typename T,
+          template <typename> class OptionalT = std::optional,
+          typename Deleter                    = std::default_delete<T>>
+class weak_observer;
+
+template <typename ReferenceType,
+          typename BaseType                   = ReferenceType,
+          template <typename> class OptionalT = std::optional,
+          typename Deleter                    = std::default_delete<BaseType>>
+class atomic_reference;
+
+namespace detail
+{
+// Process-wide source of ref_owner generations used by weak_observer to
+// detect a rearmed owner. Only touched on construction, move and rearm().
+inline std::uint64_t next_owner_generation() noexcept
+{
+    static std::atomic<std::uint64_t> counter{1};
+    return counter.fetch_add(1, std::memory_order_relaxed);
+}
+}  // namespace detail
+
+// Result of delete_if_deleteable(), reported by the "delete" probe
+enum class ref_owner_delete_outcome : std::uint8_t
+{
+    deleted          = 0,
+    not_marked       = 1,
+    already_deleted  = 2,
+    refs_outstanding = 3,
+    lost_race        = 4  // Another thread deleted first
+};
+
 #ifdef __cpp_exceptions
 // Exception thrown when attempting to create a unique_reference
 // from a ref_owner that has been marked for deletion
@@ -197,8 +305,36 @@ public:
     {
     }
 };
+
+// Exception thrown when attempting to create a unique_reference
+// from a ref_owner that is currently exclusively borrowed
+class ref_owner_exclusive_exception : public std::runtime_error
+{
+public:
+    ref_owner_exclusive_exception()
+        : std::runtime_error("Cannot create unique_reference: "
+                             "ref_owner is exclusively borrowed")
+    {
+    }
+};
 #endif
 
+// =============================================================================
+// destruct_only - Deleter for objects whose storage is managed elsewhere
+// =============================================================================
+//
+// Runs the destructor without deallocating. Used with placement new when the
+// object lives in a stack buffer, static pool, or node-local allocation.
+//
+template <typename T>
+struct destruct_only
+{
+    void operator()(T* p) const noexcept
+    {
+        p->~T();
+    }
+};
+
 // =============================================================================
 // ref_owner - Lock-free base implementation
 // =============================================================================
@@ -218,6 +354,13 @@ public:
 //   deleted            -> deleted_              (atomic<bool>)
 //   clientRefs[c]      -> (implicit in unique_reference instances)
 //
+// EXCLUSIVE BORROWS:
+//   The top bit of ref_count_ (exclusive_ref_flag) is set while an
+//   exclusive_reference exists. Shared registration sees the flag in the
+//   value returned by its optimistic increment and rolls back exactly like
+//   TryMakeRefFail. Because the flag keeps ref_count_ non-zero, the deletion
+//   precondition refCount = 0 covers exclusive borrows without new state.
+//
 // SAFETY INVARIANTS (proven by TLC model checker):
 //   NoUseAfterFree:        deleted => (refCount = 0)
 //   NoInvalidReference:    ~(deleted /\ refCount > 0)
@@ -234,19 +377,25 @@ class ref_owner
 public:
     using deleter_type = Deleter;
 
+    // Bit of ref_count_ that is set while an exclusive_reference is held
+    static constexpr size_t exclusive_ref_flag = size_t{1} << (sizeof(size_t) * 8U - 1U);
+
     // Construction
     explicit ref_owner(T* ptr)
         : owned_ptr_(ptr)
+        , generation_(detail::next_owner_generation())
     {
     }
 
     explicit ref_owner(T* ptr, Deleter d)
         : owned_ptr_(ptr, std::move(d))
+        , generation_(detail::next_owner_generation())
     {
     }
 
     explicit ref_owner(std::unique_ptr<T, Deleter> ptr)
         : owned_ptr_(std::move(ptr))
+        , generation_(detail::next_owner_generation())
     {
     }
 
@@ -291,8 +440,14 @@ public:
         , ref_count_(other.ref_count_.load(std::memory_order_relaxed))
         , marked_for_deletion_(other.marked_for_deletion_.load(std::memory_order_relaxed))
         , deleted_(other.deleted_.load(std::memory_order_relaxed))
+        , generation_(other.generation_.load(std::memory_order_relaxed))
+#ifdef ZOOX_TRACK_HOLDERS
+        , holders_(std::move(other.holders_))
+#endif
     {
         other.ref_count_.store(0, std::memory_order_relaxed);
+        // Observers of the moved-from owner must not upgrade to its empty state
+        other.generation_.store(detail::next_owner_generation(), std::memory_order_release);
     }
 
     ref_owner& operator=(ref_owner&& other) noexcept(std::is_nothrow_destructible<T>::value)
@@ -304,7 +459,12 @@ public:
             marked_for_deletion_.store(other.marked_for_deletion_.load(std::memory_order_relaxed),
                                        std::memory_order_relaxed);
             deleted_.store(other.deleted_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            generation_.store(other.generation_.load(std::memory_order_relaxed), std::memory_order_release);
             other.ref_count_.store(0, std::memory_order_relaxed);
+            other.generation_.store(detail::next_owner_generation(), std::memory_order_release);
+#ifdef ZOOX_TRACK_HOLDERS
+            holders_ = std::move(other.holders_);
+#endif
         }
         return *this;
     }
@@ -330,7 +490,7 @@ public:
     // Reference creation - returns OptionalT (default: std::optional)
     // Returns empty optional if marked for deletion
     // LOCK-FREE: Uses optimistic increment + check + rollback pattern
-    OptionalT<unique_reference<T, T, OptionalT, Deleter>> try_make_ref() noexcept
+    OptionalT<unique_reference<T, T, OptionalT, Deleter>> try_make_ref(ZOOX_HOLDER_SITE) noexcept
     {
         if (!try_register_ref())
         {
@@ -338,31 +498,93 @@ public:
         }
         typename unique_reference<T, T, OptionalT, Deleter>::already_registered tag;
         return OptionalT<unique_reference<T, T, OptionalT, Deleter>>(
-            unique_reference<T, T, OptionalT, Deleter>(*this, tag));
+            unique_reference<T, T, OptionalT, Deleter>(*this, tag ZOOX_HOLDER_SITE_NEXT_ARG));
     }
 
 #ifdef __cpp_exceptions
-    // Reference creation - throws if marked for deletion
-    unique_reference<T, T, OptionalT, Deleter> make_ref()
+    // Reference creation - throws if marked for deletion or exclusively borrowed
+    unique_reference<T, T, OptionalT, Deleter> make_ref(ZOOX_HOLDER_SITE)
     {
         if (!try_register_ref())
         {
+            if (!is_marked_for_deletion())
+            {
+                throw ref_owner_exclusive_exception();
+            }
             throw ref_owner_marked_exception();
         }
         typename unique_reference<T, T, OptionalT, Deleter>::already_registered tag;
-        return unique_reference<T, T, OptionalT, Deleter>(*this, tag);
+        return unique_reference<T, T, OptionalT, Deleter>(*this, tag ZOOX_HOLDER_SITE_NEXT_ARG);
     }
 #endif
 
+    // Batched reference creation - registers count references with a single
+    // increment and hands each to out(unique_reference&&). Registers none and
+    // returns false if marked for deletion or exclusively borrowed.
+    // LOCK-FREE: Uses optimistic fetch_add(count) + check + rollback pattern
+    template <typename Out>
+    bool try_make_refs(size_t count, Out&& out ZOOX_HOLDER_SITE_NEXT)
+    {
+        if (!try_register_refs(count))
+        {
+            return false;
+        }
+        typename unique_reference<T, T, OptionalT, Deleter>::already_registered tag;
+
+        size_t handed = 0;
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            for (; handed < count; ++handed)
+            {
+                out(unique_reference<T, T, OptionalT, Deleter>(*this, tag ZOOX_HOLDER_SITE_NEXT_ARG));
+            }
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            // The reference being handed over released itself on unwind;
+            // release the registrations that were never handed out
+            for (++handed; handed < count; ++handed)
+            {
+                on_ref_released();
+            }
+            throw;
+        }
+#endif
+        return true;
+    }
+
+    // Exclusive reference creation - returns empty optional if any other
+    // reference exists or if marked for deletion. While the returned reference
+    // is held, try_make_ref() fails.
+    // LOCK-FREE: Single CAS on ref_count_ + check + rollback pattern
+    OptionalT<exclusive_reference<T, OptionalT, Deleter>> try_make_exclusive_ref() noexcept
+    {
+        if (!try_register_exclusive_ref())
+        {
+            return {};
+        }
+        return OptionalT<exclusive_reference<T, OptionalT, Deleter>>(exclusive_reference<T, OptionalT, Deleter>(this));
+    }
+
     // Query methods
     bool has_outstanding_references() const noexcept
     {
         return ref_count_.load(std::memory_order_acquire) > 0;
     }
 
+    // Number of outstanding references; an exclusive_reference counts as one
     size_t ref_count() const noexcept
     {
-        return ref_count_.load(std::memory_order_acquire);
+        const size_t state = ref_count_.load(std::memory_order_acquire);
+        return (state & ~exclusive_ref_flag) + ((state & exclusive_ref_flag) != 0 ? 1U : 0U);
+    }
+
+    bool is_exclusively_borrowed() const noexcept
+    {
+        return (ref_count_.load(std::memory_order_acquire) & exclusive_ref_flag) != 0;
     }
 
     bool is_marked_for_deletion() const noexcept
@@ -390,6 +612,8 @@ public:
     {
         // SPEC: markedForDeletion' = TRUE
         marked_for_deletion_.store(true, std::memory_order_seq_cst);
+        ZOOX_PROBE2(mark, this, ref_count_.load(std::memory_order_relaxed));
+        ZOOX_FLIGHT_RECORD(mark, this, ref_count());
     }
 
     // =========================================================================
@@ -411,18 +635,23 @@ public:
         // SPEC: Precondition markedForDeletion
         if (!marked_for_deletion_.load(std::memory_order_acquire))
         {
+            ZOOX_PROBE3(delete, this, 0, ref_owner_delete_outcome::not_marked);
             return false;
         }
 
         // SPEC: Precondition ~deleted
         if (deleted_.load(std::memory_order_acquire))
         {
+            ZOOX_PROBE3(delete, this, 0, ref_owner_delete_outcome::already_deleted);
             return false;
         }
 
         // SPEC: PROTOCOL refCount = 0 (enforces NoInvalidReference)
-        if (ref_count_.load(std::memory_order_acquire) != 0)
+        const size_t count = ref_count_.load(std::memory_order_acquire);
+        if (count != 0)
         {
+            ZOOX_PROBE3(delete, this, count, ref_owner_delete_outcome::refs_outstanding);
+            ZOOX_FLIGHT_RECORD(delete_blocked, this, ref_count());
             return false;
         }
 
@@ -431,9 +660,12 @@ public:
         if (deleted_.compare_exchange_strong(expected, true, std::memory_order_acq_rel))
         {
             owned_ptr_.reset();
+            ZOOX_PROBE3(delete, this, 0, ref_owner_delete_outcome::deleted);
+            ZOOX_FLIGHT_RECORD(deleted, this, 0);
             return true;
         }
 
+        ZOOX_PROBE3(delete, this, 0, ref_owner_delete_outcome::lost_race);
         return false;
     }
 
@@ -444,10 +676,35 @@ public:
         return delete_if_deleteable();
     }
 
+#ifdef ZOOX_TRACK_HOLDERS
+    // Recorded holders of outstanding references (zoox/holder_tracking.hpp);
+    // ref_count() minus holders().size() references went untracked
+    std::vector<holder_info> holders() const
+    {
+        return holders_.snapshot();
+    }
+
+    // Writes the outstanding count and one line per recorded holder
+    void dump_holders(std::ostream& out) const
+    {
+        detail::write_holders(out, this, ref_count(), holders_.snapshot());
+    }
+#endif
+
 protected:
     template <typename RefType, typename BaseType, template <typename> class Opt, typename Del>
     friend class unique_reference;
     friend class waitable_ref_owner<T, OptionalT, Deleter>;
+    friend class exclusive_reference<T, OptionalT, Deleter>;
+    friend class weak_observer<T, OptionalT, Deleter>;
+    template <typename RefType, typename BaseType, template <typename> class Opt, typename Del>
+    friend class atomic_reference;
+
+    template <typename U, template <typename> class Opt, typename Del>
+    friend Opt<exclusive_reference<U, Opt, Del>> try_upgrade_reference(unique_reference<U, U, Opt, Del>&& ref) noexcept;
+
+    template <typename U, template <typename> class Opt, typename Del>
+    friend unique_reference<U, U, Opt, Del> downgrade_reference(exclusive_reference<U, Opt, Del>&& ref) noexcept;
 
     // =========================================================================
     // TLA+ SPEC: TryMakeRefSuccess(c) / TryMakeRefFail(c)
@@ -469,16 +726,43 @@ protected:
     bool try_register_ref() noexcept
     {
         // SPEC: refCount' = refCount + 1 (optimistic increment FIRST)
-        ref_count_.fetch_add(1, std::memory_order_seq_cst);
+        const size_t prev = ref_count_.fetch_add(1, std::memory_order_seq_cst);
 
         // SPEC: Check ~markedForDeletion (if true -> TryMakeRefFail)
-        if (marked_for_deletion_.load(std::memory_order_seq_cst))
+        // An exclusive borrow fails the same way, using the value we already loaded
+        if ((prev & exclusive_ref_flag) != 0 || marked_for_deletion_.load(std::memory_order_seq_cst))
         {
             // SPEC: TryMakeRefFail - rollback, UNCHANGED vars
-            ref_count_.fetch_sub(1, std::memory_order_seq_cst);
+            ZOOX_PROBE3(ref_register, this, prev, false);
+            ZOOX_FLIGHT_RECORD(ref_register_failed, this, prev & ~exclusive_ref_flag);
+            on_registration_rolled_back(1);
             return false;
         }
         // SPEC: TryMakeRefSuccess - ref registered
+        ZOOX_PROBE3(ref_register, this, prev, true);
+        ZOOX_FLIGHT_RECORD(ref_register, this, prev);
+        return true;
+    }
+
+    // Batched form of try_register_ref(): one increment registers count refs.
+    // Equivalent to count TryMakeRefSuccess steps taken atomically, or to
+    // count TryMakeRefFail steps when rolled back.
+    bool try_register_refs(size_t count) noexcept
+    {
+        const size_t prev = ref_count_.fetch_add(count, std::memory_order_seq_cst);
+        if ((prev & exclusive_ref_flag) != 0 || marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            ZOOX_PROBE3(refs_register, this, count, false);
+            on_registration_rolled_back(count);
+            return false;
+        }
+        ZOOX_PROBE3(refs_register, this, count, true);
+#ifdef ZOOX_ENABLE_FLIGHT_RECORDER
+        for (size_t i = 0; i < count; ++i)
+        {
+            ZOOX_FLIGHT_RECORD(ref_register, this, prev + i);
+        }
+#endif
         return true;
     }
 
@@ -495,7 +779,86 @@ protected:
     virtual void on_ref_released() noexcept
     {
         // SPEC: refCount' = refCount - 1
-        ref_count_.fetch_sub(1, std::memory_order_seq_cst);
+        trace_ref_released(ref_count_.fetch_sub(1, std::memory_order_seq_cst));
+    }
+
+    // Undoes a failed registration's optimistic increment of amount (a count
+    // of shared references, or exclusive_ref_flag). Not a release: nothing was
+    // handed out, so no ref_release probe fires and nothing is recorded beyond
+    // the failed registration. If the owner was marked while the increment
+    // was visible this may still be the decrement that drains it, so derived
+    // owners that act on draining override this alongside on_ref_released().
+    virtual void on_registration_rolled_back(size_t amount) noexcept
+    {
+        ref_count_.fetch_sub(amount, std::memory_order_seq_cst);
+    }
+
+    // Reports a release to the probes and the flight recorder; derived owners
+    // that override on_ref_released() or on_exclusive_ref_released() call it
+    // with the pre-decrement count
+    void trace_ref_released(size_t prev) const noexcept
+    {
+        ZOOX_PROBE2(ref_release, this, prev);
+        ZOOX_FLIGHT_RECORD(ref_release, this, prev & ~exclusive_ref_flag);
+        static_cast<void>(prev);
+    }
+
+    // Exclusive registration: only succeeds from refCount = 0, then applies
+    // the same marked check + rollback as try_register_ref()
+    bool try_register_exclusive_ref() noexcept
+    {
+        size_t expected = 0;
+        if (!ref_count_.compare_exchange_strong(expected, exclusive_ref_flag, std::memory_order_seq_cst))
+        {
+            ZOOX_PROBE3(ref_register, this, expected, false);
+            ZOOX_FLIGHT_RECORD(ref_register_failed, this, expected & ~exclusive_ref_flag);
+            return false;
+        }
+        if (marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            ZOOX_PROBE3(ref_register, this, 0, false);
+            ZOOX_FLIGHT_RECORD(ref_register_failed, this, 0);
+            on_registration_rolled_back(exclusive_ref_flag);
+            return false;
+        }
+        ZOOX_PROBE3(ref_register, this, 0, true);
+        ZOOX_FLIGHT_RECORD(ref_register, this, 0);
+        return true;
+    }
+
+    // Converts the caller's single shared reference into the exclusive flag.
+    // Fails if any other reference (or in-flight registration) exists.
+    bool try_upgrade_registered_ref() noexcept
+    {
+        size_t expected = 1;
+        return ref_count_.compare_exchange_strong(expected, exclusive_ref_flag, std::memory_order_seq_cst);
+    }
+
+    // Converts the exclusive flag back into one shared reference. Uses
+    // arithmetic rather than a store so in-flight rollbacks are preserved.
+    void downgrade_registered_ref() noexcept
+    {
+        ref_count_.fetch_sub(exclusive_ref_flag - 1, std::memory_order_seq_cst);
+    }
+
+    // Called by exclusive_reference destructor
+    virtual void on_exclusive_ref_released() noexcept
+    {
+        trace_ref_released(ref_count_.fetch_sub(exclusive_ref_flag, std::memory_order_seq_cst));
+    }
+
+    // Returns a deleted owner to the initial (unmarked) state managing ptr,
+    // for storage that is reused (pool slots). Generation changes first and
+    // the marked flag clears last, so a stale weak_observer that registers
+    // against the new state always sees the new generation and backs off.
+    // PRECONDITION: is_deleted() and no unique_reference to this owner exists
+    void rearm(T* ptr) noexcept
+    {
+        assert(deleted_.load(std::memory_order_acquire) && "rearm() requires a deleted ref_owner");
+        owned_ptr_.reset(ptr);
+        generation_.store(detail::next_owner_generation(), std::memory_order_release);
+        deleted_.store(false, std::memory_order_release);
+        marked_for_deletion_.store(false, std::memory_order_seq_cst);
     }
 
     std::unique_ptr<T, Deleter> owned_ptr_;
@@ -505,6 +868,12 @@ protected:
     std::atomic<bool> marked_for_deletion_{false};
     // TLA+ SPEC VARIABLE: deleted (Bool)
     std::atomic<bool> deleted_{false};
+    // Identity of this owner for weak_observer (not part of the TLA+ spec)
+    std::atomic<std::uint64_t> generation_;
+#ifdef ZOOX_TRACK_HOLDERS
+    // Who holds the outstanding references (not part of the TLA+ spec)
+    detail::holder_list holders_;
+#endif
 };
 
 // =============================================================================
@@ -541,8 +910,11 @@ public:
 
     // Internal construction - ref already registered by make_ref()
     // SPEC: Called after TryMakeRefSuccess, clientRefs[c] already incremented
-    unique_reference(ref_owner<BaseType, OptionalT, Deleter>& owner, already_registered)
+    unique_reference(ref_owner<BaseType, OptionalT, Deleter>& owner, already_registered ZOOX_HOLDER_SITE_NEXT)
         : owner_(&owner)
+#ifdef ZOOX_TRACK_HOLDERS
+        , holder_(owner.holders_.claim(site))
+#endif
     {
     }
 
@@ -551,6 +923,9 @@ public:
     {
         if (owner_)
         {
+#ifdef ZOOX_TRACK_HOLDERS
+            owner_->holders_.release(holder_);
+#endif
             // SPEC: ReleaseRef - on_ref_released() decrements refCount
             owner_->on_ref_released();
         }
@@ -563,6 +938,9 @@ public:
     // Move-constructible (transfers ownership, source won't decrement ref count)
     unique_reference(unique_reference&& other) noexcept
         : owner_(other.owner_)
+#ifdef ZOOX_TRACK_HOLDERS
+        , holder_(other.holder_)
+#endif
     {
         other.owner_ = nullptr;
     }
@@ -574,6 +952,9 @@ public:
                                           !std::is_same_v<OtherRef, ReferenceType>>>
     unique_reference(unique_reference<OtherRef, BaseType, OptionalT, Deleter>&& other) noexcept
         : owner_(other.owner_)
+#ifdef ZOOX_TRACK_HOLDERS
+        , holder_(other.holder_)
+#endif
     {
         other.owner_ = nullptr;
     }
@@ -623,12 +1004,46 @@ private:
     friend Opt<unique_reference<U, Base, Opt, Del>> dynamic_reference_move(
         unique_reference<RefT, Base, Opt, Del>&& ref) noexcept;
 
+    // Allow atomic_reference to store and rebuild references from owner_
+    friend class atomic_reference<ReferenceType, BaseType, OptionalT, Deleter>;
+
+    // Allow try_upgrade_reference to read and release owner_
+    template <typename U, template <typename> class Opt, typename Del>
+    friend Opt<exclusive_reference<U, Opt, Del>> try_upgrade_reference(unique_reference<U, U, Opt, Del>&& ref) noexcept;
+
     // Private constructor for dynamic_reference_move (bypasses SFINAE)
     explicit unique_reference(ref_owner<BaseType, OptionalT, Deleter>* owner_ptr) noexcept
         : owner_(owner_ptr)
     {
     }
+
+    // Drops the holder record; the reference stays registered but untracked
+    void forget_holder() noexcept
+    {
+#ifdef ZOOX_TRACK_HOLDERS
+        if (owner_ != nullptr)
+        {
+            owner_->holders_.release(holder_);
+            holder_ = detail::no_holder;
+        }
+#endif
+    }
+
+    // Gives up the registration without releasing it, for callers that
+    // carry it on in another form
+    ref_owner<BaseType, OptionalT, Deleter>* detach() noexcept
+    {
+        forget_holder();
+        ref_owner<BaseType, OptionalT, Deleter>* owner = owner_;
+        owner_                                         = nullptr;
+        return owner;
+    }
+
     ref_owner<BaseType, OptionalT, Deleter>* owner_;
+#ifdef ZOOX_TRACK_HOLDERS
+    // Slot in owner_->holders_, or detail::no_holder if untracked
+    std::uint32_t holder_ = detail::no_holder;
+#endif
 };
 
 // =============================================================================
@@ -669,10 +1084,182 @@ OptionalT<unique_reference<U, Base, OptionalT, Deleter>> dynamic_reference_move(
     }
     // Use private constructor and transfer ownership
     unique_reference<U, Base, OptionalT, Deleter> result(ref.owner_);
+#ifdef ZOOX_TRACK_HOLDERS
+    result.holder_ = ref.holder_;
+#endif
     ref.owner_ = nullptr;
     return result;
 }
 
+// =============================================================================
+// exclusive_reference - Mutable borrow that excludes all other references
+// =============================================================================
+//
+// Created by ref_owner::try_make_exclusive_ref() or try_upgrade_reference().
+// Holds the exclusive_ref_flag bit of the owner's ref_count_, so for as long
+// as it exists no unique_reference can be created and the owner cannot
+// delete the object. Move-only, like unique_reference.
+//
+template <typename T, template <typename> class OptionalT, typename Deleter>
+class exclusive_reference
+{
+public:
+    using type = T;
+
+    ~exclusive_reference() noexcept
+    {
+        if (owner_)
+        {
+            owner_->on_exclusive_ref_released();
+        }
+    }
+
+    // Non-copyable (unique ownership)
+    exclusive_reference(const exclusive_reference&)            = delete;
+    exclusive_reference& operator=(const exclusive_reference&) = delete;
+
+    // Move-constructible (transfers the exclusive flag)
+    exclusive_reference(exclusive_reference&& other) noexcept
+        : owner_(other.owner_)
+    {
+        other.owner_ = nullptr;
+    }
+
+    // Non-move-assignable (keep it simple)
+    exclusive_reference& operator=(exclusive_reference&&) = delete;
+
+    T& get() const noexcept
+    {
+        return *owner_->get();
+    }
+
+    operator T&() const noexcept
+    {
+        return get();
+    }
+
+    T& operator*() const noexcept
+    {
+        return get();
+    }
+
+    T* operator->() const noexcept
+    {
+        return &get();
+    }
+
+private:
+    friend class ref_owner<T, OptionalT, Deleter>;
+
+    template <typename U, template <typename> class Opt, typename Del>
+    friend Opt<exclusive_reference<U, Opt, Del>> try_upgrade_reference(unique_reference<U, U, Opt, Del>&& ref) noexcept;
+
+    template <typename U, template <typename> class Opt, typename Del>
+    friend unique_reference<U, U, Opt, Del> downgrade_reference(exclusive_reference<U, Opt, Del>&& ref) noexcept;
+
+    // Exclusive flag already set by the owner
+    explicit exclusive_reference(ref_owner<T, OptionalT, Deleter>* owner_ptr) noexcept
+        : owner_(owner_ptr)
+    {
+    }
+
+    ref_owner<T, OptionalT, Deleter>* owner_;
+};
+
+// Upgrade a shared reference to an exclusive one - runtime-checked
+// Succeeds only when ref is the owner's single outstanding reference.
+// On failure, the source reference remains valid (not moved-from)
+template <typename T, template <typename> class OptionalT, typename Deleter>
+OptionalT<exclusive_reference<T, OptionalT, Deleter>> try_upgrade_reference(
+    unique_reference<T, T, OptionalT, Deleter>&& ref) noexcept
+{
+    if (!ref.owner_->try_upgrade_registered_ref())
+    {
+        return {};
+    }
+    exclusive_reference<T, OptionalT, Deleter> result(ref.detach());
+    return result;
+}
+
+// Downgrade an exclusive reference to a shared one - always succeeds
+// Other borrowers may register as soon as this returns.
+template <typename T, template <typename> class OptionalT, typename Deleter>
+unique_reference<T, T, OptionalT, Deleter> downgrade_reference(exclusive_reference<T, OptionalT, Deleter>&& ref) noexcept
+{
+    ref_owner<T, OptionalT, Deleter>* owner = ref.owner_;
+    ref.owner_                              = nullptr;
+    owner->downgrade_registered_ref();
+    typename unique_reference<T, T, OptionalT, Deleter>::already_registered tag;
+    return unique_reference<T, T, OptionalT, Deleter>(*owner, tag);
+}
+
+// =============================================================================
+// weak_observer - Non-counting handle to a ref_owner
+// =============================================================================
+//
+// Stores the owner's address and generation only; ref_count_ is not touched
+// until try_upgrade() is called. Upgrading uses the same optimistic
+// increment + check + rollback as try_make_ref(), plus a generation check
+// after registration, so it fails once the owner is marked, deleted, moved
+// from, or rearmed for a new object.
+//
+// PROTOCOL: The observed ref_owner object itself (not just its storage) must
+// stay alive for as long as the observer may call try_upgrade() or
+// expired(). Reuse is only safe through rearm(), which keeps the atomics
+// live; ending the owner's lifetime and constructing a new one in place
+// races with an upgrade's increment and rollback.
+//
+template <typename T, template <typename> class OptionalT, typename Deleter>
+class weak_observer
+{
+public:
+    using owner_type = ref_owner<T, OptionalT, Deleter>;
+
+    // Empty observer - try_upgrade() always fails
+    weak_observer() noexcept = default;
+
+    explicit weak_observer(owner_type& owner) noexcept
+        : owner_(&owner)
+        , generation_(owner.generation_.load(std::memory_order_acquire))
+    {
+    }
+
+    // Registers a reference if the observed owner is still live
+    OptionalT<unique_reference<T, T, OptionalT, Deleter>> try_upgrade() const noexcept
+    {
+        if (owner_ == nullptr || !owner_->try_register_ref())
+        {
+            return {};
+        }
+        if (owner_->generation_.load(std::memory_order_acquire) != generation_)
+        {
+            // Registered against a different owner living in the same storage
+            owner_->on_ref_released();
+            return {};
+        }
+        typename unique_reference<T, T, OptionalT, Deleter>::already_registered tag;
+        return OptionalT<unique_reference<T, T, OptionalT, Deleter>>(
+            unique_reference<T, T, OptionalT, Deleter>(*owner_, tag));
+    }
+
+    // Best-effort check: true once try_upgrade() can no longer succeed
+    bool expired() const noexcept
+    {
+        return owner_ == nullptr || owner_->generation_.load(std::memory_order_acquire) != generation_ ||
+               owner_->is_marked_for_deletion();
+    }
+
+    void reset() noexcept
+    {
+        owner_      = nullptr;
+        generation_ = 0;
+    }
+
+private:
+    owner_type*   owner_{nullptr};
+    std::uint64_t generation_{0};
+};
+
 // =============================================================================
 // waitable_ref_owner - Wrapper adding efficient blocking wait
 // =============================================================================
@@ -714,6 +1301,8 @@ public:
     void mark_and_wait_for_deletion()
     {
         base::mark_for_deletion();
+        ZOOX_PROBE2(wait_begin, this, base::ref_count_.load(std::memory_order_relaxed));
+        ZOOX_FLIGHT_RECORD(wait_begin, this, base::ref_count());
 
         std::unique_lock<std::mutex> lock(wait_mutex_);
         wait_cv_.wait(lock, [this]() { return base::ref_count_.load(std::memory_order_acquire) == 0; });
@@ -721,6 +1310,8 @@ public:
         // All refs released, delete the object
         base::owned_ptr_.reset();
         base::deleted_.store(true, std::memory_order_release);
+        ZOOX_PROBE2(wait_end, this, true);
+        ZOOX_FLIGHT_RECORD(wait_end, this, 1);
     }
 
     // Wait with timeout for all refs to be released
@@ -728,6 +1319,8 @@ public:
     bool mark_and_wait_for_deletion(std::chrono::milliseconds timeout)
     {
         base::mark_for_deletion();
+        ZOOX_PROBE2(wait_begin, this, base::ref_count_.load(std::memory_order_relaxed));
+        ZOOX_FLIGHT_RECORD(wait_begin, this, base::ref_count());
 
         std::unique_lock<std::mutex> lock(wait_mutex_);
         bool                         completed = wait_cv_.wait_for(lock, timeout, [this]() {
@@ -739,6 +1332,8 @@ public:
             base::owned_ptr_.reset();
             base::deleted_.store(true, std::memory_order_release);
         }
+        ZOOX_PROBE2(wait_end, this, completed);
+        ZOOX_FLIGHT_RECORD(wait_end, this, completed ? 1 : 0);
         return completed;
     }
 
@@ -747,6 +1342,8 @@ public:
     bool mark_and_wait_until_deletion(std::chrono::time_point<Clock, Duration> deadline)
     {
         base::mark_for_deletion();
+        ZOOX_PROBE2(wait_begin, this, base::ref_count_.load(std::memory_order_relaxed));
+        ZOOX_FLIGHT_RECORD(wait_begin, this, base::ref_count());
 
         std::unique_lock<std::mutex> lock(wait_mutex_);
         bool                         completed = wait_cv_.wait_until(lock, deadline, [this]() {
@@ -758,6 +1355,8 @@ public:
             base::owned_ptr_.reset();
             base::deleted_.store(true, std::memory_order_release);
         }
+        ZOOX_PROBE2(wait_end, this, completed);
+        ZOOX_FLIGHT_RECORD(wait_end, this, completed ? 1 : 0);
         return completed;
     }
 
@@ -765,18 +1364,36 @@ protected:
     // Override to notify waiters when ref count changes
     void on_ref_released() noexcept override
     {
-        size_t prev = base::ref_count_.fetch_sub(1, std::memory_order_seq_cst);
+        const size_t prev = base::ref_count_.fetch_sub(1, std::memory_order_seq_cst);
+        base::trace_ref_released(prev);
+        notify_if_drained(prev, 1);
+    }
+
+    void on_exclusive_ref_released() noexcept override
+    {
+        const size_t prev = base::ref_count_.fetch_sub(base::exclusive_ref_flag, std::memory_order_seq_cst);
+        base::trace_ref_released(prev);
+        notify_if_drained(prev, base::exclusive_ref_flag);
+    }
+
+    void on_registration_rolled_back(size_t amount) noexcept override
+    {
+        notify_if_drained(base::ref_count_.fetch_sub(amount, std::memory_order_seq_cst), amount);
+    }
 
+private:
+    void notify_if_drained(size_t prev, size_t released) noexcept
+    {
         // If this was the last ref and we're marked for deletion, notify waiters
-        if (prev == 1 && base::marked_for_deletion_.load(std::memory_order_acquire))
+        if (prev == released && base::marked_for_deletion_.load(std::memory_order_acquire))
         {
             // Lock to synchronize with wait_cv_.wait()
             std::lock_guard<std::mutex> lock(wait_mutex_);
+            ZOOX_PROBE1(notify, this);
             wait_cv_.notify_all();
         }
     }
 
-private:
     std::mutex              wait_mutex_;
     std::condition_variable wait_cv_;
 };
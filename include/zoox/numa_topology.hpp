@@ -0,0 +1,232 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Minimal NUMA topology queries and node-local allocation
+ */
+#ifndef ZOOX_NUMA_TOPOLOGY_H
+#define ZOOX_NUMA_TOPOLOGY_H
+
+// =============================================================================
+// zoox::numa - Just enough NUMA support for node-local ref_owner storage
+// =============================================================================
+//
+// Uses sysfs, sched_getcpu() and a raw mbind syscall so that no libnuma
+// dependency is needed. On non-Linux targets, or hosts with a single memory
+// node, every query degrades to "one node, node 0". Allocations are whole
+// anonymous mappings on Linux and plain aligned allocations elsewhere.
+//
+// =============================================================================
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#ifdef __linux__
+#    include <sched.h>
+#    include <sys/mman.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+namespace zoox
+{
+namespace numa
+{
+
+// Upper bound on nodes tracked by the mbind node mask
+constexpr std::size_t max_nodes = 64;
+
+namespace detail
+{
+// Values from <numaif.h>, spelled out to avoid a libnuma header dependency
+constexpr int           mpol_bind     = 2;
+constexpr unsigned long mpol_mf_move  = 1UL << 1U;
+constexpr std::size_t   fallback_page = 4096;
+
+// Parses a sysfs cpulist/nodelist such as "0", "0-1" or "0,2-3" and calls
+// range(first, last) for each entry. Returns false if the file is missing.
+template <typename Range>
+bool parse_list(const char* path, Range&& range) noexcept
+{
+    std::FILE* file = std::fopen(path, "r");  // NOLINT: sysfs read
+    if (file == nullptr)
+    {
+        return false;
+    }
+    unsigned long first = 0;
+    unsigned long last  = 0;
+    int           sep   = 0;
+    while (std::fscanf(file, "%lu", &first) == 1)  // NOLINT: sysfs format is fixed
+    {
+        last = first;
+        sep  = std::fgetc(file);
+        if (sep == '-')
+        {
+            if (std::fscanf(file, "%lu", &last) != 1)  // NOLINT
+            {
+                break;
+            }
+            sep = std::fgetc(file);
+        }
+        range(first, last);
+        if (sep != ',')
+        {
+            break;
+        }
+    }
+    std::fclose(file);
+    return true;
+}
+
+// Highest id in a sysfs list + 1, or 1 on any error
+inline std::size_t parse_list_extent(const char* path) noexcept
+{
+    std::size_t extent = 1;
+    parse_list(path,
+               [&extent](unsigned long, unsigned long last)
+               {
+                   if (last + 1 > extent)
+                   {
+                       extent = last + 1;
+                   }
+               });
+    return extent < max_nodes ? extent : max_nodes;
+}
+}  // namespace detail
+
+// Number of NUMA nodes on this host (1 if unknown). Cached after first call.
+inline std::size_t node_count() noexcept
+{
+#ifdef __linux__
+    static const std::size_t count = detail::parse_list_extent("/sys/devices/system/node/online");
+    return count;
+#else
+    return 1;
+#endif
+}
+
+namespace detail
+{
+// CPUs mapped by read_cpu_nodes(); higher ids report node 0
+constexpr std::size_t max_cpus = 4096;
+
+// Node of each CPU, from /sys/devices/system/node/node<N>/cpulist
+inline std::vector<std::uint8_t> read_cpu_nodes()
+{
+    std::vector<std::uint8_t> nodes;
+    char                      path[64];
+    for (std::size_t node = 0; node < node_count(); ++node)
+    {
+        std::snprintf(path, sizeof(path), "/sys/devices/system/node/node%zu/cpulist", node);
+        parse_list(path,
+                   [&nodes, node](unsigned long first, unsigned long last)
+                   {
+                       for (unsigned long cpu = first; cpu <= last && cpu < max_cpus; ++cpu)
+                       {
+                           if (cpu >= nodes.size())
+                           {
+                               nodes.resize(cpu + 1, 0);
+                           }
+                           nodes[cpu] = static_cast<std::uint8_t>(node);
+                       }
+                   });
+    }
+    return nodes;
+}
+}  // namespace detail
+
+// Node of the CPU the calling thread is currently running on (0 if unknown).
+// sched_getcpu() is served by rseq or the vDSO without entering the kernel,
+// and the CPU-to-node table is read from sysfs once.
+inline std::size_t current_node() noexcept
+{
+#ifdef __linux__
+    if (node_count() > 1)
+    {
+        static const std::vector<std::uint8_t> cpu_nodes = detail::read_cpu_nodes();
+        const int                              cpu       = sched_getcpu();
+        if (cpu >= 0 && static_cast<std::size_t>(cpu) < cpu_nodes.size())
+        {
+            return cpu_nodes[static_cast<std::size_t>(cpu)];
+        }
+    }
+#endif
+    return 0;
+}
+
+inline std::size_t page_size() noexcept
+{
+#ifdef __linux__
+    static const std::size_t size = [] {
+        const long value = sysconf(_SC_PAGESIZE);
+        return value > 0 ? static_cast<std::size_t>(value) : detail::fallback_page;
+    }();
+    return size;
+#else
+    return detail::fallback_page;
+#endif
+}
+
+// Best-effort binding of [addr, addr + length) to node. addr must be page
+// aligned. Returns false if the range was left on its default policy.
+inline bool bind_to_node(void* addr, std::size_t length, std::size_t node) noexcept
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    if (node_count() > 1 && node < max_nodes)
+    {
+        const unsigned long mask = 1UL << node;
+        return syscall(SYS_mbind, addr, length, detail::mpol_bind, &mask, max_nodes, detail::mpol_mf_move) == 0;  // NOLINT
+    }
+#else
+    (void) addr;
+    (void) length;
+    (void) node;
+#endif
+    return false;
+}
+
+// Page-aligned allocation bound to node where supported. The pages come
+// straight from mmap so that mbind's policy covers exactly this block and
+// never leaks into memory the heap hands out later. Release with
+// deallocate(memory, size). Returns nullptr on failure.
+inline void* allocate_on_node(std::size_t size, std::size_t node) noexcept
+{
+    const std::size_t page    = page_size();
+    const std::size_t rounded = ((size + page - 1) / page) * page;
+#ifdef __linux__
+    void* memory = mmap(nullptr, rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+    {
+        return nullptr;
+    }
+    bind_to_node(memory, rounded, node);
+    return memory;
+#else
+    (void) node;
+    return std::aligned_alloc(page, rounded);
+#endif
+}
+
+// size must match the allocate_on_node() call that returned memory
+inline void deallocate(void* memory, std::size_t size) noexcept
+{
+#ifdef __linux__
+    if (memory != nullptr)
+    {
+        const std::size_t page = page_size();
+        munmap(memory, ((size + page - 1) / page) * page);
+    }
+#else
+    (void) size;
+    std::free(memory);  // NOLINT: pairs with aligned_alloc
+#endif
+}
+
+}  // namespace numa
+}  // namespace zoox
+
+#endif  // ZOOX_NUMA_TOPOLOGY_H
@@ -0,0 +1,335 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Huge-page, NUMA-local, prefaulted and mlocked memory for owner storage
+ */
+#ifndef ZOOX_PINNED_MEMORY_H
+#define ZOOX_PINNED_MEMORY_H
+
+// =============================================================================
+// zoox::pinned_region / zoox::pinned_memory_source
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Pool and arena storage is touched on every borrow and dereference. If it
+// sits on 4 KiB pages that were never touched, or that were swapped or
+// migrated, a real-time frame pays for TLB misses and page faults at those
+// points. pinned_region maps the storage so that all of that cost is paid
+// once, at construction:
+//
+//   1. Huge pages: mmap(MAP_HUGETLB) with 2 MiB pages. If the hugetlb pool is
+//      empty, map 2 MiB-aligned normal pages and madvise(MADV_HUGEPAGE) so
+//      transparent huge pages can back them.
+//   2. NUMA: mbind the range to the caller's node (or a chosen one) before
+//      any page is touched, so first touch lands on that node.
+//   3. Prefault: write every page so the kernel allocates it now.
+//   4. mlock: keep the pages resident. This needs RLIMIT_MEMLOCK headroom
+//      or CAP_IPC_LOCK; without it the region is still usable, just not
+//      locked.
+//
+// Every step is best effort and reported by the accessors, so a host without
+// huge pages or lock permission still gets working (ordinary) memory. On
+// non-Linux targets the region is a plain aligned allocation.
+//
+// USAGE
+// -----
+//
+//   // Pools: pass the source as the MemorySource template argument
+//   zoox::ref_owner_pool<Msg, 1024, std::optional, 8, zoox::pinned_memory_source> pool;
+//
+//   // Arena
+//   zoox::frame_arena<std::optional, zoox::pinned_memory_source> arena(8 << 20);
+//
+//   // Or map a region yourself and hand the arena the buffer
+//   zoox::pinned_region region(8 << 20);
+//   zoox::frame_arena<> arena(region.data(), region.size());
+//
+// =============================================================================
+
+#include "zoox/memory_source.hpp"
+#include "zoox/numa_topology.hpp"
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#ifdef __linux__
+#    include <sys/mman.h>
+#endif
+
+namespace zoox
+{
+
+struct pinned_memory_options
+{
+    static constexpr std::size_t local_node = static_cast<std::size_t>(-1);
+
+    // Node to bind to; local_node means the node of the constructing thread
+    std::size_t node       = local_node;
+    bool        huge_pages = true;
+    bool        prefault   = true;
+    bool        lock       = true;
+};
+
+class pinned_region
+{
+public:
+    static constexpr std::size_t huge_page_size = std::size_t{2} << 20U;
+
+    pinned_region() noexcept = default;
+
+    // Maps at least bytes bytes. Check data() or operator bool for failure.
+    explicit pinned_region(std::size_t bytes, pinned_memory_options options = pinned_memory_options()) noexcept
+    {
+        if (bytes == 0)
+        {
+            return;
+        }
+        size_ = bytes;
+#ifdef __linux__
+        if (options.huge_pages)
+        {
+            map_huge(bytes);
+        }
+        if (data_ == nullptr)
+        {
+            map_normal(bytes, options.huge_pages);
+        }
+        if (data_ == nullptr)
+        {
+            size_ = 0;
+            return;
+        }
+
+        // Bind before the first touch so that prefaulting places the pages
+        const std::size_t node = options.node == pinned_memory_options::local_node ? numa::current_node()
+                                                                                    : options.node;
+        node_bound_ = numa::bind_to_node(data_, length_, node);
+
+        if (options.prefault)
+        {
+            prefault();
+        }
+        if (options.lock)
+        {
+            locked_ = mlock(data_, length_) == 0;
+        }
+#else
+        (void) options;
+        length_ = ((bytes + numa::page_size() - 1) / numa::page_size()) * numa::page_size();
+        data_   = std::aligned_alloc(numa::page_size(), length_);
+        if (data_ == nullptr)
+        {
+            size_ = 0;
+        }
+#endif
+    }
+
+    ~pinned_region()
+    {
+        unmap();
+    }
+
+    pinned_region(const pinned_region&)            = delete;
+    pinned_region& operator=(const pinned_region&) = delete;
+
+    pinned_region(pinned_region&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , length_(std::exchange(other.length_, 0))
+        , huge_pages_(other.huge_pages_)
+        , node_bound_(other.node_bound_)
+        , locked_(other.locked_)
+    {
+    }
+
+    pinned_region& operator=(pinned_region&& other) noexcept
+    {
+        if (this != &other)
+        {
+            unmap();
+            data_       = std::exchange(other.data_, nullptr);
+            size_       = std::exchange(other.size_, 0);
+            length_     = std::exchange(other.length_, 0);
+            huge_pages_ = other.huge_pages_;
+            node_bound_ = other.node_bound_;
+            locked_     = other.locked_;
+        }
+        return *this;
+    }
+
+    void* data() const noexcept
+    {
+        return data_;
+    }
+
+    // Requested size; the mapping may be larger (see mapped_size())
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    std::size_t mapped_size() const noexcept
+    {
+        return length_;
+    }
+
+    // True if backed by hugetlb pages (transparent huge pages are a hint only
+    // and are not reported)
+    bool huge_pages() const noexcept
+    {
+        return huge_pages_;
+    }
+
+    bool node_bound() const noexcept
+    {
+        return node_bound_;
+    }
+
+    bool locked() const noexcept
+    {
+        return locked_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return data_ != nullptr;
+    }
+
+private:
+#ifdef __linux__
+    static std::size_t round_up(std::size_t value, std::size_t multiple) noexcept
+    {
+        return ((value + multiple - 1) / multiple) * multiple;
+    }
+
+    void map_huge(std::size_t bytes) noexcept
+    {
+#    ifdef MAP_HUGETLB
+        const std::size_t length = round_up(bytes, huge_page_size);
+        void* memory = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (memory != MAP_FAILED)
+        {
+            data_       = memory;
+            length_     = length;
+            huge_pages_ = true;
+        }
+#    else
+        (void) bytes;
+#    endif
+    }
+
+    // Normal pages. With thp_hint, over-map so the range can be trimmed to
+    // 2 MiB alignment, which transparent huge pages need.
+    void map_normal(std::size_t bytes, bool thp_hint) noexcept
+    {
+        const bool        align_huge = thp_hint && bytes >= huge_page_size;
+        const std::size_t length     = round_up(bytes, align_huge ? huge_page_size : numa::page_size());
+        const std::size_t extra      = align_huge ? huge_page_size : 0;
+        void* memory = mmap(nullptr, length + extra, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED)
+        {
+            return;
+        }
+        auto* begin = static_cast<unsigned char*>(memory);
+        if (align_huge)
+        {
+            const auto address = reinterpret_cast<std::uintptr_t>(begin);  // NOLINT: alignment math
+            auto* aligned = begin + (round_up(address, huge_page_size) - address);
+            if (aligned != begin)
+            {
+                munmap(begin, static_cast<std::size_t>(aligned - begin));
+            }
+            const std::size_t tail = static_cast<std::size_t>((begin + length + extra) - (aligned + length));
+            if (tail != 0)
+            {
+                munmap(aligned + length, tail);
+            }
+            begin = aligned;
+#    ifdef MADV_HUGEPAGE
+            madvise(begin, length, MADV_HUGEPAGE);
+#    endif
+        }
+        data_   = begin;
+        length_ = length;
+    }
+
+    void prefault() noexcept
+    {
+        const std::size_t stride = huge_pages_ ? huge_page_size : numa::page_size();
+        auto*             bytes  = static_cast<volatile unsigned char*>(data_);
+        for (std::size_t offset = 0; offset < length_; offset += stride)
+        {
+            bytes[offset] = 0;
+        }
+    }
+#endif
+
+    void unmap() noexcept
+    {
+        if (data_ == nullptr)
+        {
+            return;
+        }
+#ifdef __linux__
+        // munmap also drops the lock
+        munmap(data_, length_);
+#else
+        std::free(data_);  // NOLINT: pairs with aligned_alloc
+#endif
+        data_ = nullptr;
+    }
+
+    void*       data_       = nullptr;
+    std::size_t size_       = 0;
+    std::size_t length_     = 0;
+    bool        huge_pages_ = false;
+    bool        node_bound_ = false;
+    bool        locked_     = false;
+};
+
+// Memory source (see zoox/memory_source.hpp) backed by one pinned_region.
+// Pools and arenas allocate exactly once, so the source owns at most one
+// region at a time.
+class pinned_memory_source
+{
+public:
+    explicit pinned_memory_source(pinned_memory_options options = pinned_memory_options()) noexcept
+        : options_(options)
+    {
+    }
+
+    void* allocate(std::size_t bytes, std::size_t alignment) noexcept
+    {
+        assert(!region_ && "pinned_memory_source serves one allocation");
+        assert(alignment <= numa::page_size());
+        (void) alignment;
+        region_ = pinned_region(bytes, options_);
+        return region_.data();
+    }
+
+    void deallocate(void* p, std::size_t /*bytes*/, std::size_t /*alignment*/) noexcept
+    {
+        assert(p == region_.data());
+        (void) p;
+        region_ = pinned_region();
+    }
+
+    // The region currently handed out, for reporting huge page/lock status
+    const pinned_region& region() const noexcept
+    {
+        return region_;
+    }
+
+private:
+    pinned_memory_options options_;
+    pinned_region         region_;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_PINNED_MEMORY_H
@@ -0,0 +1,99 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Two-parity reader epoch for deferring node frees past lock-free readers
+ */
+#ifndef ZOOX_READER_EPOCH_H
+#define ZOOX_READER_EPOCH_H
+
+// =============================================================================
+// zoox::detail::reader_epoch - Grace periods for lock-free traversals
+// =============================================================================
+//
+// Containers whose readers walk links without locking (ref_owner_map,
+// ref_owner_skip_list) cannot free an unlinked node while a reader may have
+// loaded a pointer to it. A ref_owner borrow protects a node once it is
+// registered, but not the load that precedes the registration.
+//
+// Readers hold a section for the duration of each walk: the section counts
+// the reader in one of two counters, selected by the parity of the epoch.
+// Writers (externally serialized) record the epoch when they retire a node
+// and free it once the epoch has advanced by two. advance() only moves the
+// epoch from E to E + 1 when the counter of parity E + 1 is zero, so both
+// parities have been seen empty after the unlink, and every reader that
+// could have seen the node has left. Readers entering later cannot reach it.
+//
+// The unlink must be a seq_cst store, and the reader's link loads seq_cst,
+// so that both are ordered with the counter and epoch operations.
+//
+// =============================================================================
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace zoox
+{
+namespace detail
+{
+
+class reader_epoch
+{
+public:
+    // Registers a reader for the current parity; never blocks
+    class section
+    {
+    public:
+        explicit section(reader_epoch& epoch) noexcept
+            : counter_(&epoch.readers_[epoch.epoch_.load(std::memory_order_seq_cst) & 1U])
+        {
+            counter_->fetch_add(1, std::memory_order_seq_cst);
+        }
+
+        ~section()
+        {
+            counter_->fetch_sub(1, std::memory_order_release);
+        }
+
+        section(const section&)            = delete;
+        section& operator=(const section&) = delete;
+
+    private:
+        std::atomic<std::size_t>* counter_;
+    };
+
+    // Epoch to record with a node retired after its unlink
+    std::uint64_t current() const noexcept
+    {
+        return epoch_.load(std::memory_order_seq_cst);
+    }
+
+    // Writer side: moves the epoch on while the other parity has no readers
+    // (at most two steps) and returns the resulting epoch
+    std::uint64_t advance() noexcept
+    {
+        std::uint64_t epoch = epoch_.load(std::memory_order_relaxed);
+        for (int step = 0; step < 2 && readers_[(epoch + 1) & 1U].load(std::memory_order_seq_cst) == 0; ++step)
+        {
+            epoch_.store(++epoch, std::memory_order_seq_cst);
+        }
+        return epoch;
+    }
+
+    // True once no reader can still hold a node retired at retired_epoch
+    static bool grace_elapsed(std::uint64_t retired_epoch, std::uint64_t epoch) noexcept
+    {
+        return epoch >= retired_epoch + 2;
+    }
+
+private:
+    std::atomic<std::uint64_t> epoch_{0};
+    std::atomic<std::size_t>   readers_[2] = {{0}, {0}};
+};
+
+}  // namespace detail
+}  // namespace zoox
+
+#endif  // ZOOX_READER_EPOCH_H
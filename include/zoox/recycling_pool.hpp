@@ -0,0 +1,249 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Pool of ref_owner-managed objects that are recycled instead of destroyed
+ */
+#ifndef ZOOX_RECYCLING_POOL_H
+#define ZOOX_RECYCLING_POOL_H
+
+// =============================================================================
+// zoox::recycling_pool - Reset pooled objects instead of destroying them
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Some messages (point clouds, image buffers) are expensive to construct and
+// destroy but cheap to reset. recycling_pool constructs Capacity objects up
+// front and never destroys them while the pool lives. The ref_owner deletion
+// step calls a recycler instead of the destructor, which keeps allocations
+// and reserved capacity, and then returns the slot. The next acquire() hands
+// out the same object with its ref_owner rearmed.
+//
+// The recycler is any callable taking T&. The default, call_recycle, calls
+// recycle(T&) found by argument-dependent lookup:
+//
+//   namespace perception {
+//   struct PointCloud {
+//       explicit PointCloud(std::size_t n) { points.reserve(n); }
+//       std::vector<Point> points;
+//   };
+//   inline void recycle(PointCloud& cloud) { cloud.points.clear(); }
+//   }
+//
+//   // Every cloud constructed once, with its vector reserved
+//   zoox::recycling_pool<perception::PointCloud, 8> clouds(zoox::call_recycle{}, max_points);
+//
+//   auto* owner = clouds.acquire();        // nullptr if every slot is in use
+//   owner->get()->points.push_back(p);
+//   publish(owner->make_ref());
+//   // ...
+//   owner->mark_and_delete_if_ready();     // recycle(cloud), slot returned
+//
+// The recycler runs inside delete_if_deleteable(), which is noexcept; it must
+// not throw.
+//
+// As with ref_owner_pool, MemorySource selects where the slots live; pass
+// the source with the std::allocator_arg constructor:
+//
+//   zoox::recycling_pool<Cloud, 8, zoox::call_recycle, std::optional, 8, zoox::pinned_memory_source>
+//       clouds(std::allocator_arg, zoox::pinned_memory_source(), zoox::call_recycle{}, max_points);
+//
+// =============================================================================
+
+#include "zoox/ref_owner_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace zoox
+{
+
+// Default recycler: calls recycle(T&) found by argument-dependent lookup
+struct call_recycle
+{
+    template <typename T>
+    void operator()(T& object) const noexcept(noexcept(recycle(object)))
+    {
+        recycle(object);
+    }
+};
+
+template <typename T,
+          std::size_t Capacity,
+          typename Recycler                   = call_recycle,
+          template <typename> class OptionalT = std::optional,
+          std::size_t ThreadCacheSize         = 8,
+          typename MemorySource               = inline_memory>
+class recycling_pool
+{
+    using free_list = detail::slot_free_list<Capacity, ThreadCacheSize>;
+
+public:
+    // Recycles the object in place and returns its slot to the pool
+    class recycle_deleter
+    {
+    public:
+        recycle_deleter(recycling_pool* pool, std::uint32_t index) noexcept
+            : pool_(pool)
+            , index_(index)
+        {
+        }
+
+        void operator()(T* p) const noexcept
+        {
+            // Copy out first: the slot (and this deleter) may be rearmed as
+            // soon as it is released
+            recycling_pool* const pool  = pool_;
+            const std::uint32_t   index = index_;
+            pool->recycler_(*p);
+            pool->free_list_.release(index);
+        }
+
+    private:
+        recycling_pool* pool_;
+        std::uint32_t   index_;
+    };
+
+    using owner_type = ref_owner<T, OptionalT, recycle_deleter>;
+    using reference  = unique_reference<T, T, OptionalT, recycle_deleter>;
+
+    recycling_pool()
+        : recycling_pool(Recycler())
+    {
+    }
+
+    // Constructs every object as T(args...). Each argument is passed as an
+    // lvalue once per slot.
+    template <typename... Args>
+    explicit recycling_pool(Recycler recycler, const Args&... args)
+        : recycling_pool(std::allocator_arg, MemorySource(), std::move(recycler), args...)
+    {
+    }
+
+    // As above, with the slots taken from source
+    template <typename... Args>
+    recycling_pool(std::allocator_arg_t, MemorySource source, Recycler recycler, const Args&... args)
+        : recycler_(std::move(recycler))
+        , slots_(std::move(source))
+    {
+        std::uint32_t constructed = 0;
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            for (; constructed < Capacity; ++constructed)
+            {
+                new (&slots_[constructed]) slot(this, constructed, args...);
+            }
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            destroy_slots(constructed);
+            throw;
+        }
+#endif
+    }
+
+    // Marks every slot and destroys every object; an acquired slot with no
+    // references is recycled first. Slots still referenced follow
+    // ref_owner's destructor policy.
+    ~recycling_pool() noexcept(std::is_nothrow_destructible<owner_type>::value)
+    {
+        destroy_slots(Capacity);
+    }
+
+    // Non-copyable, non-movable (owners and references point into the pool)
+    recycling_pool(const recycling_pool&)            = delete;
+    recycling_pool& operator=(const recycling_pool&) = delete;
+    recycling_pool(recycling_pool&&)                 = delete;
+    recycling_pool& operator=(recycling_pool&&)      = delete;
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+    // The source backing the slots (not available with inline_memory)
+    const MemorySource& memory_source() const noexcept
+    {
+        return slots_.source();
+    }
+
+    // Hands out a previously recycled (or never used) object with a rearmed
+    // owner. Returns nullptr if every slot is in use. No construction or
+    // allocation happens here.
+    owner_type* acquire() noexcept
+    {
+        const std::uint32_t index = free_list_.acquire();
+        if (index == free_list::empty_index)
+        {
+            return nullptr;
+        }
+        slot& s = slots_[index];
+        s.owner.rearm(s.object());
+        return &s.owner;
+    }
+
+private:
+    struct slot
+    {
+        template <typename... Args>
+        slot(recycling_pool* pool, std::uint32_t index, const Args&... args)
+            : owner(nullptr, recycle_deleter(pool, index))
+        {
+            // Slots start in the deleted state so that acquire() can rearm
+            // them (and so a throwing constructor leaves nothing to unwind)
+            owner.mark_and_delete_if_ready();
+            new (storage) T(args...);
+        }
+
+        ~slot() noexcept(std::is_nothrow_destructible<owner_type>::value)
+        {
+            // ref_owner's policy: mark, then delete. Once the owner accepts
+            // (the slot was idle, or is recycled here) the object goes too.
+            if (owner.is_deleted() || owner.mark_and_delete_if_ready())
+            {
+                object()->~T();
+                return;
+            }
+            // Still referenced: the object stays alive for its holders and
+            // the owner's destructor, which runs next, reports the failed
+            // delete (throws in debug builds, asserts without exceptions).
+            // Reporting here as well would throw twice and terminate.
+        }
+
+        slot(const slot&)            = delete;
+        slot& operator=(const slot&) = delete;
+
+        T* object() noexcept
+        {
+            return std::launder(reinterpret_cast<T*>(storage));  // NOLINT: inline storage
+        }
+
+        detail::rearmable_owner<T, OptionalT, recycle_deleter> owner;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    void destroy_slots(std::size_t count) noexcept(std::is_nothrow_destructible<owner_type>::value)
+    {
+        for (std::size_t i = count; i > 0; --i)
+        {
+            slots_[i - 1].~slot();
+        }
+    }
+
+    Recycler                                          recycler_;
+    free_list                                         free_list_;
+    detail::slot_storage<slot, Capacity, MemorySource> slots_;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_RECYCLING_POOL_H
@@ -0,0 +1,316 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Sharded CLOCK cache that never evicts borrowed entries
+ */
+#ifndef ZOOX_REF_OWNER_CACHE_H
+#define ZOOX_REF_OWNER_CACHE_H
+
+// =============================================================================
+// zoox::ref_owner_cache - Evict under pressure, never free what is in use
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Each cached value sits in a fixed slot with its own ref_owner. Lookups
+// return unique_references, so a value handed out is pinned by its
+// reference count and nothing else. Eviction uses CLOCK (second chance):
+//
+//   - A hit sets the slot's referenced bit.
+//   - The clock hand clears referenced bits as it passes and takes the first
+//     slot that is unreferenced and has zero outstanding references. It
+//     marks that slot's owner and deletes the value at once.
+//   - Pinned slots (references outstanding) are skipped, never waited on.
+//     If a full sweep finds only pinned slots, the insert fails instead of
+//     stalling.
+//
+// Keys are split over ShardCount shards, each with its own mutex, index,
+// slots and clock hand, so a hit locks one shard for a hash lookup and one
+// try_make_ref(). There is no global lock.
+//
+// References are created only under the shard mutex and only ever released
+// outside it, so a zero count seen under the mutex stays zero until the
+// mutex is released; eviction never races a new borrow.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::ref_owner_cache<TileId, Tile> tiles(4096);
+//
+//   auto tile = tiles.find(id);                       // OptionalT<reference>
+//   if (!tile) {
+//       tile = tiles.emplace(id, load_tile(id));      // Evicts if full
+//   }
+//   if (tile) { render(**tile); }                     // Pinned while held
+//
+//   tiles.trim(512);                                  // Memory pressure
+//
+// =============================================================================
+
+#include "zoox/ref_owner_pool.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace zoox
+{
+
+template <typename Key,
+          typename V,
+          typename Hash                       = std::hash<Key>,
+          typename KeyEqual                   = std::equal_to<Key>,
+          template <typename> class OptionalT = std::optional,
+          std::size_t ShardCount              = 16>
+class ref_owner_cache
+{
+    static_assert(ShardCount > 0, "ref_owner_cache needs at least one shard");
+
+public:
+    using key_type   = Key;
+    using owner_type = ref_owner<V, OptionalT, destruct_only<V>>;
+    using reference  = unique_reference<V, V, OptionalT, destruct_only<V>>;
+
+    // capacity is split evenly over the shards (rounded up)
+    explicit ref_owner_cache(std::size_t capacity)
+    {
+        const std::size_t per_shard = (capacity + ShardCount - 1) / ShardCount > 0
+                                          ? (capacity + ShardCount - 1) / ShardCount
+                                          : 1;
+        for (auto& s : shards_)
+        {
+            s.slots    = std::make_unique<slot[]>(per_shard);
+            s.capacity = per_shard;
+            s.index.reserve(per_shard);
+        }
+    }
+
+    // Entries still referenced follow ref_owner's destructor policy
+    ~ref_owner_cache() = default;
+
+    // Non-copyable, non-movable (references point into the slots)
+    ref_owner_cache(const ref_owner_cache&)            = delete;
+    ref_owner_cache& operator=(const ref_owner_cache&) = delete;
+    ref_owner_cache(ref_owner_cache&&)                 = delete;
+    ref_owner_cache& operator=(ref_owner_cache&&)      = delete;
+
+    // Returns a reference to the cached value, or empty on a miss
+    OptionalT<reference> find(const Key& key)
+    {
+        const std::size_t           hash = hash_(key);
+        shard&                      s    = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        const auto                  it = s.index.find(key);
+        if (it == s.index.end())
+        {
+            return OptionalT<reference>();
+        }
+        slot& entry      = s.slots[it->second];
+        entry.referenced = true;
+        return entry.owner.try_make_ref();
+    }
+
+    // Returns the cached value for key, constructing V(args...) on a miss.
+    // Empty only if every slot in the key's shard is pinned.
+    template <typename... Args>
+    OptionalT<reference> emplace(const Key& key, Args&&... args)
+    {
+        const std::size_t           hash = hash_(key);
+        shard&                      s    = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        const auto                  it = s.index.find(key);
+        if (it != s.index.end())
+        {
+            slot& entry      = s.slots[it->second];
+            entry.referenced = true;
+            return entry.owner.try_make_ref();
+        }
+
+        const std::size_t victim = s.sweep(true);
+        if (victim == shard::no_slot)
+        {
+            return OptionalT<reference>();
+        }
+        slot& entry = s.slots[victim];
+        s.index.emplace(key, static_cast<std::uint32_t>(victim));
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            entry.owner.rearm(new (entry.storage) V(std::forward<Args>(args)...));
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            s.index.erase(key);
+            throw;
+        }
+#endif
+        entry.key.emplace(key);
+        entry.referenced = true;
+        ++s.size;
+        return entry.owner.try_make_ref();
+    }
+
+    // Removes key from the cache. A pinned value stays alive until its
+    // references drain; the slot is reused after that.
+    bool erase(const Key& key)
+    {
+        const std::size_t           hash = hash_(key);
+        shard&                      s    = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.mutex);
+        const auto                  it = s.index.find(key);
+        if (it == s.index.end())
+        {
+            return false;
+        }
+        s.retire(it->second);
+        return true;
+    }
+
+    // Evicts up to count unpinned entries, one shard at a time in turn.
+    // Returns the number evicted.
+    std::size_t trim(std::size_t count)
+    {
+        std::size_t evicted = 0;
+        bool        progress = true;
+        while (evicted < count && progress)
+        {
+            progress = false;
+            for (std::size_t i = 0; i < ShardCount && evicted < count; ++i)
+            {
+                shard&                      s = shards_[i];
+                std::lock_guard<std::mutex> lock(s.mutex);
+                if (s.sweep(false) != shard::no_slot)
+                {
+                    ++evicted;
+                    progress = true;
+                }
+            }
+        }
+        return evicted;
+    }
+
+    // Cached entries (a snapshot under concurrent use)
+    std::size_t size() const
+    {
+        std::size_t total = 0;
+        for (auto& s : shards_)
+        {
+            std::lock_guard<std::mutex> lock(s.mutex);
+            total += s.size;
+        }
+        return total;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return shards_[0].capacity * ShardCount;
+    }
+
+private:
+    struct slot
+    {
+        slot() noexcept
+            : owner(nullptr)
+        {
+            // Slots start deleted so that emplace() can rearm them
+            owner.mark_and_delete_if_ready();
+        }
+
+        ~slot()
+        {
+            owner.mark_and_delete_if_ready();
+        }
+
+        slot(const slot&)            = delete;
+        slot& operator=(const slot&) = delete;
+
+        detail::rearmable_owner<V, OptionalT, destruct_only<V>> owner;
+        std::optional<Key>                                      key;
+        bool                                                    referenced = false;
+        alignas(V) unsigned char storage[sizeof(V)];
+    };
+
+    struct alignas(64) shard
+    {
+        static constexpr std::size_t no_slot = static_cast<std::size_t>(-1);
+
+        // CLOCK sweep, at most two turns of the hand (the first may only
+        // clear referenced bits). Evicts the first unreferenced, unpinned
+        // entry and returns its slot. With take_free_slot, an already free
+        // slot is returned instead, without evicting anything.
+        std::size_t sweep(bool take_free_slot)
+        {
+            for (std::size_t step = 0; step < 2 * capacity; ++step)
+            {
+                const std::size_t i     = hand;
+                slot&             entry = slots[i];
+                hand                    = (hand + 1) % capacity;
+
+                if (!entry.key)
+                {
+                    // Free, or erased while pinned and reusable once drained
+                    entry.owner.delete_if_deleteable();
+                    if (take_free_slot && entry.owner.is_deleted())
+                    {
+                        return i;
+                    }
+                    continue;
+                }
+                if (entry.referenced)
+                {
+                    entry.referenced = false;
+                    continue;
+                }
+                // Pinned entries are skipped without marking them
+                if (!entry.owner.has_outstanding_references() && entry.owner.mark_and_delete_if_ready())
+                {
+                    index.erase(*entry.key);
+                    entry.key.reset();
+                    --size;
+                    return i;
+                }
+            }
+            return no_slot;
+        }
+
+        void retire(std::uint32_t i)
+        {
+            slot& entry = slots[i];
+            index.erase(*entry.key);
+            entry.key.reset();
+            entry.referenced = false;
+            --size;
+            entry.owner.mark_and_delete_if_ready();
+        }
+
+        mutable std::mutex                                     mutex;
+        std::unique_ptr<slot[]>                                slots;
+        std::size_t                                            capacity = 0;
+        std::size_t                                            hand     = 0;
+        std::size_t                                            size     = 0;
+        std::unordered_map<Key, std::uint32_t, Hash, KeyEqual> index;
+    };
+
+    shard& shard_for(std::size_t hash) noexcept
+    {
+        return shards_[hash % ShardCount];
+    }
+
+    Hash                          hash_;
+    std::array<shard, ShardCount> shards_;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_REF_OWNER_CACHE_H
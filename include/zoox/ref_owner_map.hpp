@@ -0,0 +1,340 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Concurrent hash map whose values are ref_owner-managed
+ */
+#ifndef ZOOX_REF_OWNER_MAP_H
+#define ZOOX_REF_OWNER_MAP_H
+
+// =============================================================================
+// zoox::ref_owner_map - Shared registry with references that survive erase
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Registries such as track ID -> track state are read from many threads
+// while entries are added and erased. find() returns a unique_reference to
+// the value, so the value stays alive for as long as the caller holds it,
+// even if the entry is erased concurrently.
+//
+//   - Keys are split over ShardCount shards. Each shard has a fixed array of
+//     bucket chains and a mutex that only writers take.
+//   - find() walks the chain without locking and registers a reference with
+//     try_make_ref(). Readers never block writers or each other.
+//   - erase() unlinks the node and marks its owner. The node goes on the
+//     shard's reclaim queue; no new reference can be made from it.
+//   - The value is destroyed once its owner has drained, and the node is
+//     freed once no reader can still be walking past it. Both happen on
+//     the reclaim queue, which writers drain as they go and reclaim()
+//     drains on demand.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::ref_owner_map<TrackId, TrackState> tracks;
+//
+//   tracks.emplace(id, initial_state);
+//
+//   if (auto track = tracks.find(id)) {      // OptionalT<reference>
+//       use((*track)->position);             // Valid even if erased now
+//   }
+//
+//   tracks.erase(id);                        // Marks; destroyed when drained
+//
+// The bucket count is fixed at construction (there is no rehash), so size
+// the map for its expected population.
+//
+// NODE RECLAMATION
+// ----------------
+// A reader may have loaded a pointer to a node just before a writer unlinks
+// it, so unlinked nodes are freed only after a grace period of the shard's
+// reader_epoch (zoox/reader_epoch.hpp) as well as after their owner drains.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+#include "zoox/reader_epoch.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace zoox
+{
+
+template <typename Key,
+          typename V,
+          typename Hash                       = std::hash<Key>,
+          typename KeyEqual                   = std::equal_to<Key>,
+          template <typename> class OptionalT = std::optional,
+          std::size_t ShardCount              = 16>
+class ref_owner_map
+{
+    static_assert(ShardCount > 0, "ref_owner_map needs at least one shard");
+
+public:
+    using key_type   = Key;
+    using owner_type = ref_owner<V, OptionalT, destruct_only<V>>;
+    using reference  = unique_reference<V, V, OptionalT, destruct_only<V>>;
+
+    static constexpr std::size_t default_bucket_count = 1024;
+
+    explicit ref_owner_map(std::size_t     bucket_count = default_bucket_count,
+                           const Hash&     hash         = Hash(),
+                           const KeyEqual& equal        = KeyEqual())
+        : hash_(hash)
+        , equal_(equal)
+    {
+        const std::size_t per_shard = bucket_count / ShardCount > 0 ? bucket_count / ShardCount : 1;
+        for (auto& s : shards_)
+        {
+            s.buckets      = std::make_unique<std::atomic<node*>[]>(per_shard);
+            s.bucket_count = per_shard;
+            for (std::size_t i = 0; i < per_shard; ++i)
+            {
+                s.buckets[i].store(nullptr, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Values still referenced follow ref_owner's destructor policy
+    ~ref_owner_map() noexcept(std::is_nothrow_destructible<owner_type>::value)
+    {
+        for (auto& s : shards_)
+        {
+            for (std::size_t i = 0; i < s.bucket_count; ++i)
+            {
+                for (node* n = s.buckets[i].load(std::memory_order_relaxed); n != nullptr;)
+                {
+                    node* next = n->next.load(std::memory_order_relaxed);
+                    n->owner.mark_and_delete_if_ready();
+                    delete n;
+                    n = next;
+                }
+            }
+            for (const retired& r : s.retired_nodes)
+            {
+                r.n->owner.delete_if_deleteable();
+                delete r.n;
+            }
+        }
+    }
+
+    // Non-copyable, non-movable (references point into the nodes)
+    ref_owner_map(const ref_owner_map&)            = delete;
+    ref_owner_map& operator=(const ref_owner_map&) = delete;
+    ref_owner_map(ref_owner_map&&)                 = delete;
+    ref_owner_map& operator=(ref_owner_map&&)      = delete;
+
+    // Constructs V(args...) under key. Returns false (constructing nothing)
+    // if key is already present.
+    template <typename... Args>
+    bool emplace(const Key& key, Args&&... args)
+    {
+        const std::size_t           hash = hash_(key);
+        shard&                      s    = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.write_mutex);
+        std::atomic<node*>&         bucket = s.bucket_for(hash);
+        if (find_locked(bucket, key) != nullptr)
+        {
+            return false;
+        }
+        node* n = new node(key, bucket.load(std::memory_order_relaxed), std::forward<Args>(args)...);
+        bucket.store(n, std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        reclaim_locked(s);
+        return true;
+    }
+
+    // Replaces any existing value: the old value is erased (and lives on
+    // while referenced), then V(args...) is inserted.
+    template <typename... Args>
+    void insert_or_replace(const Key& key, Args&&... args)
+    {
+        const std::size_t           hash = hash_(key);
+        shard&                      s    = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.write_mutex);
+        std::atomic<node*>&         bucket = s.bucket_for(hash);
+        node* n = new node(key, nullptr, std::forward<Args>(args)...);
+        unlink_locked(s, bucket, key);
+        n->next.store(bucket.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        bucket.store(n, std::memory_order_release);
+        size_.fetch_add(1, std::memory_order_relaxed);
+        reclaim_locked(s);
+    }
+
+    // Lock-free lookup. Empty if key is absent or has been erased.
+    OptionalT<reference> find(const Key& key) const noexcept
+    {
+        const std::size_t             hash = hash_(key);
+        shard&                        s    = shard_for(hash);
+        detail::reader_epoch::section section(s.epoch);
+        // seq_cst loads keep the walk ordered after the reader registration
+        for (node* n = s.bucket_for(hash).load(std::memory_order_seq_cst); n != nullptr;
+             n       = n->next.load(std::memory_order_seq_cst))
+        {
+            if (equal_(n->key, key))
+            {
+                return n->owner.try_make_ref();
+            }
+        }
+        return OptionalT<reference>();
+    }
+
+    bool contains(const Key& key) const noexcept
+    {
+        return static_cast<bool>(find(key));
+    }
+
+    // Unlinks key and marks its owner. Returns false if key was absent.
+    // Outstanding references keep the value alive.
+    bool erase(const Key& key)
+    {
+        const std::size_t           hash = hash_(key);
+        shard&                      s    = shard_for(hash);
+        std::lock_guard<std::mutex> lock(s.write_mutex);
+        const bool                  erased = unlink_locked(s, s.bucket_for(hash), key);
+        reclaim_locked(s);
+        return erased;
+    }
+
+    // Number of linked entries (a snapshot under concurrent writes)
+    std::size_t size() const noexcept
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    // Drains every shard's reclaim queue as far as possible. Returns the
+    // number of erased nodes still waiting on references or readers.
+    std::size_t reclaim()
+    {
+        std::size_t pending = 0;
+        for (auto& s : shards_)
+        {
+            std::lock_guard<std::mutex> lock(s.write_mutex);
+            reclaim_locked(s);
+            pending += s.retired_nodes.size();
+        }
+        return pending;
+    }
+
+private:
+    struct node
+    {
+        template <typename... Args>
+        node(const Key& k, node* next_node, Args&&... args)
+            : key(k)
+            , next(next_node)
+            , owner(new (storage) V(std::forward<Args>(args)...))
+        {
+        }
+
+        const Key          key;
+        std::atomic<node*> next;
+        owner_type         owner;
+        alignas(V) unsigned char storage[sizeof(V)];
+    };
+
+    struct retired
+    {
+        node*         n;
+        std::uint64_t epoch;
+    };
+
+    struct alignas(64) shard
+    {
+        std::atomic<node*>& bucket_for(std::size_t hash) const noexcept
+        {
+            return buckets[(hash / ShardCount) % bucket_count];
+        }
+
+        std::unique_ptr<std::atomic<node*>[]> buckets;
+        std::size_t                           bucket_count = 0;
+        detail::reader_epoch                  epoch;
+        std::mutex                            write_mutex;
+        std::vector<retired>                  retired_nodes;
+    };
+
+    shard& shard_for(std::size_t hash) const noexcept
+    {
+        return shards_[hash % ShardCount];
+    }
+
+    node* find_locked(const std::atomic<node*>& bucket, const Key& key) const noexcept
+    {
+        for (node* n = bucket.load(std::memory_order_relaxed); n != nullptr;
+             n       = n->next.load(std::memory_order_relaxed))
+        {
+            if (equal_(n->key, key))
+            {
+                return n;
+            }
+        }
+        return nullptr;
+    }
+
+    bool unlink_locked(shard& s, std::atomic<node*>& bucket, const Key& key)
+    {
+        // Reserve first so that nothing can throw once the node is unlinked
+        s.retired_nodes.reserve(s.retired_nodes.size() + 1);
+        std::atomic<node*>* link = &bucket;
+        for (node* n = link->load(std::memory_order_relaxed); n != nullptr;
+             n       = link->load(std::memory_order_relaxed))
+        {
+            if (equal_(n->key, key))
+            {
+                // seq_cst so that the unlink is ordered before the epoch read
+                link->store(n->next.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+                n->owner.mark_for_deletion();
+                s.retired_nodes.push_back(retired{n, s.epoch.current()});
+                size_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+            link = &n->next;
+        }
+        return false;
+    }
+
+    // Destroys drained values and frees nodes no reader can reach
+    static void reclaim_locked(shard& s) noexcept
+    {
+        if (s.retired_nodes.empty())
+        {
+            return;
+        }
+        const std::uint64_t epoch = s.epoch.advance();
+
+        std::size_t kept = 0;
+        for (const retired& r : s.retired_nodes)
+        {
+            r.n->owner.delete_if_deleteable();
+            if (r.n->owner.is_deleted() && detail::reader_epoch::grace_elapsed(r.epoch, epoch))
+            {
+                delete r.n;
+            }
+            else
+            {
+                s.retired_nodes[kept++] = r;
+            }
+        }
+        s.retired_nodes.resize(kept);
+    }
+
+    Hash                                  hash_;
+    KeyEqual                              equal_;
+    mutable std::array<shard, ShardCount> shards_;
+    std::atomic<std::size_t>              size_{0};
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_REF_OWNER_MAP_H
@@ -0,0 +1,331 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Fixed-capacity, lock-free pool of ref_owner-managed slots
+ */
+#ifndef ZOOX_REF_OWNER_POOL_H
+#define ZOOX_REF_OWNER_POOL_H
+
+// =============================================================================
+// zoox::ref_owner_pool - Heap-free steady-state allocation for ref_owner
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// The static_shareable_pool sketched in docs/ref_owner_proposal.md scans its
+// array in both allocate() and deallocate() and is not thread-safe. This is
+// the production version:
+//
+//   - Capacity slots, each holding a ref_owner and inline storage for one T
+//   - O(1) allocate/free through a lock-free free list (tagged Treiber stack)
+//   - A small per-thread cache of free slots so the common case touches no
+//     shared cache line
+//   - A destruct-only deleter that hands the slot back to the pool, so the
+//     normal delete_if_deleteable() path frees the slot automatically
+//
+// No heap allocation happens after construction.
+//
+// BASIC USAGE
+// -----------
+//
+//   static zoox::ref_owner_pool<SensorData, 16> sensor_pool;
+//
+//   void real_time_cycle() {
+//       auto* owner = sensor_pool.allocate(current_readings);
+//       if (owner == nullptr) { /* pool exhausted */ }
+//
+//       consumer.process(owner->make_ref());
+//
+//       // At the deterministic point in the cycle - slot returns to the pool
+//       owner->mark_and_delete_if_ready();
+//   }
+//
+// THREAD CACHES
+// -------------
+// Each thread keeps up to ThreadCacheSize free slot indices in a cache owned
+// by the pool. Slots freed on a thread go to its cache first, and allocate()
+// checks the cache before the shared free list. Slots parked in other
+// threads' caches are not visible to allocate(), so a thread may see the pool
+// as exhausted while up to ThreadCacheSize slots per other thread are free.
+// Use ThreadCacheSize = 0 when every slot must be reachable from every thread.
+// Only the first detail::max_cached_threads threads get a cache; later
+// threads use the shared free list directly.
+//
+// BACKING MEMORY
+// --------------
+// By default (inline_memory) the slots live inside the pool object. Any
+// other MemorySource (zoox/memory_source.hpp) provides the slot array once,
+// at construction - e.g. pinned_memory_source for huge-page, NUMA-local,
+// mlocked slots.
+//
+// =============================================================================
+
+#include "zoox/memory_source.hpp"
+#include "zoox/memory_w_ref_owner.hpp"
+#include "zoox/thread_index_registry.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <utility>
+
+namespace zoox
+{
+namespace detail
+{
+
+// Lock-free set of free slot indices in [0, Capacity): a tagged Treiber stack
+// shared by all threads, fronted by one small cache per thread index.
+template <std::size_t Capacity, std::size_t ThreadCacheSize>
+class slot_free_list
+{
+    static_assert(Capacity > 0, "slot_free_list requires at least one slot");
+    static_assert(Capacity < std::numeric_limits<std::uint32_t>::max(), "slot indices are 32-bit");
+
+public:
+    static constexpr std::uint32_t empty_index = std::numeric_limits<std::uint32_t>::max();
+
+    // Every slot starts free, lowest index on top
+    slot_free_list() noexcept
+    {
+        for (std::uint32_t i = 0; i < Capacity; ++i)
+        {
+            next_[i].store(i + 1 < Capacity ? i + 1 : empty_index, std::memory_order_relaxed);
+        }
+        head_.store(pack(0, 0), std::memory_order_release);
+    }
+
+    // Returns a free index, or empty_index if none is visible to this thread
+    std::uint32_t acquire() noexcept
+    {
+        thread_cache* cache = local_cache();
+        if (cache != nullptr && cache->count > 0)
+        {
+            return cache->indices[--cache->count];
+        }
+        return pop_shared();
+    }
+
+    void release(std::uint32_t index) noexcept
+    {
+        thread_cache* cache = local_cache();
+        if (cache != nullptr && cache->count < ThreadCacheSize)
+        {
+            cache->indices[cache->count++] = index;
+            return;
+        }
+        push_shared(index);
+    }
+
+private:
+    struct alignas(64) thread_cache
+    {
+        std::uint32_t                                                      count = 0;
+        std::array<std::uint32_t, ThreadCacheSize == 0 ? 1 : ThreadCacheSize> indices{};
+    };
+
+    // Head: slot index in the low half, ABA tag in the high half
+    static constexpr std::uint64_t pack(std::uint32_t index, std::uint32_t tag) noexcept
+    {
+        return (std::uint64_t{tag} << 32U) | index;
+    }
+    static constexpr std::uint32_t index_of(std::uint64_t head) noexcept
+    {
+        return static_cast<std::uint32_t>(head);
+    }
+    static constexpr std::uint32_t tag_of(std::uint64_t head) noexcept
+    {
+        return static_cast<std::uint32_t>(head >> 32U);
+    }
+
+    thread_cache* local_cache() noexcept
+    {
+        if (ThreadCacheSize == 0)
+        {
+            return nullptr;
+        }
+        const std::size_t thread = thread_index_registry::current();
+        return thread < max_cached_threads ? &caches_[thread] : nullptr;
+    }
+
+    std::uint32_t pop_shared() noexcept
+    {
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        for (;;)
+        {
+            const std::uint32_t index = index_of(head);
+            if (index == empty_index)
+            {
+                return empty_index;
+            }
+            const std::uint32_t next = next_[index].load(std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(
+                    head, pack(next, tag_of(head) + 1), std::memory_order_acq_rel, std::memory_order_acquire))
+            {
+                return index;
+            }
+        }
+    }
+
+    void push_shared(std::uint32_t index) noexcept
+    {
+        std::uint64_t head = head_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            next_[index].store(index_of(head), std::memory_order_relaxed);
+            if (head_.compare_exchange_weak(
+                    head, pack(index, tag_of(head) + 1), std::memory_order_release, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+
+    alignas(64) std::atomic<std::uint64_t> head_{pack(empty_index, 0)};
+    std::array<std::atomic<std::uint32_t>, Capacity>                             next_{};
+    std::array<thread_cache, (ThreadCacheSize == 0 ? 1 : max_cached_threads)> caches_{};
+};
+
+// ref_owner that exposes the protected rearm() to the pools that own it
+template <typename T, template <typename> class OptionalT, typename Deleter>
+class rearmable_owner : public ref_owner<T, OptionalT, Deleter>
+{
+public:
+    using ref_owner<T, OptionalT, Deleter>::ref_owner;
+    using ref_owner<T, OptionalT, Deleter>::rearm;
+};
+
+}  // namespace detail
+
+template <typename T,
+          std::size_t Capacity,
+          template <typename> class OptionalT = std::optional,
+          std::size_t ThreadCacheSize         = 8,
+          typename MemorySource               = inline_memory>
+class ref_owner_pool
+{
+    using free_list = detail::slot_free_list<Capacity, ThreadCacheSize>;
+
+public:
+    // Destroys the object in place and returns its slot to the pool
+    class slot_deleter
+    {
+    public:
+        slot_deleter(ref_owner_pool* pool, std::uint32_t index) noexcept
+            : pool_(pool)
+            , index_(index)
+        {
+        }
+
+        void operator()(T* p) const noexcept
+        {
+            // Copy out first: once the slot is released it may be rearmed by
+            // another thread, and this deleter lives inside that slot
+            ref_owner_pool* const pool  = pool_;
+            const std::uint32_t   index = index_;
+            p->~T();
+            pool->free_list_.release(index);
+        }
+
+    private:
+        ref_owner_pool* pool_;
+        std::uint32_t   index_;
+    };
+
+    using owner_type = ref_owner<T, OptionalT, slot_deleter>;
+    using reference  = unique_reference<T, T, OptionalT, slot_deleter>;
+
+    ref_owner_pool() noexcept(std::is_same<MemorySource, inline_memory>::value)
+        : ref_owner_pool(MemorySource())
+    {
+    }
+
+    explicit ref_owner_pool(MemorySource source) noexcept(std::is_same<MemorySource, inline_memory>::value)
+        : slots_(std::move(source))
+    {
+        for (std::uint32_t i = 0; i < Capacity; ++i)
+        {
+            new (&slots_[i]) slot(this, i);
+        }
+    }
+
+    // Slots still holding objects follow ref_owner's destructor policy
+    ~ref_owner_pool() noexcept(std::is_nothrow_destructible<owner_type>::value)
+    {
+        for (std::size_t i = Capacity; i > 0; --i)
+        {
+            slots_[i - 1].~slot();
+        }
+    }
+
+    // Non-copyable, non-movable (owners and references point into the pool)
+    ref_owner_pool(const ref_owner_pool&)            = delete;
+    ref_owner_pool& operator=(const ref_owner_pool&) = delete;
+    ref_owner_pool(ref_owner_pool&&)                 = delete;
+    ref_owner_pool& operator=(ref_owner_pool&&)      = delete;
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+    // The source backing the slots (not available with inline_memory)
+    const MemorySource& memory_source() const noexcept
+    {
+        return slots_.source();
+    }
+
+    // Constructs T in a free slot. Returns nullptr if the pool is exhausted.
+    // The returned owner is unmarked with no references; mark it and call
+    // delete_if_deleteable() to destroy the object and free the slot.
+    template <typename... Args>
+    owner_type* allocate(Args&&... args) noexcept(std::is_nothrow_constructible<T, Args&&...>::value)
+    {
+        const std::uint32_t index = free_list_.acquire();
+        if (index == free_list::empty_index)
+        {
+            return nullptr;
+        }
+        slot& s = slots_[index];
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            s.owner.rearm(new (s.storage) T(std::forward<Args>(args)...));
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            free_list_.release(index);
+            throw;
+        }
+#endif
+        return &s.owner;
+    }
+
+private:
+    struct slot
+    {
+        slot(ref_owner_pool* pool, std::uint32_t index) noexcept
+            : owner(nullptr, slot_deleter(pool, index))
+        {
+            // Slots start in the deleted state so that allocate() can rearm them
+            owner.mark_and_delete_if_ready();
+        }
+
+        detail::rearmable_owner<T, OptionalT, slot_deleter> owner;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    free_list                                         free_list_;
+    detail::slot_storage<slot, Capacity, MemorySource> slots_;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_REF_OWNER_POOL_H
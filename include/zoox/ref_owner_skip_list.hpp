@@ -0,0 +1,515 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Ordered concurrent skip list whose nodes are ref_owners
+ */
+#ifndef ZOOX_REF_OWNER_SKIP_LIST_H
+#define ZOOX_REF_OWNER_SKIP_LIST_H
+
+// =============================================================================
+// zoox::ref_owner_skip_list - Ordered index with borrowing range scans
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// An ordered map (e.g. objects by timestamp) that supports point lookups and
+// range scans while other threads insert and erase. Every node is a
+// ref_owner of its value, and the borrowing protocol is the reclamation
+// mechanism:
+//
+//   - find() walks the levels without locking and returns a
+//     unique_reference to the value.
+//   - A cursor holds a registered reference on its current node and moves
+//     hand-over-hand: it registers on the successor (try_register_ref())
+//     before releasing the node it is on. Nodes that fail to register have
+//     been erased and are skipped.
+//   - erase() marks the node's owner first and then unlinks it from every
+//     level. A marked node accepts no new borrows; it is destroyed once its
+//     borrows have drained.
+//
+// Writers (emplace, erase) serialize on one mutex that readers never take,
+// so lookups and scans are lock-free and never block writers.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::ref_owner_skip_list<Timestamp, Detection> by_time;
+//
+//   by_time.emplace(t, detection);
+//
+//   // Range scan [from, to) that tolerates concurrent erase
+//   for (auto c = by_time.lower_bound(from); c && c.key() < to; c.advance()) {
+//       process(c.key(), *c);
+//   }
+//
+//   by_time.erase(t);
+//
+// RECLAMATION
+// -----------
+// A borrow protects a node once registered, but a reader must load the
+// node's address before it can register. Each walk therefore runs inside a
+// reader_epoch section (zoox/reader_epoch.hpp), and an erased node is freed
+// only when both its owner has drained and the epoch grace period has
+// passed. A cursor resting on a node holds no section; when it advances from
+// a node that has since been erased, it re-seeks from the head instead of
+// following the erased node's stale links.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+#include "zoox/reader_epoch.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace zoox
+{
+
+template <typename Key,
+          typename V,
+          typename Compare                    = std::less<Key>,
+          template <typename> class OptionalT = std::optional,
+          unsigned MaxLevel                   = 16>
+class ref_owner_skip_list
+{
+    static_assert(MaxLevel > 0 && MaxLevel <= 32, "MaxLevel must be in [1, 32]");
+
+    class node;
+
+public:
+    using key_type   = Key;
+    using owner_type = ref_owner<V, OptionalT, destruct_only<V>>;
+    using reference  = unique_reference<V, V, OptionalT, destruct_only<V>>;
+
+    // =========================================================================
+    // cursor - Borrowed position in the list
+    // =========================================================================
+    class cursor
+    {
+    public:
+        // Past-the-end cursor
+        cursor() noexcept = default;
+
+        cursor(cursor&& other) noexcept
+            : list_(other.list_)
+            , node_(std::exchange(other.node_, nullptr))
+        {
+        }
+
+        ~cursor() noexcept
+        {
+            if (node_ != nullptr)
+            {
+                node_->on_ref_released();
+            }
+        }
+
+        cursor(const cursor&)            = delete;
+        cursor& operator=(const cursor&) = delete;
+        cursor& operator=(cursor&&)      = delete;
+
+        explicit operator bool() const noexcept
+        {
+            return node_ != nullptr;
+        }
+
+        const Key& key() const noexcept
+        {
+            return node_->key;
+        }
+
+        V& operator*() const noexcept
+        {
+            return *node_->get();
+        }
+
+        V* operator->() const noexcept
+        {
+            return node_->get();
+        }
+
+        // Another reference to the current value; empty once it is erased
+        OptionalT<reference> make_ref() const noexcept
+        {
+            return node_->try_make_ref();
+        }
+
+        // Moves to the next live entry, hand-over-hand. Returns false (and
+        // becomes past-the-end) at the end of the list.
+        bool advance() noexcept
+        {
+            node* next;
+            {
+                detail::reader_epoch::section section(list_->epoch_);
+                // An erased node's links may point at nodes already freed
+                next = node_->is_marked_for_deletion() ? list_->first_after(node_->key)
+                                                       : node_->next(0).load(std::memory_order_seq_cst);
+                next = list_->first_borrowable(next);
+            }
+            node_->on_ref_released();
+            node_ = next;
+            return node_ != nullptr;
+        }
+
+    private:
+        friend class ref_owner_skip_list;
+
+        // n is already registered
+        cursor(const ref_owner_skip_list* list, node* n) noexcept
+            : list_(list)
+            , node_(n)
+        {
+        }
+
+        const ref_owner_skip_list* list_ = nullptr;
+        node*                      node_ = nullptr;
+    };
+
+    explicit ref_owner_skip_list(const Compare& compare = Compare())
+        : compare_(compare)
+    {
+        for (auto& link : head_)
+        {
+            link.store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    // Values still borrowed follow ref_owner's destructor policy
+    ~ref_owner_skip_list() noexcept(std::is_nothrow_destructible<owner_type>::value)
+    {
+        for (node* n = head_[0].load(std::memory_order_relaxed); n != nullptr;)
+        {
+            node* next = n->next(0).load(std::memory_order_relaxed);
+            n->mark_and_delete_if_ready();
+            node::destroy(n);
+            n = next;
+        }
+        for (const retired& r : retired_)
+        {
+            r.n->delete_if_deleteable();
+            node::destroy(r.n);
+        }
+    }
+
+    // Non-copyable, non-movable (references and cursors point into nodes)
+    ref_owner_skip_list(const ref_owner_skip_list&)            = delete;
+    ref_owner_skip_list& operator=(const ref_owner_skip_list&) = delete;
+    ref_owner_skip_list(ref_owner_skip_list&&)                 = delete;
+    ref_owner_skip_list& operator=(ref_owner_skip_list&&)      = delete;
+
+    // Constructs V(args...) under key. Returns false (constructing nothing)
+    // if key is already present.
+    template <typename... Args>
+    bool emplace(const Key& key, Args&&... args)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::atomic<node*>*         preds[MaxLevel];
+        if (locate(key, preds) != nullptr)
+        {
+            return false;
+        }
+        const unsigned height = random_height();
+        node*          n      = node::create(key, height, std::forward<Args>(args)...);
+        for (unsigned level = 0; level < height; ++level)
+        {
+            n->next(level).store(preds[level]->load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        // Bottom level first: a node is in the list once it is on level 0
+        for (unsigned level = 0; level < height; ++level)
+        {
+            preds[level]->store(n, std::memory_order_seq_cst);
+        }
+        ++size_;
+        reclaim_locked();
+        return true;
+    }
+
+    // Marks key's owner and unlinks its node. Returns false if key is absent.
+    // Borrowed values stay alive until released.
+    bool erase(const Key& key)
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        std::atomic<node*>*         preds[MaxLevel];
+        node* const                 n = locate(key, preds);
+        if (n == nullptr)
+        {
+            return false;
+        }
+        retired_.reserve(retired_.size() + 1);
+        // Mark before unlinking: a cursor that sees its node unmarked may
+        // trust that node's links (see advance())
+        n->mark_for_deletion();
+        for (unsigned level = n->height; level > 0; --level)
+        {
+            preds[level - 1]->store(n->next(level - 1).load(std::memory_order_relaxed), std::memory_order_seq_cst);
+        }
+        retired_.push_back(retired{n, epoch_.current()});
+        --size_;
+        reclaim_locked();
+        return true;
+    }
+
+    // Lock-free point lookup
+    OptionalT<reference> find(const Key& key) const noexcept
+    {
+        detail::reader_epoch::section section(epoch_);
+        node* const                   n = first_not_less(key);
+        if (n == nullptr || compare_(key, n->key))
+        {
+            return OptionalT<reference>();
+        }
+        return n->try_make_ref();
+    }
+
+    bool contains(const Key& key) const noexcept
+    {
+        return static_cast<bool>(find(key));
+    }
+
+    // Cursor on the first live entry with a key not less than key
+    cursor lower_bound(const Key& key) const noexcept
+    {
+        detail::reader_epoch::section section(epoch_);
+        return cursor(this, first_borrowable(first_not_less(key)));
+    }
+
+    // Cursor on the first live entry
+    cursor begin() const noexcept
+    {
+        detail::reader_epoch::section section(epoch_);
+        return cursor(this, first_borrowable(head_[0].load(std::memory_order_seq_cst)));
+    }
+
+    // Visits live entries with keys in [from, to): f(const Key&, V&)
+    template <typename F>
+    void for_each_in_range(const Key& from, const Key& to, F&& f) const
+    {
+        for (cursor c = lower_bound(from); c && compare_(c.key(), to); c.advance())
+        {
+            f(c.key(), *c);
+        }
+    }
+
+    // Linked entries (a snapshot under concurrent writes)
+    std::size_t size() const noexcept
+    {
+        return size_.load(std::memory_order_relaxed);
+    }
+
+    // Frees erased nodes that have drained. Returns the number still
+    // waiting on borrows or readers.
+    std::size_t reclaim()
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        reclaim_locked();
+        return retired_.size();
+    }
+
+private:
+    // ref_owner with its key, value storage and a trailing array of height
+    // links allocated in the same block
+    class node final : public owner_type
+    {
+    public:
+        using owner_type::on_ref_released;
+        using owner_type::try_register_ref;
+
+        template <typename... Args>
+        static node* create(const Key& key, unsigned height, Args&&... args)
+        {
+            // Aligned for the value's storage, which may be over-aligned
+            void* memory = ::operator new(sizeof(node) + height * sizeof(std::atomic<node*>), alignment);
+#ifdef __cpp_exceptions
+            try
+            {
+#endif
+                return new (memory) node(key, height, std::forward<Args>(args)...);
+#ifdef __cpp_exceptions
+            }
+            catch (...)
+            {
+                ::operator delete(memory, alignment);
+                throw;
+            }
+#endif
+        }
+
+        static void destroy(node* n) noexcept(std::is_nothrow_destructible<owner_type>::value)
+        {
+            n->~node();
+            ::operator delete(n, alignment);
+        }
+
+        std::atomic<node*>& next(unsigned level) noexcept
+        {
+            return links()[level];
+        }
+
+        const Key      key;
+        const unsigned height;
+
+    private:
+        static constexpr std::align_val_t alignment{alignof(node)};
+
+        template <typename... Args>
+        node(const Key& k, unsigned h, Args&&... args)
+            : owner_type(nullptr)
+            , key(k)
+            , height(h)
+        {
+            for (unsigned level = 0; level < height; ++level)
+            {
+                new (&links()[level]) std::atomic<node*>(nullptr);
+            }
+#ifdef __cpp_exceptions
+            try
+            {
+#endif
+                this->owned_ptr_.reset(new (storage_) V(std::forward<Args>(args)...));
+#ifdef __cpp_exceptions
+            }
+            catch (...)
+            {
+                // Leave the owner deleted so its destructor accepts it
+                this->mark_and_delete_if_ready();
+                throw;
+            }
+#endif
+        }
+
+        std::atomic<node*>* links() noexcept
+        {
+            return reinterpret_cast<std::atomic<node*>*>(reinterpret_cast<unsigned char*>(this) + sizeof(node));  // NOLINT
+        }
+
+        alignas(V) unsigned char storage_[sizeof(V)];
+    };
+
+    static_assert(alignof(node) >= alignof(std::atomic<node*>), "links follow the node");
+
+    struct retired
+    {
+        node*         n;
+        std::uint64_t epoch;
+    };
+
+    // Writer side: fills preds with the link to update on each level and
+    // returns the node with key, if any
+    node* locate(const Key& key, std::atomic<node*>** preds) noexcept
+    {
+        node* pred = nullptr;
+        for (unsigned level = MaxLevel; level > 0; --level)
+        {
+            std::atomic<node*>* link = pred != nullptr ? &pred->next(level - 1) : &head_[level - 1];
+            for (node* n = link->load(std::memory_order_relaxed); n != nullptr && compare_(n->key, key);
+                 n       = link->load(std::memory_order_relaxed))
+            {
+                pred = n;
+                link = &n->next(level - 1);
+            }
+            preds[level - 1] = link;
+        }
+        node* const candidate = preds[0]->load(std::memory_order_relaxed);
+        return candidate != nullptr && !compare_(key, candidate->key) ? candidate : nullptr;
+    }
+
+    // Reader side (inside a section): first linked node with key >= key,
+    // or > key for first_after(). seq_cst loads keep the walk ordered after
+    // the section's registration.
+    template <typename Before>
+    node* descend(Before before) const noexcept
+    {
+        node* pred = nullptr;
+        node* n    = nullptr;
+        for (unsigned level = MaxLevel; level > 0; --level)
+        {
+            n = pred != nullptr ? pred->next(level - 1).load(std::memory_order_seq_cst)
+                                : head_[level - 1].load(std::memory_order_seq_cst);
+            while (n != nullptr && before(n->key))
+            {
+                pred = n;
+                n    = n->next(level - 1).load(std::memory_order_seq_cst);
+            }
+        }
+        return n;
+    }
+
+    node* first_not_less(const Key& key) const noexcept
+    {
+        return descend([&](const Key& k) { return compare_(k, key); });
+    }
+
+    node* first_after(const Key& key) const noexcept
+    {
+        return descend([&](const Key& k) { return !compare_(key, k); });
+    }
+
+    // Inside a section: registers on n or the first live node after it
+    node* first_borrowable(node* n) const noexcept
+    {
+        while (n != nullptr && !n->try_register_ref())
+        {
+            n = n->next(0).load(std::memory_order_seq_cst);
+        }
+        return n;
+    }
+
+    unsigned random_height() noexcept
+    {
+        // xorshift64; each level is kept with probability 1/2
+        rng_state_ ^= rng_state_ << 13U;
+        rng_state_ ^= rng_state_ >> 7U;
+        rng_state_ ^= rng_state_ << 17U;
+        std::uint64_t bits   = rng_state_;
+        unsigned      height = 1;
+        while (height < MaxLevel && (bits & 1U) != 0)
+        {
+            ++height;
+            bits >>= 1U;
+        }
+        return height;
+    }
+
+    void reclaim_locked() noexcept
+    {
+        if (retired_.empty())
+        {
+            return;
+        }
+        const std::uint64_t epoch = epoch_.advance();
+        std::size_t         kept  = 0;
+        for (const retired& r : retired_)
+        {
+            r.n->delete_if_deleteable();
+            if (r.n->is_deleted() && detail::reader_epoch::grace_elapsed(r.epoch, epoch))
+            {
+                node::destroy(r.n);
+            }
+            else
+            {
+                retired_[kept++] = r;
+            }
+        }
+        retired_.resize(kept);
+    }
+
+    Compare                      compare_;
+    std::atomic<node*>           head_[MaxLevel];
+    mutable detail::reader_epoch epoch_;
+    std::mutex                   write_mutex_;
+    std::vector<retired>         retired_;
+    std::uint64_t                rng_state_ = 0x9e3779b97f4a7c15ULL;
+    std::atomic<std::size_t>     size_{0};
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_REF_OWNER_SKIP_LIST_H
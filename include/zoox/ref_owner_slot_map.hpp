@@ -0,0 +1,459 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Generational slot map of ref_owners with 32-bit handles and references
+ */
+#ifndef ZOOX_REF_OWNER_SLOT_MAP_H
+#define ZOOX_REF_OWNER_SLOT_MAP_H
+
+// =============================================================================
+// zoox::ref_owner_slot_map / zoox::compact_reference
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// A unique_reference is a pointer to its ref_owner: 8 bytes per reference,
+// and the owners are wherever the heap put them. ref_owner_slot_map stores
+// owners and their objects side by side in one contiguous array, and names
+// them with a 32-bit slot_handle:
+//
+//   [ generation : 32 - IndexBits ][ index : IndexBits ]
+//
+// A handle stays valid until its entry is erased. The slot's generation then
+// advances, so a stale handle never resolves to a later occupant.
+//
+// compact_reference<Map> is a registered reference that stores only the
+// handle (4 bytes). The map it refers to is a template argument, so it must
+// be an object with static storage duration; that is what lets the
+// reference find its owner without storing a pointer.
+//
+// THREADING
+// ---------
+// insert(), erase(), collect() and for_each() mutate or scan the map and
+// must be externally synchronized (typically: called from the thread that
+// owns the component array). Resolving handles, creating references and
+// releasing them are lock-free and may happen on any thread.
+//
+// DELETION
+// --------
+// erase() unlinks the handle and marks the owner. If no references are
+// outstanding the object is destroyed at once. Otherwise the slot is queued
+// and collect() destroys the object and frees the slot once it has drained
+// (insert() also collects when it runs out of free slots). Deletion never
+// happens on a reader thread.
+//
+// BASIC USAGE
+// -----------
+//
+//   static zoox::ref_owner_slot_map<Track> tracks(1 << 16);
+//
+//   zoox::slot_handle h = tracks.insert(args...);
+//
+//   // 4-byte reference, e.g. stored in a component array
+//   auto ref = zoox::compact_reference<tracks>::try_make(h);
+//   if (ref) { use((*ref)->position); }
+//
+//   // Dense iteration over live entries
+//   tracks.for_each([](zoox::slot_handle, Track& t) { t.update(); });
+//
+//   tracks.erase(h);
+//   tracks.collect();            // Once per frame
+//
+// =============================================================================
+
+#include "zoox/ref_owner_pool.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace zoox
+{
+
+// 32-bit generation + index handle. The all-zero value is the null handle
+// (generations start at 1).
+struct slot_handle
+{
+    std::uint32_t value = 0;
+
+    explicit operator bool() const noexcept
+    {
+        return value != 0;
+    }
+
+    friend bool operator==(slot_handle lhs, slot_handle rhs) noexcept
+    {
+        return lhs.value == rhs.value;
+    }
+
+    friend bool operator!=(slot_handle lhs, slot_handle rhs) noexcept
+    {
+        return lhs.value != rhs.value;
+    }
+};
+
+template <auto& Map>
+class compact_reference;
+
+namespace detail
+{
+
+// Exposes the registration primitives compact_reference is built on
+template <typename T, template <typename> class OptionalT>
+class slot_map_owner : public rearmable_owner<T, OptionalT, destruct_only<T>>
+{
+    using base = rearmable_owner<T, OptionalT, destruct_only<T>>;
+
+public:
+    using base::base;
+    using base::on_ref_released;
+    using base::try_register_ref;
+};
+
+}  // namespace detail
+
+template <typename T, template <typename> class OptionalT = std::optional, unsigned IndexBits = 20>
+class ref_owner_slot_map
+{
+    static_assert(IndexBits > 0 && IndexBits <= 24, "need at least 8 generation bits");
+
+public:
+    using value_type = T;
+    using owner_type = ref_owner<T, OptionalT, destruct_only<T>>;
+    using reference  = unique_reference<T, T, OptionalT, destruct_only<T>>;
+
+    template <typename U>
+    using optional_type = OptionalT<U>;
+
+    static constexpr unsigned      index_bits      = IndexBits;
+    static constexpr unsigned      generation_bits = 32 - IndexBits;
+    static constexpr std::uint32_t max_capacity    = std::uint32_t{1} << IndexBits;
+
+    // Allocates capacity slots once. Throws std::bad_alloc (aborts without
+    // exceptions) if capacity exceeds max_capacity, since handles could not
+    // address the extra slots.
+    explicit ref_owner_slot_map(std::size_t capacity)
+        : slots_(std::make_unique<slot[]>(checked_capacity(capacity)))
+        , capacity_(static_cast<std::uint32_t>(capacity))
+    {
+        free_.reserve(capacity);
+        pending_.reserve(capacity);
+        for (std::uint32_t i = capacity_; i > 0; --i)
+        {
+            free_.push_back(i - 1);
+        }
+    }
+
+    // Entries still referenced follow ref_owner's destructor policy
+    ~ref_owner_slot_map() = default;
+
+    // Non-copyable, non-movable (references resolve into the slots)
+    ref_owner_slot_map(const ref_owner_slot_map&)            = delete;
+    ref_owner_slot_map& operator=(const ref_owner_slot_map&) = delete;
+    ref_owner_slot_map(ref_owner_slot_map&&)                 = delete;
+    ref_owner_slot_map& operator=(ref_owner_slot_map&&)      = delete;
+
+    // Constructs T(args...) in a free slot. Returns the null handle if every
+    // slot is in use (after collecting drained ones).
+    template <typename... Args>
+    slot_handle insert(Args&&... args)
+    {
+        if (free_.empty())
+        {
+            collect();
+            if (free_.empty())
+            {
+                return slot_handle{};
+            }
+        }
+        const std::uint32_t index = free_.back();
+        slot&               s     = slots_[index];
+        s.owner.rearm(new (s.storage) T(std::forward<Args>(args)...));
+        free_.pop_back();
+        ++size_;
+        return make_handle(index, s.generation.load(std::memory_order_relaxed));
+    }
+
+    // Invalidates handle and marks its owner. Returns false for a stale or
+    // null handle. Outstanding references keep the object alive until a
+    // later collect().
+    bool erase(slot_handle handle)
+    {
+        slot* s = live_slot(handle);
+        if (s == nullptr || s->owner.is_marked_for_deletion())
+        {
+            return false;
+        }
+        --size_;
+        s->owner.mark_for_deletion();
+        if (!try_free(index_of(handle)))
+        {
+            pending_.push_back(index_of(handle));
+        }
+        return true;
+    }
+
+    // Destroys erased objects whose references have drained and frees their
+    // slots. Returns the number of erased entries still referenced.
+    std::size_t collect()
+    {
+        std::size_t kept = 0;
+        for (const std::uint32_t index : pending_)
+        {
+            if (!try_free(index))
+            {
+                pending_[kept++] = index;
+            }
+        }
+        pending_.resize(kept);
+        return kept;
+    }
+
+    // True if handle names a live (inserted, not erased) entry
+    bool contains(slot_handle handle) const noexcept
+    {
+        const slot* s = live_slot(handle);
+        return s != nullptr && !s->owner.is_marked_for_deletion();
+    }
+
+    // Registers a full unique_reference through handle. Thread-safe.
+    OptionalT<reference> try_make_ref(slot_handle handle) const noexcept
+    {
+        if (!try_register(handle))
+        {
+            return OptionalT<reference>();
+        }
+        typename reference::already_registered tag;
+        return OptionalT<reference>(reference(slots_[index_of(handle)].owner, tag));
+    }
+
+    // Visits every live entry in slot order: f(slot_handle, T&)
+    template <typename F>
+    void for_each(F&& f)
+    {
+        for (std::uint32_t i = 0; i < capacity_; ++i)
+        {
+            slot& s = slots_[i];
+            if (!s.owner.is_marked_for_deletion())
+            {
+                f(make_handle(i, s.generation.load(std::memory_order_relaxed)), *s.owner.get());
+            }
+        }
+    }
+
+    // Live entries
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return capacity_;
+    }
+
+    // Erased entries waiting for their references to drain
+    std::size_t pending() const noexcept
+    {
+        return pending_.size();
+    }
+
+private:
+    template <auto& Map>
+    friend class compact_reference;
+
+    struct slot
+    {
+        slot() noexcept
+            : owner(nullptr)
+        {
+            // Slots start deleted so that insert() can rearm them
+            owner.mark_and_delete_if_ready();
+        }
+
+        ~slot()
+        {
+            owner.mark_and_delete_if_ready();
+        }
+
+        slot(const slot&)            = delete;
+        slot& operator=(const slot&) = delete;
+
+        detail::slot_map_owner<T, OptionalT> owner;
+        std::atomic<std::uint32_t>           generation{1};
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    static constexpr std::uint32_t index_mask      = max_capacity - 1;
+    static constexpr std::uint32_t generation_mask = (std::uint32_t{1} << generation_bits) - 1;
+
+    static std::size_t checked_capacity(std::size_t capacity)
+    {
+        if (capacity > max_capacity)
+        {
+            detail::throw_bad_alloc();
+        }
+        return capacity;
+    }
+
+    static slot_handle make_handle(std::uint32_t index, std::uint32_t generation) noexcept
+    {
+        return slot_handle{(generation << IndexBits) | index};
+    }
+
+    static std::uint32_t index_of(slot_handle handle) noexcept
+    {
+        return handle.value & index_mask;
+    }
+
+    static std::uint32_t generation_of(slot_handle handle) noexcept
+    {
+        return handle.value >> IndexBits;
+    }
+
+    slot* live_slot(slot_handle handle) const noexcept
+    {
+        const std::uint32_t index = index_of(handle);
+        if (!handle || index >= capacity_ ||
+            slots_[index].generation.load(std::memory_order_acquire) != generation_of(handle))
+        {
+            return nullptr;
+        }
+        return &slots_[index];
+    }
+
+    // Writer side: destroys the object if drained and advances the generation
+    // so that handles to it go stale before the slot can be reused
+    bool try_free(std::uint32_t index) noexcept
+    {
+        slot& s = slots_[index];
+        if (!s.owner.delete_if_deleteable())
+        {
+            return false;
+        }
+        std::uint32_t next = (s.generation.load(std::memory_order_relaxed) + 1) & generation_mask;
+        s.generation.store(next == 0 ? 1 : next, std::memory_order_release);
+        free_.push_back(index);
+        return true;
+    }
+
+    // Same optimistic registration as weak_observer: check the generation,
+    // register, then check again in case the slot was reused in between
+    bool try_register(slot_handle handle) const noexcept
+    {
+        slot* s = live_slot(handle);
+        if (s == nullptr || !s->owner.try_register_ref())
+        {
+            return false;
+        }
+        if (s->generation.load(std::memory_order_acquire) != generation_of(handle))
+        {
+            s->owner.on_ref_released();
+            return false;
+        }
+        return true;
+    }
+
+    void release_registered(slot_handle handle) const noexcept
+    {
+        slots_[index_of(handle)].owner.on_ref_released();
+    }
+
+    T& resolve_registered(slot_handle handle) const noexcept
+    {
+        return *slots_[index_of(handle)].owner.get();
+    }
+
+    std::unique_ptr<slot[]>    slots_;
+    std::uint32_t              capacity_;
+    std::size_t                size_ = 0;
+    std::vector<std::uint32_t> free_;
+    std::vector<std::uint32_t> pending_;
+};
+
+// =============================================================================
+// compact_reference - 4-byte registered reference into a static slot map
+// =============================================================================
+template <auto& Map>
+class compact_reference
+{
+    using map_type = std::remove_reference_t<decltype(Map)>;
+
+public:
+    using value_type = typename map_type::value_type;
+
+    // Registers a reference through handle. Empty if the handle is stale or
+    // its entry has been erased.
+    static typename map_type::template optional_type<compact_reference> try_make(slot_handle handle) noexcept
+    {
+        if (!Map.try_register(handle))
+        {
+            return {};
+        }
+        return compact_reference(handle);
+    }
+
+    compact_reference(compact_reference&& other) noexcept
+        : handle_(std::exchange(other.handle_, slot_handle{}))
+    {
+    }
+
+    ~compact_reference() noexcept
+    {
+        if (handle_)
+        {
+            Map.release_registered(handle_);
+        }
+    }
+
+    // Like unique_reference: move-constructible only
+    compact_reference(const compact_reference&)            = delete;
+    compact_reference& operator=(const compact_reference&) = delete;
+    compact_reference& operator=(compact_reference&&)      = delete;
+
+    value_type& get() const noexcept
+    {
+        return Map.resolve_registered(handle_);
+    }
+
+    value_type& operator*() const noexcept
+    {
+        return get();
+    }
+
+    value_type* operator->() const noexcept
+    {
+        return &get();
+    }
+
+    slot_handle handle() const noexcept
+    {
+        return handle_;
+    }
+
+    // Transfers the registration to a full (pointer-sized) unique_reference
+    typename map_type::reference to_reference() && noexcept
+    {
+        typename map_type::reference::already_registered tag;
+        const slot_handle handle = std::exchange(handle_, slot_handle{});
+        return typename map_type::reference(Map.slots_[map_type::index_of(handle)].owner, tag);
+    }
+
+private:
+    explicit compact_reference(slot_handle handle) noexcept
+        : handle_(handle)
+    {
+    }
+
+    slot_handle handle_;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_REF_OWNER_SLOT_MAP_H
@@ -0,0 +1,496 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Opt-in statistics for ref_owner: contention counters and drain-latency histograms
+ */
+#ifndef ZOOX_REF_OWNER_STATS_H
+#define ZOOX_REF_OWNER_STATS_H
+
+// =============================================================================
+// zoox::ref_owner_stats - What ref_owners do in production
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Frame budgets are sized from how long owners take to drain once marked,
+// and slow holders show up as owners that are still busy at reclaim time.
+// instrumented_ref_owner is a ref_owner that reports to a stats policy:
+//
+//   - try_make_ref() (and make_ref/try_make_refs) successes and failures
+//   - the high-water mark of the reference count
+//   - mark-to-drain latency: from the first mark_for_deletion() until the
+//     reference count reaches zero
+//   - mark-to-delete latency: from the mark until delete_if_deleteable()
+//     actually deletes
+//   - delete_if_deleteable() calls on a marked owner that found references
+//     still outstanding
+//
+// ref_owner_stats keeps one cache-line-aligned block of counters per thread
+// (indexed like ref_owner_pool's thread caches), written only by that
+// thread, so recording never contends. snapshot() sums the blocks.
+//
+// Stats can be per owner (pass a ref_owner_stats to the constructor) or per
+// type (the default, ref_owner_stats::for_type<T>()).
+//
+// DISABLING
+// ---------
+// stats_ref_owner<T, Stats> is instrumented_ref_owner when Stats::enabled
+// and plain ref_owner otherwise, so with no_ref_owner_stats the owner is the
+// uninstrumented type and costs nothing:
+//
+//   #ifdef FRAME_STATS
+//   using frame_stats = zoox::ref_owner_stats;
+//   #else
+//   using frame_stats = zoox::no_ref_owner_stats;
+//   #endif
+//
+//   zoox::stats_ref_owner<Frame, frame_stats> frame(new Frame);
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::instrumented_ref_owner<Frame> frame(new Frame);
+//   ...
+//   const auto stats = zoox::ref_owner_stats::for_type<Frame>().snapshot();
+//   log("p99 drain", stats.mark_to_drain.percentile(0.99).count(), "ns");
+//
+// Only calls made through instrumented_ref_owner are recorded; calling the
+// same owner through a ref_owner& skips the counters (releases are always
+// seen, since on_ref_released() is virtual).
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+#include "zoox/thread_index_registry.hpp"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace zoox
+{
+
+// Log2 histogram of latencies: bucket i counts durations below 2^i ns (and
+// at or above 2^(i-1) ns); the last bucket also counts everything longer
+struct latency_histogram
+{
+    static constexpr std::size_t bucket_count = 32;
+
+    std::array<std::uint64_t, bucket_count> buckets{};
+
+    static std::size_t bucket_for(std::chrono::nanoseconds latency) noexcept
+    {
+        std::uint64_t ns     = latency.count() > 0 ? static_cast<std::uint64_t>(latency.count()) : 0;
+        std::size_t   bucket = 0;
+        while (ns != 0 && bucket + 1 < bucket_count)
+        {
+            ns >>= 1U;
+            ++bucket;
+        }
+        return bucket;
+    }
+
+    // Exclusive upper bound of a bucket's latencies
+    static std::chrono::nanoseconds upper_bound(std::size_t bucket) noexcept
+    {
+        return std::chrono::nanoseconds(std::int64_t{1} << bucket);
+    }
+
+    std::uint64_t count() const noexcept
+    {
+        std::uint64_t total = 0;
+        for (const std::uint64_t n : buckets)
+        {
+            total += n;
+        }
+        return total;
+    }
+
+    // Upper bound of the bucket holding quantile q (0..1); 0 if empty
+    std::chrono::nanoseconds percentile(double q) const noexcept
+    {
+        const std::uint64_t total = count();
+        if (total == 0)
+        {
+            return std::chrono::nanoseconds(0);
+        }
+        const double  clamped = q < 0.0 ? 0.0 : (q > 1.0 ? 1.0 : q);
+        std::uint64_t rank    = static_cast<std::uint64_t>(clamped * static_cast<double>(total));
+        rank                  = rank < 1 ? 1 : rank;
+        std::uint64_t seen    = 0;
+        for (std::size_t i = 0; i < bucket_count; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+            {
+                return upper_bound(i);
+            }
+        }
+        return upper_bound(bucket_count - 1);
+    }
+};
+
+struct ref_owner_stats_snapshot
+{
+    std::uint64_t     try_make_ref_succeeded = 0;
+    std::uint64_t     try_make_ref_failed    = 0;
+    std::uint64_t     deletes_blocked        = 0;  // delete_if_deleteable() found references outstanding
+    std::size_t       ref_count_high_water   = 0;
+    latency_histogram mark_to_drain;
+    latency_histogram mark_to_delete;
+};
+
+// Disabled policy: stats_ref_owner<T, no_ref_owner_stats> is a plain ref_owner
+struct no_ref_owner_stats
+{
+    static constexpr bool enabled = false;
+};
+
+// Aggregates the counters of any number of instrumented owners
+class ref_owner_stats
+{
+public:
+    static constexpr bool enabled = true;
+
+    ref_owner_stats() noexcept = default;
+
+    ref_owner_stats(const ref_owner_stats&)            = delete;
+    ref_owner_stats& operator=(const ref_owner_stats&) = delete;
+
+    // Stats shared by every instrumented owner of T that is not given its own
+    template <typename T>
+    static ref_owner_stats& for_type() noexcept
+    {
+        static ref_owner_stats stats;
+        return stats;
+    }
+
+    void record_make_ref(bool succeeded, std::size_t count, std::size_t ref_count) noexcept
+    {
+        thread_counters& c = local();
+        bump(c, succeeded ? c.succeeded : c.failed, count);
+        if (succeeded && ref_count > c.high_water.load(std::memory_order_relaxed))
+        {
+            raise_high_water(c, ref_count);
+        }
+    }
+
+    void record_delete_blocked() noexcept
+    {
+        thread_counters& c = local();
+        bump(c, c.deletes_blocked, 1);
+    }
+
+    void record_mark_to_drain(std::chrono::nanoseconds latency) noexcept
+    {
+        thread_counters& c = local();
+        bump(c, c.mark_to_drain[latency_histogram::bucket_for(latency)], 1);
+    }
+
+    void record_mark_to_delete(std::chrono::nanoseconds latency) noexcept
+    {
+        thread_counters& c = local();
+        bump(c, c.mark_to_delete[latency_histogram::bucket_for(latency)], 1);
+    }
+
+    // Sums every thread's counters; concurrent recording may or may not be included
+    ref_owner_stats_snapshot snapshot() const noexcept
+    {
+        ref_owner_stats_snapshot s;
+        for (const thread_counters& c : threads_)
+        {
+            s.try_make_ref_succeeded += c.succeeded.load(std::memory_order_relaxed);
+            s.try_make_ref_failed += c.failed.load(std::memory_order_relaxed);
+            s.deletes_blocked += c.deletes_blocked.load(std::memory_order_relaxed);
+            const std::size_t high_water = c.high_water.load(std::memory_order_relaxed);
+            s.ref_count_high_water       = high_water > s.ref_count_high_water ? high_water : s.ref_count_high_water;
+            for (std::size_t i = 0; i < latency_histogram::bucket_count; ++i)
+            {
+                s.mark_to_drain.buckets[i] += c.mark_to_drain[i].load(std::memory_order_relaxed);
+                s.mark_to_delete.buckets[i] += c.mark_to_delete[i].load(std::memory_order_relaxed);
+            }
+        }
+        return s;
+    }
+
+private:
+    // Written by one thread, except the last block, which threads without an
+    // index share
+    struct alignas(64) thread_counters
+    {
+        std::atomic<std::uint64_t> succeeded{0};
+        std::atomic<std::uint64_t> failed{0};
+        std::atomic<std::uint64_t> deletes_blocked{0};
+        std::atomic<std::size_t>   high_water{0};
+        std::atomic<std::uint64_t> mark_to_drain[latency_histogram::bucket_count] = {};
+        std::atomic<std::uint64_t> mark_to_delete[latency_histogram::bucket_count] = {};
+    };
+
+    static constexpr std::size_t shared_block = detail::max_cached_threads;
+
+    thread_counters& local() noexcept
+    {
+        const std::size_t thread = detail::thread_index_registry::current();
+        return threads_[thread < detail::max_cached_threads ? thread : shared_block];
+    }
+
+    bool is_shared(const thread_counters& c) const noexcept
+    {
+        return &c == &threads_[shared_block];
+    }
+
+    // A plain load/store on an owned block: no read-modify-write
+    void bump(thread_counters& c, std::atomic<std::uint64_t>& counter, std::uint64_t n) const noexcept
+    {
+        if (is_shared(c))
+        {
+            counter.fetch_add(n, std::memory_order_relaxed);
+        }
+        else
+        {
+            counter.store(counter.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+    }
+
+    void raise_high_water(thread_counters& c, std::size_t ref_count) const noexcept
+    {
+        std::size_t current = c.high_water.load(std::memory_order_relaxed);
+        while (ref_count > current &&
+               !c.high_water.compare_exchange_weak(current, ref_count, std::memory_order_relaxed))
+        {
+        }
+    }
+
+    thread_counters threads_[detail::max_cached_threads + 1];
+};
+
+// =============================================================================
+// instrumented_ref_owner - A ref_owner that reports to a stats policy
+// =============================================================================
+template <typename T,
+          typename Stats                      = ref_owner_stats,
+          template <typename> class OptionalT = std::optional,
+          typename Deleter                    = std::default_delete<T>>
+class instrumented_ref_owner : public ref_owner<T, OptionalT, Deleter>
+{
+    static_assert(Stats::enabled, "use ref_owner (or stats_ref_owner) when stats are disabled");
+
+public:
+    using base      = ref_owner<T, OptionalT, Deleter>;
+    using reference = unique_reference<T, T, OptionalT, Deleter>;
+    using clock     = std::chrono::steady_clock;
+
+    explicit instrumented_ref_owner(T* ptr, Stats& stats = Stats::template for_type<T>())
+        : base(ptr)
+        , stats_(&stats)
+    {
+    }
+
+    instrumented_ref_owner(T* ptr, Deleter d, Stats& stats = Stats::template for_type<T>())
+        : base(ptr, std::move(d))
+        , stats_(&stats)
+    {
+    }
+
+    explicit instrumented_ref_owner(std::unique_ptr<T, Deleter> ptr, Stats& stats = Stats::template for_type<T>())
+        : base(std::move(ptr))
+        , stats_(&stats)
+    {
+    }
+
+    // Non-copyable
+    instrumented_ref_owner(const instrumented_ref_owner&)            = delete;
+    instrumented_ref_owner& operator=(const instrumented_ref_owner&) = delete;
+
+    // Movable; the mark time moves with the owner
+    instrumented_ref_owner(instrumented_ref_owner&& other) noexcept
+        : base(std::move(other))
+        , stats_(other.stats_)
+        , marked_at_(other.marked_at_.load(std::memory_order_relaxed))
+        , drained_(other.drained_.load(std::memory_order_relaxed))
+    {
+    }
+
+    instrumented_ref_owner& operator=(instrumented_ref_owner&& other) noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        if (this != &other)
+        {
+            base::operator=(std::move(other));
+            stats_ = other.stats_;
+            marked_at_.store(other.marked_at_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            drained_.store(other.drained_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        return *this;
+    }
+
+    OptionalT<reference> try_make_ref(ZOOX_HOLDER_SITE) noexcept
+    {
+        OptionalT<reference> ref = base::try_make_ref(ZOOX_HOLDER_SITE_ARG);
+        record_make_ref(static_cast<bool>(ref), 1);
+        return ref;
+    }
+
+#ifdef __cpp_exceptions
+    reference make_ref(ZOOX_HOLDER_SITE)
+    {
+        OptionalT<reference> ref = try_make_ref(ZOOX_HOLDER_SITE_ARG);
+        if (!ref)
+        {
+            if (!base::is_marked_for_deletion())
+            {
+                throw ref_owner_exclusive_exception();
+            }
+            throw ref_owner_marked_exception();
+        }
+        return std::move(*ref);
+    }
+#endif
+
+    template <typename Out>
+    bool try_make_refs(std::size_t count, Out&& out ZOOX_HOLDER_SITE_NEXT)
+    {
+        // Recorded before out() runs: the references may be gone by the time it returns
+        bool recorded  = false;
+        auto recording = [&](reference&& ref)
+        {
+            if (!recorded)
+            {
+                recorded = true;
+                record_make_ref(true, count);
+            }
+            out(std::move(ref));
+        };
+        const bool succeeded = count == 0 || base::try_make_refs(count, recording ZOOX_HOLDER_SITE_NEXT_ARG);
+        if (!succeeded)
+        {
+            record_make_ref(false, count);
+        }
+        return succeeded;
+    }
+
+    // Starts the mark-to-drain and mark-to-delete clocks on the first mark
+    void mark_for_deletion() noexcept
+    {
+        std::int64_t unmarked = 0;
+        if (!base::is_marked_for_deletion())
+        {
+            marked_at_.compare_exchange_strong(unmarked, now(), std::memory_order_relaxed);
+        }
+        base::mark_for_deletion();
+        if (base::ref_count_.load(std::memory_order_seq_cst) == 0)
+        {
+            record_drain();
+        }
+    }
+
+    bool delete_if_deleteable() noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        if (base::is_marked_for_deletion() && !base::is_deleted() &&
+            base::ref_count_.load(std::memory_order_acquire) != 0)
+        {
+            stats_->record_delete_blocked();
+            return false;
+        }
+        if (!base::delete_if_deleteable())
+        {
+            return false;
+        }
+        const std::int64_t marked_at = marked_at_.exchange(0, std::memory_order_relaxed);
+        if (marked_at != 0)
+        {
+            stats_->record_mark_to_delete(std::chrono::nanoseconds(now() - marked_at));
+        }
+        return true;
+    }
+
+    bool mark_and_delete_if_ready() noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        mark_for_deletion();
+        return delete_if_deleteable();
+    }
+
+    Stats& stats() const noexcept
+    {
+        return *stats_;
+    }
+
+protected:
+    void on_ref_released() noexcept override
+    {
+        const std::size_t prev = base::ref_count_.fetch_sub(1, std::memory_order_seq_cst);
+        base::trace_ref_released(prev);
+        if (prev == 1 && base::marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            record_drain();
+        }
+    }
+
+    void on_exclusive_ref_released() noexcept override
+    {
+        const std::size_t prev = base::ref_count_.fetch_sub(base::exclusive_ref_flag, std::memory_order_seq_cst);
+        base::trace_ref_released(prev);
+        if (prev == base::exclusive_ref_flag && base::marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            record_drain();
+        }
+    }
+
+    void on_registration_rolled_back(std::size_t amount) noexcept override
+    {
+        const std::size_t prev = base::ref_count_.fetch_sub(amount, std::memory_order_seq_cst);
+        if (prev == amount && base::marked_for_deletion_.load(std::memory_order_seq_cst))
+        {
+            record_drain();
+        }
+    }
+
+private:
+    static std::int64_t now() noexcept
+    {
+        // Never 0, which means "not marked"
+        const std::int64_t ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+        return ns != 0 ? ns : 1;
+    }
+
+    void record_make_ref(bool succeeded, std::size_t count) noexcept
+    {
+        stats_->record_make_ref(succeeded, count, succeeded ? base::ref_count() : 0);
+    }
+
+    // Once per mark: the release that drains the owner, or the mark itself
+    // if nothing was outstanding
+    void record_drain() noexcept
+    {
+        const std::int64_t marked_at = marked_at_.load(std::memory_order_relaxed);
+        if (marked_at != 0 && !drained_.exchange(true, std::memory_order_relaxed))
+        {
+            stats_->record_mark_to_drain(std::chrono::nanoseconds(now() - marked_at));
+        }
+    }
+
+    Stats*                    stats_;
+    std::atomic<std::int64_t> marked_at_{0};  // clock ns of the first mark; 0 if unmarked
+    std::atomic<bool>         drained_{false};
+};
+
+// instrumented_ref_owner when Stats is enabled, ref_owner otherwise
+template <typename T,
+          typename Stats                      = ref_owner_stats,
+          template <typename> class OptionalT = std::optional,
+          typename Deleter                    = std::default_delete<T>>
+using stats_ref_owner = typename std::conditional<Stats::enabled,
+                                                  instrumented_ref_owner<T, Stats, OptionalT, Deleter>,
+                                                  ref_owner<T, OptionalT, Deleter>>::type;
+
+}  // namespace zoox
+
+#endif  // ZOOX_REF_OWNER_STATS_H
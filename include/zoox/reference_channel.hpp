@@ -0,0 +1,627 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Bounded lock-free SPSC/MPMC channels that move unique_references
+ */
+#ifndef ZOOX_REFERENCE_CHANNEL_H
+#define ZOOX_REFERENCE_CHANNEL_H
+
+// =============================================================================
+// zoox::spsc_channel / zoox::mpmc_channel - Stage-to-stage reference handoff
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Pipeline stages hand borrowed objects to each other as unique_references.
+// These channels move the references through a ring preallocated with
+// Capacity cells. Each cell holds the reference object itself, so a handoff
+// is a pointer-sized move plus the ring's index update. The owner's
+// ref_count_ is not touched: the registration travels with the reference.
+//
+//   spsc_channel - one producer thread, one consumer thread; wait-free
+//   mpmc_channel - any number of each; lock-free (Vyukov's bounded queue)
+//
+// Both support:
+//
+//   try_push / try_pop          - non-blocking; a failed push leaves the
+//                                 reference with the caller
+//   try_push_n / try_pop_n      - batches; one index update per batch
+//   push / pop                  - blocking; spin briefly, then sleep on a
+//                                 condition variable until space, data, or
+//                                 close()
+//   close()                     - wakes every blocked caller; pop() keeps
+//                                 draining until the channel is empty
+//
+// References still in the channel when it is destroyed are released.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::spsc_channel<zoox::unique_reference<Frame>, 64> to_detector;
+//
+//   // Stage 1
+//   to_detector.push(owner.make_ref());
+//
+//   // Stage 2
+//   while (auto frame = to_detector.pop()) {     // Empty once closed and drained
+//       detect(**frame);
+//   }
+//
+// The channel works for any move-constructible reference type (e.g.
+// exclusive_reference, or unique_reference with a pool deleter). Pop results
+// use the reference's OptionalT.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace zoox
+{
+namespace detail
+{
+
+// OptionalT of a reference type, std::optional for anything else
+template <typename Reference>
+struct reference_optional
+{
+    template <typename U>
+    using type = std::optional<U>;
+};
+
+template <typename R, typename B, template <typename> class OptionalT, typename D>
+struct reference_optional<unique_reference<R, B, OptionalT, D>>
+{
+    template <typename U>
+    using type = OptionalT<U>;
+};
+
+template <typename T, template <typename> class OptionalT, typename D>
+struct reference_optional<exclusive_reference<T, OptionalT, D>>
+{
+    template <typename U>
+    using type = OptionalT<U>;
+};
+
+constexpr std::size_t channel_cache_line = 64;
+
+// Blocking support: waiters sleep on a condition variable, and the
+// non-blocking fast path only takes the mutex when someone is waiting.
+// Both sides use a read-modify-write on waiters_: either the waiter's
+// increment is seen by the publisher, or the publisher's RMW comes first in
+// waiters_' modification order and the waiter's increment synchronizes with
+// it, so the waiter's readiness check sees the publication. (A fence pair
+// would do the same but is not understood by ThreadSanitizer.)
+class alignas(channel_cache_line) channel_signal
+{
+public:
+    // Called after publishing
+    void notify() noexcept
+    {
+        if (waiters_.fetch_add(0, std::memory_order_acq_rel) > 0)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_all();
+        }
+    }
+
+    void notify_closed() noexcept
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        condition_.notify_all();
+    }
+
+    // Returns true once ready() holds, false if closed first
+    template <typename Ready>
+    bool wait(Ready ready, const std::atomic<bool>& closed)
+    {
+        for (int spin = 0; spin < spin_limit; ++spin)
+        {
+            if (ready())
+            {
+                return true;
+            }
+            if (closed.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+        }
+        waiters_.fetch_add(1, std::memory_order_acq_rel);
+        bool result = true;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            while (!ready())
+            {
+                if (closed.load(std::memory_order_acquire))
+                {
+                    result = false;
+                    break;
+                }
+                condition_.wait(lock);
+            }
+        }
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+        return result;
+    }
+
+private:
+    static constexpr int spin_limit = 128;
+
+    std::atomic<int>        waiters_{0};
+    std::mutex              mutex_;
+    std::condition_variable condition_;
+};
+
+// Ring cell storage for a reference; constructed on push, destroyed on pop
+template <typename Reference>
+struct reference_cell_storage
+{
+    Reference* get() noexcept
+    {
+        return std::launder(reinterpret_cast<Reference*>(bytes));  // NOLINT: cell storage
+    }
+
+    alignas(Reference) unsigned char bytes[sizeof(Reference)];
+};
+
+}  // namespace detail
+
+// =============================================================================
+// spsc_channel
+// =============================================================================
+template <typename Reference, std::size_t Capacity>
+class spsc_channel
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+    static_assert(std::is_nothrow_move_constructible<Reference>::value, "references move without throwing");
+
+public:
+    using reference_type = Reference;
+    template <typename U>
+    using optional_type = typename detail::reference_optional<Reference>::template type<U>;
+
+    spsc_channel() = default;
+
+    // Releases any references still in the channel
+    ~spsc_channel()
+    {
+        const std::size_t tail = tail_.load(std::memory_order_acquire);
+        for (std::size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head)
+        {
+            cells_[head & mask].get()->~Reference();
+        }
+    }
+
+    spsc_channel(const spsc_channel&)            = delete;
+    spsc_channel& operator=(const spsc_channel&) = delete;
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+    // Producer only. On failure (full) ref is left untouched.
+    bool try_push(Reference&& ref) noexcept
+    {
+        return try_push_n(&ref, 1) == 1;
+    }
+
+    // Producer only. Moves up to count references from refs[0..count) and
+    // returns how many were pushed; the rest are left untouched.
+    std::size_t try_push_n(Reference* refs, std::size_t count) noexcept
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (Capacity - (tail - cached_head_) < count)
+        {
+            cached_head_ = head_.load(std::memory_order_acquire);
+        }
+        const std::size_t space = Capacity - (tail - cached_head_);
+        const std::size_t n     = count < space ? count : space;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            new (cells_[(tail + i) & mask].bytes) Reference(std::move(refs[i]));
+        }
+        if (n != 0)
+        {
+            tail_.store(tail + n, std::memory_order_release);
+            not_empty_.notify();
+        }
+        return n;
+    }
+
+    // Consumer only
+    optional_type<Reference> try_pop() noexcept
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head == cached_tail_ && head == (cached_tail_ = tail_.load(std::memory_order_acquire)))
+        {
+            return optional_type<Reference>();
+        }
+        Reference*               cell = cells_[head & mask].get();
+        optional_type<Reference> result(std::move(*cell));
+        cell->~Reference();
+        head_.store(head + 1, std::memory_order_release);
+        not_full_.notify();
+        return result;
+    }
+
+    // Consumer only. Pops up to max references, passing each to out(Reference&&).
+    // Returns how many were popped. If out throws, the references already
+    // passed to it are consumed and the rest stay queued.
+    template <typename Out>
+    std::size_t try_pop_n(Out&& out, std::size_t max)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (cached_tail_ - head < max)
+        {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+        }
+        const std::size_t available = cached_tail_ - head;
+        const std::size_t n         = max < available ? max : available;
+        std::size_t       i         = 0;
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            for (; i < n; ++i)
+            {
+                // Out of the cell before out() runs, so a throw cannot leave it half-consumed
+                Reference* cell = cells_[(head + i) & mask].get();
+                Reference  ref(std::move(*cell));
+                cell->~Reference();
+                out(std::move(ref));
+            }
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            head_.store(head + i + 1, std::memory_order_release);
+            not_full_.notify();
+            throw;
+        }
+#endif
+        if (n != 0)
+        {
+            head_.store(head + n, std::memory_order_release);
+            not_full_.notify();
+        }
+        return n;
+    }
+
+    // Blocks while full. Returns false (ref untouched) if closed.
+    bool push(Reference&& ref)
+    {
+        for (;;)
+        {
+            if (closed_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (try_push(std::move(ref)))
+            {
+                return true;
+            }
+            not_full_.wait([this] { return size() < Capacity; }, closed_);
+        }
+    }
+
+    // Blocks while empty. Returns empty once closed and drained.
+    optional_type<Reference> pop()
+    {
+        for (;;)
+        {
+            if (auto result = try_pop())
+            {
+                return result;
+            }
+            if (!not_empty_.wait([this] { return size() != 0; }, closed_))
+            {
+                return try_pop();
+            }
+        }
+    }
+
+    // Wakes blocked callers; later pushes fail, pops drain what is left
+    void close() noexcept
+    {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.notify_closed();
+        not_full_.notify_closed();
+    }
+
+    bool is_closed() const noexcept
+    {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    // Snapshot; exact when called from the producer or consumer thread
+    std::size_t size() const noexcept
+    {
+        return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+    }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    // Consumer-owned line
+    alignas(detail::channel_cache_line) std::atomic<std::size_t> head_{0};
+    std::size_t cached_tail_ = 0;
+    // Producer-owned line
+    alignas(detail::channel_cache_line) std::atomic<std::size_t> tail_{0};
+    std::size_t cached_head_ = 0;
+
+    alignas(detail::channel_cache_line) detail::reference_cell_storage<Reference> cells_[Capacity];
+    std::atomic<bool>      closed_{false};
+    detail::channel_signal not_empty_;
+    detail::channel_signal not_full_;
+};
+
+// =============================================================================
+// mpmc_channel
+// =============================================================================
+template <typename Reference, std::size_t Capacity>
+class mpmc_channel
+{
+    static_assert(Capacity > 1 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two > 1");
+    static_assert(std::is_nothrow_move_constructible<Reference>::value, "references move without throwing");
+
+public:
+    using reference_type = Reference;
+    template <typename U>
+    using optional_type = typename detail::reference_optional<Reference>::template type<U>;
+
+    mpmc_channel() noexcept
+    {
+        for (std::size_t i = 0; i < Capacity; ++i)
+        {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Releases any references still in the channel
+    ~mpmc_channel()
+    {
+        for (std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);; ++pos)
+        {
+            cell& c = cells_[pos & mask];
+            if (c.sequence.load(std::memory_order_acquire) != pos + 1)
+            {
+                break;
+            }
+            c.storage.get()->~Reference();
+        }
+    }
+
+    mpmc_channel(const mpmc_channel&)            = delete;
+    mpmc_channel& operator=(const mpmc_channel&) = delete;
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+    // On failure (full) ref is left untouched
+    bool try_push(Reference&& ref) noexcept
+    {
+        return try_push_n(&ref, 1) == 1;
+    }
+
+    // Claims up to count consecutive free cells with one CAS and moves
+    // refs[0..n) into them. Returns n; the rest are left untouched.
+    std::size_t try_push_n(Reference* refs, std::size_t count) noexcept
+    {
+        if (count == 0)
+        {
+            return 0;
+        }
+        std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        std::size_t n   = 0;
+        for (;;)
+        {
+            n = 0;
+            while (n < count && n < Capacity &&
+                   cells_[(pos + n) & mask].sequence.load(std::memory_order_acquire) == pos + n)
+            {
+                ++n;
+            }
+            if (n == 0)
+            {
+                const std::size_t seq = cells_[pos & mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - pos) < 0)
+                {
+                    return 0;  // Full
+                }
+                pos = enqueue_pos_.load(std::memory_order_relaxed);  // Another producer moved on
+                continue;
+            }
+            if (enqueue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            cell& c = cells_[(pos + i) & mask];
+            new (c.storage.bytes) Reference(std::move(refs[i]));
+            c.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        not_empty_.notify();
+        return n;
+    }
+
+    optional_type<Reference> try_pop() noexcept
+    {
+        optional_type<Reference> result;
+        try_pop_n([&result](Reference&& ref) { result.emplace(std::move(ref)); }, 1);
+        return result;
+    }
+
+    // Claims up to max consecutive filled cells with one CAS and passes each
+    // reference to out(Reference&&). Returns how many were popped. Claimed
+    // cells cannot be returned to the queue, so if out throws, the rest of
+    // the batch is released (dropped) and its cells freed before rethrowing.
+    template <typename Out>
+    std::size_t try_pop_n(Out&& out, std::size_t max)
+    {
+        if (max == 0)
+        {
+            return 0;
+        }
+        std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        std::size_t n   = 0;
+        for (;;)
+        {
+            n = 0;
+            while (n < max && n < Capacity &&
+                   cells_[(pos + n) & mask].sequence.load(std::memory_order_acquire) == pos + n + 1)
+            {
+                ++n;
+            }
+            if (n == 0)
+            {
+                const std::size_t seq = cells_[pos & mask].sequence.load(std::memory_order_acquire);
+                if (static_cast<std::ptrdiff_t>(seq - (pos + 1)) < 0)
+                {
+                    return 0;  // Empty
+                }
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_pos_.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                break;
+            }
+        }
+        std::size_t i = 0;
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            for (; i < n; ++i)
+            {
+                // Each cell is handed back to producers before out() runs
+                Reference ref(std::move(*cells_[(pos + i) & mask].storage.get()));
+                release_cell(pos + i);
+                out(std::move(ref));
+            }
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            for (++i; i < n; ++i)
+            {
+                release_cell(pos + i);
+            }
+            not_full_.notify();
+            throw;
+        }
+#endif
+        not_full_.notify();
+        return n;
+    }
+
+    // Blocks while full. Returns false (ref untouched) if closed.
+    bool push(Reference&& ref)
+    {
+        for (;;)
+        {
+            if (closed_.load(std::memory_order_acquire))
+            {
+                return false;
+            }
+            if (try_push(std::move(ref)))
+            {
+                return true;
+            }
+            not_full_.wait([this] { return has_free_cell(); }, closed_);
+        }
+    }
+
+    // Blocks while empty. Returns empty once closed and drained.
+    optional_type<Reference> pop()
+    {
+        for (;;)
+        {
+            if (auto result = try_pop())
+            {
+                return result;
+            }
+            if (!not_empty_.wait([this] { return has_filled_cell(); }, closed_))
+            {
+                return try_pop();
+            }
+        }
+    }
+
+    // Wakes blocked callers; later pushes fail, pops drain what is left
+    void close() noexcept
+    {
+        closed_.store(true, std::memory_order_release);
+        not_empty_.notify_closed();
+        not_full_.notify_closed();
+    }
+
+    bool is_closed() const noexcept
+    {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    // Approximate under concurrent use
+    std::size_t size() const noexcept
+    {
+        const std::size_t enqueued = enqueue_pos_.load(std::memory_order_acquire);
+        const std::size_t dequeued = dequeue_pos_.load(std::memory_order_acquire);
+        return enqueued > dequeued ? enqueued - dequeued : 0;
+    }
+
+private:
+    static constexpr std::size_t mask = Capacity - 1;
+
+    struct cell
+    {
+        std::atomic<std::size_t>                  sequence;
+        detail::reference_cell_storage<Reference> storage;
+    };
+
+    bool has_free_cell() const noexcept
+    {
+        const std::size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask].sequence.load(std::memory_order_acquire) == pos;
+    }
+
+    bool has_filled_cell() const noexcept
+    {
+        const std::size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+        return cells_[pos & mask].sequence.load(std::memory_order_acquire) == pos + 1;
+    }
+
+    // Destroys the (claimed) reference at pos and frees its cell for producers
+    void release_cell(std::size_t pos) noexcept
+    {
+        cell& c = cells_[pos & mask];
+        c.storage.get()->~Reference();
+        c.sequence.store(pos + Capacity, std::memory_order_release);
+    }
+
+    alignas(detail::channel_cache_line) std::atomic<std::size_t> enqueue_pos_{0};
+    alignas(detail::channel_cache_line) std::atomic<std::size_t> dequeue_pos_{0};
+    alignas(detail::channel_cache_line) cell cells_[Capacity];
+    std::atomic<bool>      closed_{false};
+    detail::channel_signal not_empty_;
+    detail::channel_signal not_full_;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_REFERENCE_CHANNEL_H
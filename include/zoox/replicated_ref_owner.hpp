@@ -0,0 +1,296 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief NUMA-replicated, read-only ref_owner for read-mostly data
+ */
+#ifndef ZOOX_REPLICATED_REF_OWNER_H
+#define ZOOX_REPLICATED_REF_OWNER_H
+
+// =============================================================================
+// zoox::replicated_ref_owner - One immutable copy and one counter per node
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Large read-only data borrowed from every core makes remote readers pay
+// cross-node latency twice: once for the ref_count_ cache line and once for
+// the object itself. replicated_ref_owner keeps a ref_owner and a copy of T
+// in node-local memory for each NUMA node. make_ref() borrows from the
+// replica of the calling thread's node and returns a reference to const T.
+//
+// The deletion protocol spans all replicas:
+//   - mark_for_deletion() marks every replica
+//   - delete_if_deleteable() deletes only once every replica has drained
+//
+// On hosts with a single node (or without NUMA support) there is exactly one
+// replica and this behaves like a ref_owner<const T>.
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::replicated_ref_owner<MapLayer> layer(load_map_layer());
+//
+//   auto ref = layer.make_ref();      // unique_reference<const MapLayer, ...>
+//   ref->lookup(x, y);                // Node-local copy, node-local counter
+//
+//   layer.mark_and_delete_if_ready(); // Deletes every replica, or none
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+#include "zoox/numa_topology.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace zoox
+{
+
+template <typename T, template <typename> class OptionalT = std::optional>
+class replicated_ref_owner
+{
+public:
+    using owner_type = ref_owner<T, OptionalT, destruct_only<T>>;
+    using reference  = unique_reference<const T, T, OptionalT, destruct_only<T>>;
+
+    // One replica per NUMA node; the first is moved from value, the rest
+    // are copies constructed in their node's memory
+    explicit replicated_ref_owner(T value)
+        : replicated_ref_owner(std::move(value), numa::node_count())
+    {
+    }
+
+    // Explicit replica count. Replica i is bound to node (i % node_count()).
+    replicated_ref_owner(T value, std::size_t replica_count)
+    {
+        replicas_.reserve(replica_count > 0 ? replica_count : 1);
+        replicas_.push_back(make_replica(std::move(value), 0));
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            for (std::size_t i = 1; i < replica_count; ++i)
+            {
+                replicas_.push_back(make_replica(*replicas_.front()->owner, i));
+            }
+            remaining_.store(replicas_.size(), std::memory_order_relaxed);
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            remaining_.store(replicas_.size(), std::memory_order_relaxed);
+            // No references exist yet, so every replica built so far can go
+            mark_and_delete_if_ready();
+            destroy_replicas();
+            throw;
+        }
+#endif
+    }
+
+#ifdef NDEBUG
+    ~replicated_ref_owner() noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        delete_if_deleteable();
+        destroy_replicas();
+    }
+#else
+#    ifdef __cpp_exceptions
+    ~replicated_ref_owner() noexcept(false)
+    {
+        if (not is_deleted() && not delete_if_deleteable())
+        {
+            throw std::logic_error("replicated_ref_owner destroyed with outstanding references");
+        }
+        destroy_replicas();
+    }
+#    else
+    ~replicated_ref_owner() noexcept
+    {
+        assert((is_deleted() || delete_if_deleteable()) &&
+               "replicated_ref_owner destroyed with outstanding references");
+        destroy_replicas();
+    }
+#    endif
+#endif
+
+    // Non-copyable, non-movable (references point into replica storage)
+    replicated_ref_owner(const replicated_ref_owner&)            = delete;
+    replicated_ref_owner& operator=(const replicated_ref_owner&) = delete;
+    replicated_ref_owner(replicated_ref_owner&&)                 = delete;
+    replicated_ref_owner& operator=(replicated_ref_owner&&)      = delete;
+
+    std::size_t replica_count() const noexcept
+    {
+        return replicas_.size();
+    }
+
+    // Borrow from the calling thread's node-local replica
+    OptionalT<reference> try_make_ref() noexcept
+    {
+        return try_make_ref_on(numa::current_node());
+    }
+
+    // Borrow from a specific replica (index taken modulo replica_count())
+    OptionalT<reference> try_make_ref_on(std::size_t replica) noexcept
+    {
+        auto ref = replica_for(replica).try_make_ref();
+        if (!ref)
+        {
+            return {};
+        }
+        return OptionalT<reference>(reference(std::move(*ref)));
+    }
+
+#ifdef __cpp_exceptions
+    reference make_ref()
+    {
+        return reference(replica_for(numa::current_node()).make_ref());
+    }
+#endif
+
+    // Query methods - aggregated across replicas
+    bool has_outstanding_references() const noexcept
+    {
+        for (const replica* r : replicas_)
+        {
+            if (r->owner.has_outstanding_references())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::size_t ref_count() const noexcept
+    {
+        std::size_t total = 0;
+        for (const replica* r : replicas_)
+        {
+            total += r->owner.ref_count();
+        }
+        return total;
+    }
+
+    bool is_marked_for_deletion() const noexcept
+    {
+        return replicas_.front()->owner.is_marked_for_deletion();
+    }
+
+    bool is_deleted() const noexcept
+    {
+        for (const replica* r : replicas_)
+        {
+            if (not r->owner.is_deleted())
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Marks every replica; no replica accepts new references afterwards
+    void mark_for_deletion() noexcept
+    {
+        for (replica* r : replicas_)
+        {
+            r->owner.mark_for_deletion();
+        }
+    }
+
+    // Deletes all replicas once every replica has drained. Returns true only
+    // to the one caller whose replica delete brought the remaining count to
+    // zero, so concurrent callers cannot both see the deletion as theirs.
+    bool delete_if_deleteable() noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        if (not is_marked_for_deletion() || is_deleted() || has_outstanding_references())
+        {
+            return false;
+        }
+        // All replicas are marked and drained; only a transient rollback can
+        // make an individual delete fail, and a later call finishes the rest
+        bool finished = false;
+        for (replica* r : replicas_)
+        {
+            if (r->owner.delete_if_deleteable() && remaining_.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                finished = true;
+            }
+        }
+        return finished;
+    }
+
+    bool mark_and_delete_if_ready() noexcept(std::is_nothrow_destructible<T>::value)
+    {
+        mark_for_deletion();
+        return delete_if_deleteable();
+    }
+
+private:
+    // Counter and object share one node-local allocation
+    struct replica
+    {
+        template <typename... Args>
+        explicit replica(Args&&... args)
+            : owner(new (storage) T(std::forward<Args>(args)...))
+        {
+        }
+
+        owner_type owner;
+        alignas(T) unsigned char storage[sizeof(T)];
+    };
+
+    template <typename Arg>
+    static replica* make_replica(Arg&& arg, std::size_t index)
+    {
+        void* memory = numa::allocate_on_node(sizeof(replica), index % numa::node_count());
+        if (memory == nullptr)
+        {
+#ifdef __cpp_exceptions
+            throw std::bad_alloc();
+#else
+            std::abort();
+#endif
+        }
+#ifdef __cpp_exceptions
+        try
+        {
+#endif
+            return new (memory) replica(std::forward<Arg>(arg));
+#ifdef __cpp_exceptions
+        }
+        catch (...)
+        {
+            // T's constructor threw; the block was never handed to a replica
+            numa::deallocate(memory, sizeof(replica));
+            throw;
+        }
+#endif
+    }
+
+    owner_type& replica_for(std::size_t index) noexcept
+    {
+        return replicas_[index % replicas_.size()]->owner;
+    }
+
+    void destroy_replicas() noexcept
+    {
+        for (replica* r : replicas_)
+        {
+            r->~replica();
+            numa::deallocate(r, sizeof(replica));
+        }
+        replicas_.clear();
+    }
+
+    std::vector<replica*>    replicas_;
+    std::atomic<std::size_t> remaining_{0};  // Replicas not yet deleted
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_REPLICATED_REF_OWNER_H
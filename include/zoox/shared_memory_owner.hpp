@@ -0,0 +1,638 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Cross-process ref_owner whose object, counts and flags live in shared memory
+ */
+#ifndef ZOOX_SHARED_MEMORY_OWNER_H
+#define ZOOX_SHARED_MEMORY_OWNER_H
+
+// =============================================================================
+// zoox::shm_ref_owner / zoox::shm_borrower - Zero-copy borrowing across processes
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Processes that share a frame (a driver producing it, planners reading it)
+// would otherwise serialize it through a socket. Here the frame is
+// constructed once in a shared memory segment (memfd or POSIX shm) and other
+// processes borrow it in place:
+//
+//   shared_segment  - RAII fd + mapping. Each process maps the segment at
+//                     its own address.
+//   shm_ref_owner   - The creating process. Constructs T in the segment,
+//                     marks it, deletes it, and rearms it with the next frame.
+//   shm_borrower    - Another process (or the same one) attached to the
+//                     segment. Hands out shm_references.
+//   shm_reference   - RAII borrow, like unique_reference. It stores the
+//                     object's offset in the segment, not an address; the
+//                     offset resolves against any process's mapping.
+//
+// SEGMENT LAYOUT
+// --------------
+//
+//   +--------+------------------------------+----------------+
+//   | header | holder slots [holder_count]  | T (aligned)    |
+//   +--------+------------------------------+----------------+
+//
+// The header holds the marked/deleted flags and a generation; everything is
+// addressed by offset. There is no single reference count: each attached
+// holder (the owner, each borrower) claims a slot tagged with its pid and
+// counts its own references there. The object's count is the sum.
+//
+// PROTOCOL
+// --------
+// The same optimistic protocol as ref_owner, per slot:
+//
+//   borrow:   slot.refs += 1; if marked: slot.refs -= 1, fail
+//   release:  slot.refs -= 1
+//   delete:   marked /\ every slot.refs == 0 -> CAS deleted, destroy T
+//
+// All operations are seq_cst, so a borrow either observes the mark or is
+// observed by the deleter's scan. Because counts are per holder, the owner
+// can reclaim the references of a process that died without releasing them
+// (reclaim_dead_holders()): a dead pid can no longer touch its slot, so its
+// count is dropped as a whole. A pid reused by a new process before the scan
+// is not detected.
+//
+// T must be trivially copyable (it is read through other mappings and holds
+// no process-local pointers). std::atomic and lock-free atomics inside T are
+// address-free on Linux and work across processes.
+//
+// BASIC USAGE
+// -----------
+//
+//   // Driver
+//   auto segment = zoox::shared_segment::create_memfd("lidar", zoox::shm_ref_owner<Scan>::required_size());
+//   zoox::shm_ref_owner<Scan> scan(segment);       // Send segment.fd() to the planner
+//   scan.rearm(read_scan());                       // Publish the first frame
+//
+//   // Planner
+//   auto segment = zoox::shared_segment::from_fd(received_fd);
+//   zoox::shm_borrower<Scan> lidar(segment);
+//   if (auto ref = lidar.try_make_ref()) {
+//       plan(**ref);                               // No copy
+//   }
+//
+//   // Driver, at its reclaim phase; then rearm() with the next frame
+//   scan.reclaim_dead_holders();
+//   scan.mark_and_delete_if_ready();
+//
+// =============================================================================
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace zoox
+{
+
+// =============================================================================
+// shared_segment - A mapped memfd or POSIX shm object
+// =============================================================================
+class shared_segment
+{
+public:
+    shared_segment() noexcept = default;
+
+#ifdef __linux__
+    // Anonymous segment; share it by passing fd() (SCM_RIGHTS, fork, or
+    // /proc/<pid>/fd). Check operator bool for failure.
+    static shared_segment create_memfd(const char* name, std::size_t size) noexcept
+    {
+        const int fd = memfd_create(name, MFD_CLOEXEC);
+        return sized(fd, size);
+    }
+#endif
+
+    // Named segment (name starts with '/'); fails if it already exists.
+    // The creator removes the name with unlink_shm().
+    static shared_segment create_shm(const char* name, std::size_t size) noexcept
+    {
+        const int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0600);
+        return sized(fd, size);
+    }
+
+    static shared_segment open_shm(const char* name) noexcept
+    {
+        return from_fd(shm_open(name, O_RDWR | O_CLOEXEC, 0));
+    }
+
+    static bool unlink_shm(const char* name) noexcept
+    {
+        return shm_unlink(name) == 0;
+    }
+
+    // Maps the whole of fd and takes ownership of it
+    static shared_segment from_fd(int fd) noexcept
+    {
+        struct stat st;
+        if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0)
+        {
+            close_fd(fd);
+            return shared_segment();
+        }
+        return shared_segment(fd, static_cast<std::size_t>(st.st_size));
+    }
+
+    ~shared_segment()
+    {
+        release();
+    }
+
+    shared_segment(const shared_segment&)            = delete;
+    shared_segment& operator=(const shared_segment&) = delete;
+
+    shared_segment(shared_segment&& other) noexcept
+        : data_(std::exchange(other.data_, nullptr))
+        , size_(std::exchange(other.size_, 0))
+        , fd_(std::exchange(other.fd_, -1))
+    {
+    }
+
+    shared_segment& operator=(shared_segment&& other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            data_ = std::exchange(other.data_, nullptr);
+            size_ = std::exchange(other.size_, 0);
+            fd_   = std::exchange(other.fd_, -1);
+        }
+        return *this;
+    }
+
+    void* data() const noexcept
+    {
+        return data_;
+    }
+
+    std::size_t size() const noexcept
+    {
+        return size_;
+    }
+
+    int fd() const noexcept
+    {
+        return fd_;
+    }
+
+    explicit operator bool() const noexcept
+    {
+        return data_ != nullptr;
+    }
+
+private:
+    shared_segment(int fd, std::size_t size) noexcept
+    {
+        void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED)
+        {
+            close_fd(fd);
+            return;
+        }
+        data_ = memory;
+        size_ = size;
+        fd_   = fd;
+    }
+
+    static shared_segment sized(int fd, std::size_t size) noexcept
+    {
+        if (fd < 0 || size == 0 || ftruncate(fd, static_cast<off_t>(size)) != 0)
+        {
+            close_fd(fd);
+            return shared_segment();
+        }
+        return shared_segment(fd, size);
+    }
+
+    static void close_fd(int fd) noexcept
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    void release() noexcept
+    {
+        if (data_ != nullptr)
+        {
+            munmap(data_, size_);
+        }
+        close_fd(fd_);
+        data_ = nullptr;
+        size_ = 0;
+        fd_   = -1;
+    }
+
+    void*       data_ = nullptr;
+    std::size_t size_ = 0;
+    int         fd_   = -1;
+};
+
+namespace detail
+{
+
+static_assert(std::atomic<std::uint32_t>::is_always_lock_free && std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared memory counters must be lock-free to be address-free");
+
+struct shm_holder_slot
+{
+    std::atomic<std::int32_t>  pid;   // 0 = free
+    std::atomic<std::uint32_t> refs;  // References held through this slot
+};
+
+struct shm_header
+{
+    static constexpr std::uint64_t magic_value = 0x7a6f6f7873686d31ULL;  // "zooxshm1"
+
+    std::atomic<std::uint64_t> magic;  // Written last by the creator
+    std::uint64_t              object_size;
+    std::uint32_t              object_offset;
+    std::uint32_t              holder_count;
+    std::atomic<std::uint32_t> marked;
+    std::atomic<std::uint32_t> deleted;
+    std::atomic<std::uint64_t> generation;
+
+    shm_holder_slot* slots() noexcept
+    {
+        return reinterpret_cast<shm_holder_slot*>(reinterpret_cast<unsigned char*>(this) + sizeof(shm_header));
+    }
+
+    // Claims a free slot for this process; nullptr if all are taken
+    shm_holder_slot* claim_slot() noexcept
+    {
+        const std::int32_t self = static_cast<std::int32_t>(getpid());
+        for (std::uint32_t i = 0; i < holder_count; ++i)
+        {
+            std::int32_t expected = 0;
+            if (slots()[i].pid.compare_exchange_strong(expected, self, std::memory_order_seq_cst))
+            {
+                return &slots()[i];
+            }
+        }
+        return nullptr;
+    }
+
+    // Optimistic increment + marked check + rollback, on the caller's slot
+    bool try_register(shm_holder_slot& slot) noexcept
+    {
+        slot.refs.fetch_add(1, std::memory_order_seq_cst);
+        if (marked.load(std::memory_order_seq_cst) != 0)
+        {
+            slot.refs.fetch_sub(1, std::memory_order_seq_cst);
+            return false;
+        }
+        return true;
+    }
+
+    std::size_t ref_count() noexcept
+    {
+        std::size_t total = 0;
+        for (std::uint32_t i = 0; i < holder_count; ++i)
+        {
+            total += slots()[i].refs.load(std::memory_order_seq_cst);
+        }
+        return total;
+    }
+};
+
+}  // namespace detail
+
+// =============================================================================
+// shm_reference - A borrow of the object in a shared segment
+// =============================================================================
+template <typename T, template <typename> class OptionalT = std::optional>
+class shm_reference
+{
+public:
+    shm_reference(shm_reference&& other) noexcept
+        : base_(std::exchange(other.base_, nullptr))
+        , slot_(std::exchange(other.slot_, nullptr))
+        , offset_(other.offset_)
+    {
+    }
+
+    ~shm_reference()
+    {
+        if (slot_ != nullptr)
+        {
+            slot_->refs.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    shm_reference(const shm_reference&)            = delete;
+    shm_reference& operator=(const shm_reference&) = delete;
+    shm_reference& operator=(shm_reference&&)      = delete;
+
+    T& get() const noexcept
+    {
+        return *std::launder(reinterpret_cast<T*>(base_ + offset_));
+    }
+    T& operator*() const noexcept
+    {
+        return get();
+    }
+    T* operator->() const noexcept
+    {
+        return &get();
+    }
+
+    // Position of the object in the segment, valid in every process
+    std::size_t offset() const noexcept
+    {
+        return offset_;
+    }
+
+private:
+    template <typename U, template <typename> class Opt>
+    friend class shm_ref_owner;
+    template <typename U, template <typename> class Opt>
+    friend class shm_borrower;
+
+    shm_reference(unsigned char* base, detail::shm_holder_slot* slot, std::size_t offset) noexcept
+        : base_(base)
+        , slot_(slot)
+        , offset_(offset)
+    {
+    }
+
+    unsigned char*           base_;  // This process's mapping
+    detail::shm_holder_slot* slot_;
+    std::size_t              offset_;
+};
+
+// =============================================================================
+// shm_ref_owner - Creates and deletes the object in a shared segment
+// =============================================================================
+template <typename T, template <typename> class OptionalT = std::optional>
+class shm_ref_owner
+{
+    static_assert(std::is_trivially_copyable<T>::value, "T is read through other processes' mappings");
+
+public:
+    using reference = shm_reference<T, OptionalT>;
+
+    static constexpr std::uint32_t default_holder_count = 64;
+
+    // Segment size for T with holder_count holders (the owner included)
+    static constexpr std::size_t required_size(std::uint32_t holder_count = default_holder_count) noexcept
+    {
+        return object_offset(holder_count) + sizeof(T);
+    }
+
+    // Lays out the segment with room for holder_count holders (the owner
+    // included). No object is published until rearm(). The segment must be
+    // at least required_size(holder_count) bytes and outlive the owner;
+    // check operator bool for failure.
+    explicit shm_ref_owner(shared_segment& segment, std::uint32_t holder_count = default_holder_count) noexcept
+    {
+        if (!segment || holder_count == 0 || segment.size() < required_size(holder_count))
+        {
+            return;
+        }
+        auto* base   = static_cast<unsigned char*>(segment.data());
+        auto* header = ::new (base) detail::shm_header;
+        header->object_size   = sizeof(T);
+        header->object_offset = static_cast<std::uint32_t>(object_offset(holder_count));
+        header->holder_count  = holder_count;
+        header->marked.store(1, std::memory_order_relaxed);
+        header->deleted.store(1, std::memory_order_relaxed);
+        header->generation.store(0, std::memory_order_relaxed);
+        for (std::uint32_t i = 0; i < holder_count; ++i)
+        {
+            detail::shm_holder_slot* slot = ::new (&header->slots()[i]) detail::shm_holder_slot;
+            slot->pid.store(0, std::memory_order_relaxed);
+            slot->refs.store(0, std::memory_order_relaxed);
+        }
+        base_   = base;
+        header_ = header;
+        slot_   = header->claim_slot();
+        header->magic.store(detail::shm_header::magic_value, std::memory_order_release);
+    }
+
+    // Marks and deletes; references still held are a contract violation
+    ~shm_ref_owner()
+    {
+        if (header_ == nullptr)
+        {
+            return;
+        }
+        if (!is_deleted())
+        {
+            const bool deleted = mark_and_delete_if_ready();
+            assert(deleted && "shm_ref_owner destroyed with outstanding references");
+            static_cast<void>(deleted);
+        }
+        slot_->pid.store(0, std::memory_order_seq_cst);
+    }
+
+    shm_ref_owner(const shm_ref_owner&)            = delete;
+    shm_ref_owner& operator=(const shm_ref_owner&) = delete;
+
+    explicit operator bool() const noexcept
+    {
+        return header_ != nullptr;
+    }
+
+    // Constructs T(args...) in the segment and publishes it. Returns false
+    // (constructing nothing) while the previous object is not deleted.
+    template <typename... Args>
+    bool rearm(Args&&... args) noexcept(std::is_nothrow_constructible<T, Args&&...>::value)
+    {
+        if (header_->deleted.load(std::memory_order_seq_cst) == 0)
+        {
+            return false;
+        }
+        ::new (base_ + header_->object_offset) T(std::forward<Args>(args)...);
+        header_->generation.fetch_add(1, std::memory_order_seq_cst);
+        header_->deleted.store(0, std::memory_order_seq_cst);
+        // Unmarking last publishes the object to borrowers
+        header_->marked.store(0, std::memory_order_seq_cst);
+        return true;
+    }
+
+    OptionalT<reference> try_make_ref() noexcept
+    {
+        if (!header_->try_register(*slot_))
+        {
+            return {};
+        }
+        return OptionalT<reference>(reference(base_, slot_, header_->object_offset));
+    }
+
+    void mark_for_deletion() noexcept
+    {
+        header_->marked.store(1, std::memory_order_seq_cst);
+    }
+
+    // Deletes the object if marked and no holder has references
+    bool delete_if_deleteable() noexcept
+    {
+        if (header_->marked.load(std::memory_order_seq_cst) == 0 || header_->ref_count() != 0)
+        {
+            return false;
+        }
+        std::uint32_t expected = 0;
+        if (!header_->deleted.compare_exchange_strong(expected, 1, std::memory_order_seq_cst))
+        {
+            return false;
+        }
+        std::launder(reinterpret_cast<T*>(base_ + header_->object_offset))->~T();
+        return true;
+    }
+
+    bool mark_and_delete_if_ready() noexcept
+    {
+        mark_for_deletion();
+        return delete_if_deleteable();
+    }
+
+    // Drops the slots of holders whose process has exited, releasing the
+    // references they held. Returns the number of references released.
+    std::size_t reclaim_dead_holders() noexcept
+    {
+        std::size_t released = 0;
+        for (std::uint32_t i = 0; i < header_->holder_count; ++i)
+        {
+            detail::shm_holder_slot& slot = header_->slots()[i];
+            const std::int32_t       pid  = slot.pid.load(std::memory_order_seq_cst);
+            if (pid != 0 && kill(static_cast<pid_t>(pid), 0) != 0 && errno == ESRCH)
+            {
+                released += slot.refs.exchange(0, std::memory_order_seq_cst);
+                slot.pid.store(0, std::memory_order_seq_cst);
+            }
+        }
+        return released;
+    }
+
+    bool is_marked_for_deletion() const noexcept
+    {
+        return header_->marked.load(std::memory_order_seq_cst) != 0;
+    }
+
+    bool is_deleted() const noexcept
+    {
+        return header_->deleted.load(std::memory_order_seq_cst) != 0;
+    }
+
+    // References held by every process
+    std::size_t ref_count() const noexcept
+    {
+        return header_->ref_count();
+    }
+
+    // Incremented by every rearm()
+    std::uint64_t generation() const noexcept
+    {
+        return header_->generation.load(std::memory_order_seq_cst);
+    }
+
+    // The object in this process's mapping
+    T* get() const noexcept
+    {
+        return is_deleted() ? nullptr : std::launder(reinterpret_cast<T*>(base_ + header_->object_offset));
+    }
+
+private:
+    static constexpr std::size_t object_offset(std::uint32_t holder_count) noexcept
+    {
+        const std::size_t align = alignof(T) > 64 ? alignof(T) : 64;
+        const std::size_t end   = sizeof(detail::shm_header) + holder_count * sizeof(detail::shm_holder_slot);
+        return (end + align - 1) / align * align;
+    }
+
+    unsigned char*           base_   = nullptr;
+    detail::shm_header*      header_ = nullptr;
+    detail::shm_holder_slot* slot_   = nullptr;
+};
+
+// =============================================================================
+// shm_borrower - Borrows the object of a segment laid out by shm_ref_owner
+// =============================================================================
+template <typename T, template <typename> class OptionalT = std::optional>
+class shm_borrower
+{
+public:
+    using reference = shm_reference<T, OptionalT>;
+
+    // Attaches to segment and claims a holder slot. Fails (operator bool
+    // false) if the segment was not laid out for T or every slot is taken.
+    explicit shm_borrower(shared_segment& segment) noexcept
+    {
+        if (!segment || segment.size() < sizeof(detail::shm_header))
+        {
+            return;
+        }
+        auto* base   = static_cast<unsigned char*>(segment.data());
+        auto* header = std::launder(reinterpret_cast<detail::shm_header*>(base));
+        if (header->magic.load(std::memory_order_acquire) != detail::shm_header::magic_value ||
+            header->object_size != sizeof(T) || segment.size() < header->object_offset + sizeof(T))
+        {
+            return;
+        }
+        slot_ = header->claim_slot();
+        if (slot_ != nullptr)
+        {
+            base_   = base;
+            header_ = header;
+        }
+    }
+
+    // References taken through this borrower must have been released
+    ~shm_borrower()
+    {
+        if (slot_ != nullptr)
+        {
+            assert(slot_->refs.load(std::memory_order_seq_cst) == 0 && "shm_borrower detached with references");
+            slot_->pid.store(0, std::memory_order_seq_cst);
+        }
+    }
+
+    shm_borrower(const shm_borrower&)            = delete;
+    shm_borrower& operator=(const shm_borrower&) = delete;
+
+    explicit operator bool() const noexcept
+    {
+        return slot_ != nullptr;
+    }
+
+    // Empty if the object is marked for deletion (or not yet rearmed)
+    OptionalT<reference> try_make_ref() noexcept
+    {
+        if (slot_ == nullptr || !header_->try_register(*slot_))
+        {
+            return {};
+        }
+        return OptionalT<reference>(reference(base_, slot_, header_->object_offset));
+    }
+
+    // Generation of the object currently published
+    std::uint64_t generation() const noexcept
+    {
+        return header_ != nullptr ? header_->generation.load(std::memory_order_seq_cst) : 0;
+    }
+
+private:
+    unsigned char*           base_   = nullptr;
+    detail::shm_header*      header_ = nullptr;
+    detail::shm_holder_slot* slot_   = nullptr;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_SHARED_MEMORY_OWNER_H
@@ -0,0 +1,251 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Allocation-free std::shared_ptr aliases of ref_owner-managed objects
+ */
+#ifndef ZOOX_SHARED_PTR_BRIDGE_H
+#define ZOOX_SHARED_PTR_BRIDGE_H
+
+// =============================================================================
+// zoox::shared_ptr_bridge - Lend a borrowed object to std::shared_ptr APIs
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Third-party APIs that take std::shared_ptr<T> can be handed a borrowed
+// object by wrapping a unique_reference in a shared_ptr that releases it.
+// Done directly, every call heap-allocates a shared_ptr control block.
+//
+// shared_ptr_bridge keeps Capacity control blocks preallocated:
+//
+//   - try_share(owner) registers one reference and builds the shared_ptr
+//     with std::allocate_shared, whose allocator hands out a pooled block.
+//     The unique_reference lives inside the control block; the returned
+//     shared_ptr aliases the owner's object.
+//   - Copies of the shared_ptr share that block. Dropping the last one
+//     destroys the unique_reference (releasing the one registered
+//     reference) and returns the block to the pool.
+//
+// Blocks are recycled through the same lock-free free list as
+// ref_owner_pool, with a small per-thread cache, so a shared_ptr may be
+// dropped on any thread. No heap allocation happens after construction.
+//
+// BASIC USAGE
+// -----------
+//
+//   static zoox::shared_ptr_bridge<PointCloud> bridge;
+//
+//   std::shared_ptr<PointCloud> cloud = bridge.try_share(cloud_owner);
+//   if (cloud) {
+//       third_party::filter(cloud);             // May copy and keep it
+//   }
+//
+//   // While any copy is alive the owner has a reference outstanding, so
+//   // mark_and_delete_if_ready() reports it like any other late borrower.
+//
+// try_share() returns an empty shared_ptr if the owner is marked for deletion
+// or every block is in use. The bridge must outlive the shared_ptrs it made.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+#include "zoox/ref_owner_pool.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace zoox
+{
+namespace detail
+{
+
+// Allocator handing std::allocate_shared the block reserved for it
+template <typename U, typename Bridge>
+class bridge_block_allocator
+{
+public:
+    using value_type = U;
+
+    bridge_block_allocator(Bridge* bridge, std::uint32_t block) noexcept
+        : bridge_(bridge)
+        , block_(block)
+    {
+    }
+
+    template <typename V>
+    bridge_block_allocator(const bridge_block_allocator<V, Bridge>& other) noexcept
+        : bridge_(other.bridge_)
+        , block_(other.block_)
+    {
+    }
+
+    U* allocate(std::size_t n) noexcept
+    {
+        static_assert(sizeof(U) <= Bridge::block_size && alignof(U) <= Bridge::block_align,
+                      "shared_ptr control block does not fit the bridge's blocks");
+        assert(n == 1);
+        static_cast<void>(n);
+        return static_cast<U*>(bridge_->block_data(block_));
+    }
+
+    void deallocate(U* p, std::size_t) noexcept
+    {
+        bridge_->release_block(p);
+    }
+
+    template <typename V>
+    bool operator==(const bridge_block_allocator<V, Bridge>& other) const noexcept
+    {
+        return bridge_ == other.bridge_;
+    }
+
+    template <typename V>
+    bool operator!=(const bridge_block_allocator<V, Bridge>& other) const noexcept
+    {
+        return bridge_ != other.bridge_;
+    }
+
+private:
+    template <typename V, typename B>
+    friend class bridge_block_allocator;
+
+    Bridge*       bridge_;
+    std::uint32_t block_;
+};
+
+}  // namespace detail
+
+template <typename T,
+          template <typename> class OptionalT = std::optional,
+          typename Deleter                    = std::default_delete<T>,
+          std::size_t Capacity                = 64,
+          std::size_t ThreadCacheSize         = 8>
+class shared_ptr_bridge
+{
+public:
+    using owner_type = ref_owner<T, OptionalT, Deleter>;
+    using reference  = unique_reference<T, T, OptionalT, Deleter>;
+
+    static constexpr std::size_t block_size  = 64;
+    static constexpr std::size_t block_align = alignof(std::max_align_t);
+
+    shared_ptr_bridge() noexcept = default;
+
+    // Every shared_ptr made by the bridge must be gone
+    ~shared_ptr_bridge()
+    {
+        assert(in_use() == 0 && "shared_ptr_bridge destroyed with shared_ptrs outstanding");
+    }
+
+    // Non-copyable, non-movable (control blocks point back at the bridge)
+    shared_ptr_bridge(const shared_ptr_bridge&)            = delete;
+    shared_ptr_bridge& operator=(const shared_ptr_bridge&) = delete;
+    shared_ptr_bridge(shared_ptr_bridge&&)                 = delete;
+    shared_ptr_bridge& operator=(shared_ptr_bridge&&)      = delete;
+
+    // Registers a reference on owner and returns a shared_ptr holding it.
+    // Element may be T or const T. Empty if owner is marked for deletion or
+    // no block is free.
+    template <typename Element = T>
+    std::shared_ptr<Element> try_share(owner_type& owner) noexcept
+    {
+        const std::uint32_t block = free_.acquire();
+        if (block == free_list::empty_index)
+        {
+            return {};
+        }
+        auto ref = owner.try_make_ref();
+        if (!ref)
+        {
+            free_.release(block);
+            return {};
+        }
+        return adopt<Element>(block, std::move(*ref));
+    }
+
+    // Moves ref into a shared_ptr. Empty (leaving ref with the caller) if no
+    // block is free.
+    template <typename Element = T>
+    std::shared_ptr<Element> share(reference&& ref) noexcept
+    {
+        const std::uint32_t block = free_.acquire();
+        if (block == free_list::empty_index)
+        {
+            return {};
+        }
+        return adopt<Element>(block, std::move(ref));
+    }
+
+    // Control blocks held by live shared_ptrs (or weak_ptrs)
+    std::size_t in_use() const noexcept
+    {
+        return in_use_.load(std::memory_order_relaxed);
+    }
+
+    static constexpr std::size_t capacity() noexcept
+    {
+        return Capacity;
+    }
+
+private:
+    template <typename U, typename Bridge>
+    friend class detail::bridge_block_allocator;
+
+    using free_list = detail::slot_free_list<Capacity, ThreadCacheSize>;
+
+    // Constructed inside the control block; destroying it releases the reference
+    struct holder
+    {
+        explicit holder(reference&& r) noexcept
+            : ref(std::move(r))
+        {
+        }
+
+        reference ref;
+    };
+
+    template <typename Element>
+    std::shared_ptr<Element> adopt(std::uint32_t block, reference&& ref) noexcept
+    {
+        static_assert(std::is_same<typename std::remove_const<Element>::type, T>::value, "Element is T or const T");
+        in_use_.fetch_add(1, std::memory_order_relaxed);
+        std::shared_ptr<holder> held = std::allocate_shared<holder>(
+            detail::bridge_block_allocator<holder, shared_ptr_bridge>(this, block), std::move(ref));
+        Element* object = &held->ref.get();
+        return std::shared_ptr<Element>(std::move(held), object);
+    }
+
+    void* block_data(std::uint32_t block) noexcept
+    {
+        return blocks_[block].bytes;
+    }
+
+    void release_block(void* p) noexcept
+    {
+        const auto* first = &blocks_[0];
+        const auto  block = static_cast<std::uint32_t>(static_cast<const block_storage*>(p) - first);
+        free_.release(block);
+        in_use_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    struct block_storage
+    {
+        alignas(block_align) unsigned char bytes[block_size];
+    };
+
+    free_list                free_;
+    block_storage            blocks_[Capacity];
+    std::atomic<std::size_t> in_use_{0};
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_SHARED_PTR_BRIDGE_H
@@ -0,0 +1,95 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Dense per-thread indices for per-thread caches and buffers
+ */
+#ifndef ZOOX_THREAD_INDEX_REGISTRY_H
+#define ZOOX_THREAD_INDEX_REGISTRY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace zoox
+{
+namespace detail
+{
+
+constexpr std::size_t max_cached_threads = 64;
+constexpr std::size_t no_thread_index    = std::numeric_limits<std::size_t>::max();
+
+// Process-wide allocator of small dense thread indices. An index is held for
+// the lifetime of the thread and recycled when the thread exits, so at most
+// one live thread uses a given per-pool cache at a time.
+class thread_index_registry
+{
+public:
+    static std::size_t current() noexcept
+    {
+        thread_local const thread_index_holder holder;
+        return holder.index;
+    }
+
+private:
+    struct thread_index_holder
+    {
+        thread_index_holder() noexcept
+            : index(acquire())
+        {
+        }
+        ~thread_index_holder()
+        {
+            release(index);
+        }
+        thread_index_holder(const thread_index_holder&)            = delete;
+        thread_index_holder& operator=(const thread_index_holder&) = delete;
+
+        std::size_t index;
+    };
+
+    static std::atomic<std::uint64_t>& in_use() noexcept
+    {
+        static std::atomic<std::uint64_t> bits{0};
+        return bits;
+    }
+
+    static std::size_t acquire() noexcept
+    {
+        std::uint64_t current = in_use().load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (~current == 0)
+            {
+                return no_thread_index;
+            }
+            std::size_t index = 0;
+            while ((current & (std::uint64_t{1} << index)) != 0)
+            {
+                ++index;
+            }
+            if (in_use().compare_exchange_weak(
+                    current, current | (std::uint64_t{1} << index), std::memory_order_acq_rel))
+            {
+                return index;
+            }
+        }
+    }
+
+    static void release(std::size_t index) noexcept
+    {
+        if (index != no_thread_index)
+        {
+            in_use().fetch_and(~(std::uint64_t{1} << index), std::memory_order_acq_rel);
+        }
+    }
+};
+
+static_assert(max_cached_threads == 64, "thread_index_registry uses a single 64-bit mask");
+
+}  // namespace detail
+}  // namespace zoox
+
+#endif  // ZOOX_THREAD_INDEX_REGISTRY_H
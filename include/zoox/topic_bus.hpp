@@ -0,0 +1,459 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Zero-copy publish/subscribe bus that fans out unique_references
+ */
+#ifndef ZOOX_TOPIC_BUS_H
+#define ZOOX_TOPIC_BUS_H
+
+// =============================================================================
+// zoox::topic_bus - Publish once, borrow everywhere
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// A topic with any number of subscribers. publish() constructs the message
+// once, in a ref_owner, and hands every subscriber a unique_reference to it:
+//
+//   1. The owner registers one reference per subscriber with a single
+//      increment (ref_owner::try_make_refs).
+//   2. Each reference is moved into its subscriber's mpmc_channel (a
+//      lock-free bounded queue; see zoox/reference_channel.hpp).
+//   3. The owner is marked for deletion. It accepts no further borrows and
+//      is freed once every subscriber has released its reference.
+//
+// The cost of a publish is one allocation plus one queue push per
+// subscriber, independent of the message size. A subscriber whose queue is
+// full misses the message: its reference is released on the spot and the
+// miss is counted (subscription::dropped()).
+//
+// BASIC USAGE
+// -----------
+//
+//   zoox::topic_bus<PointCloud> lidar;
+//
+//   auto sub = lidar.subscribe();               // Unsubscribes when destroyed
+//
+//   lidar.publish(std::move(cloud));            // Any thread
+//
+//   while (auto msg = sub.try_receive()) {      // unique_reference<const PointCloud, ...>
+//       process(**msg);
+//   }
+//
+//   lidar.reclaim();                            // At the frame's cleanup phase
+//
+// RECLAMATION
+// -----------
+// Published messages wait on a lock-free list until reclaim() frees the ones
+// whose references have all been released. reclaim() is meant to run at a
+// fixed phase of the caller's frame loop, so message destructors run there
+// and not on a subscriber's thread. topic_bus_options::reclaim_interval
+// additionally lets publish() reclaim every N publishes (skipped if another
+// thread is already reclaiming).
+//
+// publish() reads the subscriber table without locking inside a
+// reader_epoch section (zoox/reader_epoch.hpp); subscribe() and unsubscribe
+// replace the table under a mutex and free the old table, and a removed
+// subscriber's queue, once the grace period has passed. References a
+// publisher pushed into a removed queue are released when the queue is
+// freed.
+//
+// Subscriptions must be destroyed before their bus. Messages still borrowed
+// when the bus is destroyed follow ref_owner's destructor policy.
+//
+// =============================================================================
+
+#include "zoox/memory_w_ref_owner.hpp"
+#include "zoox/reader_epoch.hpp"
+#include "zoox/reference_channel.hpp"
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace zoox
+{
+
+struct topic_bus_options
+{
+    // publish() reclaims every reclaim_interval publishes; 0 leaves
+    // reclamation to explicit reclaim() calls
+    std::size_t reclaim_interval = 0;
+};
+
+struct publish_result
+{
+    std::size_t delivered = 0;  // Subscribers whose queue took the message
+    std::size_t dropped   = 0;  // Subscribers whose queue was full
+};
+
+template <typename T, template <typename> class OptionalT = std::optional, std::size_t QueueCapacity = 256>
+class topic_bus
+{
+public:
+    using owner_type = ref_owner<T, OptionalT, destruct_only<T>>;
+    using reference  = unique_reference<const T, T, OptionalT, destruct_only<T>>;
+
+private:
+    struct subscriber_queue
+    {
+        mpmc_channel<reference, QueueCapacity> channel;
+        std::atomic<std::size_t>               dropped{0};
+    };
+
+public:
+    // A subscriber's end of the topic. Move-only; unsubscribes on destruction.
+    class subscription
+    {
+    public:
+        subscription(subscription&& other) noexcept
+            : bus_(other.bus_)
+            , queue_(other.queue_)
+        {
+            other.bus_   = nullptr;
+            other.queue_ = nullptr;
+        }
+
+        ~subscription()
+        {
+            reset();
+        }
+
+        subscription(const subscription&)            = delete;
+        subscription& operator=(const subscription&) = delete;
+        subscription& operator=(subscription&&)      = delete;
+
+        explicit operator bool() const noexcept
+        {
+            return queue_ != nullptr;
+        }
+
+        // Next message, or empty if none is queued
+        OptionalT<reference> try_receive() noexcept
+        {
+            return queue_ != nullptr ? queue_->channel.try_pop() : OptionalT<reference>();
+        }
+
+        // Blocks until a message arrives. Returns empty once the bus is
+        // closed and this subscriber's queue has drained.
+        OptionalT<reference> receive()
+        {
+            return queue_ != nullptr ? queue_->channel.pop() : OptionalT<reference>();
+        }
+
+        // Receives up to max messages, passing each to out(reference&&).
+        // Returns how many were received. If out throws, the rest of the
+        // batch is dropped (see mpmc_channel::try_pop_n).
+        template <typename Out>
+        std::size_t try_receive_n(Out&& out, std::size_t max)
+        {
+            return queue_ != nullptr ? queue_->channel.try_pop_n(std::forward<Out>(out), max) : 0;
+        }
+
+        // Messages queued for this subscriber (a snapshot)
+        std::size_t pending() const noexcept
+        {
+            return queue_ != nullptr ? queue_->channel.size() : 0;
+        }
+
+        // Messages missed because the queue was full
+        std::size_t dropped() const noexcept
+        {
+            return queue_ != nullptr ? queue_->dropped.load(std::memory_order_relaxed) : 0;
+        }
+
+        // Unsubscribes; messages still queued are released once no
+        // publisher can be pushing to the queue
+        void reset() noexcept
+        {
+            if (queue_ != nullptr)
+            {
+                bus_->unsubscribe(queue_);
+                bus_   = nullptr;
+                queue_ = nullptr;
+            }
+        }
+
+    private:
+        friend class topic_bus;
+
+        subscription(topic_bus* bus, subscriber_queue* queue) noexcept
+            : bus_(bus)
+            , queue_(queue)
+        {
+        }
+
+        topic_bus*        bus_;
+        subscriber_queue* queue_;
+    };
+
+    explicit topic_bus(const topic_bus_options& options = topic_bus_options())
+        : options_(options)
+        , table_(new subscriber_table())
+    {
+    }
+
+    // Messages still borrowed follow ref_owner's destructor policy
+    ~topic_bus() noexcept(std::is_nothrow_destructible<owner_type>::value)
+    {
+        assert(queues_.empty() && "topic_bus destroyed with live subscriptions");
+        for (subscriber_queue* queue : queues_)
+        {
+            delete queue;
+        }
+        for (const retired& r : retired_)
+        {
+            delete r.table;
+            delete r.queue;
+        }
+        delete table_.load(std::memory_order_relaxed);
+        for (message* m = messages_.exchange(nullptr, std::memory_order_acquire); m != nullptr;)
+        {
+            message* next = m->next;
+            m->owner.delete_if_deleteable();
+            delete m;
+            m = next;
+        }
+    }
+
+    // Non-copyable, non-movable (subscriptions and references point into the bus)
+    topic_bus(const topic_bus&)            = delete;
+    topic_bus& operator=(const topic_bus&) = delete;
+    topic_bus(topic_bus&&)                 = delete;
+    topic_bus& operator=(topic_bus&&)      = delete;
+
+    subscription subscribe()
+    {
+        std::lock_guard<std::mutex>       lock(write_mutex_);
+        std::unique_ptr<subscriber_queue> queue(new subscriber_queue());
+        std::unique_ptr<subscriber_table> table(new subscriber_table{queues_});
+        table->queues.push_back(queue.get());
+        queues_.reserve(queues_.size() + 1);
+        // Every live subscription keeps a retired_ slot for its unsubscribe
+        retired_.reserve(retired_.size() + queues_.size() + 2);
+
+        if (closed_.load(std::memory_order_relaxed))
+        {
+            queue->channel.close();
+        }
+        queues_.push_back(queue.get());
+        publish_table_locked(table.release(), nullptr);
+        return subscription(this, queue.release());
+    }
+
+    // Constructs T(args...) once and delivers a reference to every current
+    // subscriber. Constructs nothing if there are no subscribers or the bus
+    // is closed.
+    template <typename... Args>
+    publish_result publish(Args&&... args)
+    {
+        publish_result result;
+        {
+            detail::reader_epoch::section section(epoch_);
+            const subscriber_table*       table = table_.load(std::memory_order_seq_cst);
+            const std::size_t             count = table->queues.size();
+            if (count == 0 || closed_.load(std::memory_order_acquire))
+            {
+                return result;
+            }
+            message*    m    = new message(std::forward<Args>(args)...);
+            std::size_t next = 0;
+            m->owner.try_make_refs(count,
+                                   [&](unique_reference<T, T, OptionalT, destruct_only<T>>&& ref)
+                                   {
+                                       subscriber_queue* queue = table->queues[next++];
+                                       if (queue->channel.try_push(reference(std::move(ref))))
+                                       {
+                                           ++result.delivered;
+                                       }
+                                       else
+                                       {
+                                           ++result.dropped;
+                                           queue->dropped.fetch_add(1, std::memory_order_relaxed);
+                                       }
+                                   });
+            m->owner.mark_for_deletion();
+            retire(m);
+        }
+        if (options_.reclaim_interval != 0 &&
+            published_.fetch_add(1, std::memory_order_relaxed) % options_.reclaim_interval ==
+                options_.reclaim_interval - 1)
+        {
+            std::unique_lock<std::mutex> lock(write_mutex_, std::try_to_lock);
+            if (lock.owns_lock())
+            {
+                reclaim_locked();
+            }
+        }
+        return result;
+    }
+
+    // Frees published messages that every subscriber has released, and
+    // removed subscriber queues past their grace period. Returns the number
+    // of messages still borrowed.
+    std::size_t reclaim()
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        return reclaim_locked();
+    }
+
+    // Wakes blocked receivers; later publishes deliver nothing
+    void close() noexcept
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        closed_.store(true, std::memory_order_release);
+        for (subscriber_queue* queue : queues_)
+        {
+            queue->channel.close();
+        }
+    }
+
+    bool is_closed() const noexcept
+    {
+        return closed_.load(std::memory_order_acquire);
+    }
+
+    std::size_t subscriber_count() const noexcept
+    {
+        detail::reader_epoch::section section(epoch_);
+        return table_.load(std::memory_order_seq_cst)->queues.size();
+    }
+
+private:
+    // ref_owner with the message stored inline, linked on the published list
+    struct message
+    {
+        template <typename... Args>
+        explicit message(Args&&... args)
+            : owner(new (storage) T(std::forward<Args>(args)...))
+        {
+        }
+
+        owner_type owner;
+        alignas(T) unsigned char storage[sizeof(T)];
+        message* next = nullptr;
+    };
+
+    // Immutable snapshot read by publishers
+    struct subscriber_table
+    {
+        std::vector<subscriber_queue*> queues;
+    };
+
+    struct retired
+    {
+        subscriber_table* table;
+        subscriber_queue* queue;
+        std::uint64_t     epoch;
+    };
+
+    // Allocates the replacement table; failing to do so terminates
+    void unsubscribe(subscriber_queue* queue) noexcept
+    {
+        std::lock_guard<std::mutex> lock(write_mutex_);
+        for (std::size_t i = 0; i < queues_.size(); ++i)
+        {
+            if (queues_[i] == queue)
+            {
+                queues_.erase(queues_.begin() + static_cast<std::ptrdiff_t>(i));
+                break;
+            }
+        }
+        queue->channel.close();
+        publish_table_locked(new subscriber_table{queues_}, queue);
+    }
+
+    // Swaps in table and retires the old one, together with removed_queue
+    // if not null. subscribe() has reserved the retired_ slot.
+    void publish_table_locked(subscriber_table* table, subscriber_queue* removed_queue) noexcept
+    {
+        subscriber_table* old = table_.exchange(table, std::memory_order_seq_cst);
+        retired_.push_back(retired{old, removed_queue, epoch_.current()});
+        reclaim_locked();
+    }
+
+    void retire(message* m) noexcept
+    {
+        message* head = messages_.load(std::memory_order_relaxed);
+        do
+        {
+            m->next = head;
+        } while (!messages_.compare_exchange_weak(head, m, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    std::size_t reclaim_locked() noexcept
+    {
+        if (!retired_.empty())
+        {
+            const std::uint64_t epoch = epoch_.advance();
+            std::size_t         kept  = 0;
+            for (const retired& r : retired_)
+            {
+                if (detail::reader_epoch::grace_elapsed(r.epoch, epoch))
+                {
+                    delete r.table;
+                    delete r.queue;
+                }
+                else
+                {
+                    retired_[kept++] = r;
+                }
+            }
+            retired_.resize(kept);
+        }
+
+        message*    borrowed = nullptr;
+        message*    tail     = nullptr;
+        std::size_t pending  = 0;
+        for (message* m = messages_.exchange(nullptr, std::memory_order_acquire); m != nullptr;)
+        {
+            message* next = m->next;
+            if (m->owner.delete_if_deleteable())
+            {
+                delete m;
+            }
+            else
+            {
+                m->next  = borrowed;
+                borrowed = m;
+                tail     = tail != nullptr ? tail : m;
+                ++pending;
+            }
+            m = next;
+        }
+        if (borrowed != nullptr)
+        {
+            message* head = messages_.load(std::memory_order_relaxed);
+            do
+            {
+                tail->next = head;
+            } while (!messages_.compare_exchange_weak(head, borrowed, std::memory_order_release,
+                                                      std::memory_order_relaxed));
+        }
+        return pending;
+    }
+
+    topic_bus_options              options_;
+    mutable detail::reader_epoch   epoch_;
+    std::atomic<subscriber_table*> table_;
+    std::atomic<message*>          messages_{nullptr};
+    std::atomic<std::size_t>       published_{0};
+    std::atomic<bool>              closed_{false};
+    std::mutex                     write_mutex_;
+    std::vector<subscriber_queue*> queues_;
+    std::vector<retired>           retired_;
+};
+
+}  // namespace zoox
+
+#endif  // ZOOX_TOPIC_BUS_H
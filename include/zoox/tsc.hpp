@@ -0,0 +1,42 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief Cheap timestamp counter read for event records
+ */
+#ifndef ZOOX_TSC_H
+#define ZOOX_TSC_H
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#    include <x86intrin.h>
+#endif
+
+namespace zoox
+{
+namespace detail
+{
+
+// Cycle counter where the CPU has a cheap one, steady_clock nanoseconds elsewhere
+inline std::uint64_t read_tsc() noexcept
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    std::uint64_t ticks;
+    __asm__ __volatile__("mrs %0, cntvct_el0" : "=r"(ticks));
+    return ticks;
+#else
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                          std::chrono::steady_clock::now().time_since_epoch())
+                                          .count());
+#endif
+}
+
+}  // namespace detail
+}  // namespace zoox
+
+#endif  // ZOOX_TSC_H
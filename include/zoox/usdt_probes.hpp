@@ -0,0 +1,139 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+/**
+ * @file
+ * @brief USDT (SystemTap SDT) static probe macros for perf and bpftrace
+ */
+#ifndef ZOOX_USDT_PROBES_H
+#define ZOOX_USDT_PROBES_H
+
+// =============================================================================
+// ZOOX_PROBEn - Static tracepoints visible to perf, bpftrace and SystemTap
+// =============================================================================
+//
+// OVERVIEW
+// --------
+// Each probe site compiles to a single nop plus an entry in the binary's
+// .note.stapsdt section that records the nop's address and where each
+// argument lives (register, stack slot or constant). Nothing runs unless a
+// tracer is attached, in which case the tracer patches the nop into a trap.
+//
+// The note layout is the SystemTap SDT v3 format used by <sys/sdt.h>; it is
+// emitted here directly so the probes exist even where systemtap-sdt-dev is
+// not installed.
+//
+// ref_owner probes (provider "zoox"):
+//
+//   ref_register   owner, previous count, succeeded (shared and exclusive)
+//   refs_register  owner, count requested, succeeded
+//   ref_release    owner, previous count (exclusive_ref_flag set when an
+//                  exclusive borrow is released). Only for references that
+//                  were handed out: rolling back a failed ref_register or
+//                  refs_register fires nothing further.
+//   mark           owner, count at mark
+//   delete         owner, count, outcome (ref_owner_delete_outcome)
+//   wait_begin     owner, count when the wait started
+//   wait_end       owner, deleted
+//   notify         owner
+//
+// LISTING AND TRACING
+// -------------------
+//
+//   readelf -n ./app | grep -A2 stapsdt
+//   perf probe -x ./app sdt_zoox:ref_release && perf record -e sdt_zoox:ref_release ...
+//   bpftrace -e 'usdt:./app:zoox:mark { @t[arg0] = nsecs }
+//                usdt:./app:zoox:delete /arg2 == 0/ { @drain = hist(nsecs - @t[arg0]) }'
+//
+// Define ZOOX_DISABLE_PROBES to compile the probes out entirely. They are
+// also compiled out on targets other than x86-64 and AArch64 Linux with a
+// GCC-compatible compiler.
+//
+// =============================================================================
+
+#include <cstdint>
+#include <type_traits>
+
+#if !defined(ZOOX_DISABLE_PROBES) && defined(__linux__) && defined(__GNUC__) && \
+    (defined(__x86_64__) || defined(__aarch64__))
+#    define ZOOX_PROBES_ENABLED 1
+#else
+#    define ZOOX_PROBES_ENABLED 0
+#endif
+
+namespace zoox
+{
+namespace detail
+{
+
+// Probe arguments are passed as 8-byte unsigned values
+inline std::uint64_t probe_arg(const volatile void* p) noexcept
+{
+    return static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(p));
+}
+
+template <typename Integral, typename = typename std::enable_if<std::is_integral<Integral>::value ||
+                                                                std::is_enum<Integral>::value>::type>
+std::uint64_t probe_arg(Integral value) noexcept
+{
+    return static_cast<std::uint64_t>(value);
+}
+
+}  // namespace detail
+}  // namespace zoox
+
+#if ZOOX_PROBES_ENABLED
+
+// The nop, its SDT note, and (once per object file) the .stapsdt.base
+// anchor that tracers use to adjust for prelinking
+#    define ZOOX_PROBE_ASM_(provider, name, args)                                     \
+        "990: nop\n"                                                                  \
+        ".pushsection .note.stapsdt,\"?\",\"note\"\n"                                 \
+        ".balign 4\n"                                                                 \
+        ".4byte 992f-991f, 994f-993f, 3\n"                                            \
+        "991: .asciz \"stapsdt\"\n"                                                   \
+        "992: .balign 4\n"                                                            \
+        "993: .8byte 990b\n"                                                          \
+        ".8byte _.stapsdt.base\n"                                                     \
+        ".8byte 0\n"                                                                  \
+        ".asciz \"" #provider "\"\n"                                                  \
+        ".asciz \"" #name "\"\n"                                                      \
+        ".asciz \"" args "\"\n"                                                       \
+        "994: .balign 4\n"                                                            \
+        ".popsection\n"                                                               \
+        ".ifndef _.stapsdt.base\n"                                                    \
+        ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"       \
+        ".weak _.stapsdt.base\n"                                                      \
+        ".hidden _.stapsdt.base\n"                                                    \
+        "_.stapsdt.base: .space 1\n"                                                  \
+        ".size _.stapsdt.base, 1\n"                                                   \
+        ".popsection\n"                                                               \
+        ".endif\n"
+
+#    define ZOOX_PROBE1(name, a1)                                                     \
+        __asm__ __volatile__(ZOOX_PROBE_ASM_(zoox, name, "8@%0")                      \
+                             :                                                        \
+                             : "nor"(::zoox::detail::probe_arg(a1)))
+
+#    define ZOOX_PROBE2(name, a1, a2)                                                 \
+        __asm__ __volatile__(ZOOX_PROBE_ASM_(zoox, name, "8@%0 8@%1")                 \
+                             :                                                        \
+                             : "nor"(::zoox::detail::probe_arg(a1)),                  \
+                               "nor"(::zoox::detail::probe_arg(a2)))
+
+#    define ZOOX_PROBE3(name, a1, a2, a3)                                             \
+        __asm__ __volatile__(ZOOX_PROBE_ASM_(zoox, name, "8@%0 8@%1 8@%2")            \
+                             :                                                        \
+                             : "nor"(::zoox::detail::probe_arg(a1)),                  \
+                               "nor"(::zoox::detail::probe_arg(a2)),                  \
+                               "nor"(::zoox::detail::probe_arg(a3)))
+
+#else
+
+#    define ZOOX_PROBE1(name, a1) static_cast<void>(0)
+#    define ZOOX_PROBE2(name, a1, a2) static_cast<void>(0)
+#    define ZOOX_PROBE3(name, a1, a2, a3) static_cast<void>(0)
+
+#endif
+
+#endif  // ZOOX_USDT_PROBES_H
@@ -0,0 +1,150 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/allocate_ref_owner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <stdexcept>
+
+namespace zoox
+{
+namespace
+{
+
+struct Track
+{
+    static int live_count;
+
+    int id;
+
+    explicit Track(int i)
+        : id(i)
+    {
+        if (i < 0)
+        {
+            throw std::invalid_argument("negative track id");
+        }
+        ++live_count;
+    }
+    ~Track()
+    {
+        --live_count;
+    }
+};
+
+int Track::live_count = 0;
+
+// Minimal stateful allocator that counts through a shared tally
+struct AllocationTally
+{
+    int allocations   = 0;
+    int deallocations = 0;
+};
+
+template <typename T>
+struct CountingAllocator
+{
+    using value_type = T;
+
+    explicit CountingAllocator(AllocationTally* t) noexcept
+        : tally(t)
+    {
+    }
+    template <typename U>
+    CountingAllocator(const CountingAllocator<U>& other) noexcept  // NOLINT: rebinding conversion
+        : tally(other.tally)
+    {
+    }
+
+    T* allocate(std::size_t n)
+    {
+        ++tally->allocations;
+        return std::allocator<T>().allocate(n);
+    }
+    void deallocate(T* p, std::size_t n) noexcept
+    {
+        ++tally->deallocations;
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const CountingAllocator<U>& other) const noexcept
+    {
+        return tally == other.tally;
+    }
+    template <typename U>
+    bool operator!=(const CountingAllocator<U>& other) const noexcept
+    {
+        return tally != other.tally;
+    }
+
+    AllocationTally* tally;
+};
+
+class AllocateRefOwnerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Track::live_count = 0;
+    }
+};
+
+TEST_F(AllocateRefOwnerTest, DeallocatesThroughSameAllocatorOnDelete)
+{
+    AllocationTally tally;
+    auto            owner = allocate_ref_owner<Track>(CountingAllocator<char>(&tally), 7);
+    EXPECT_EQ(tally.allocations, 1);
+    EXPECT_EQ(owner->id, 7);
+    {
+        auto ref = owner.make_ref();
+        EXPECT_EQ(ref->id, 7);
+        EXPECT_EQ(tally.allocations, 1);  // References never allocate
+    }
+    EXPECT_EQ(tally.deallocations, 0);
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+    EXPECT_EQ(tally.deallocations, 1);
+    EXPECT_EQ(Track::live_count, 0);
+}
+
+#ifdef __cpp_exceptions
+TEST_F(AllocateRefOwnerTest, ConstructorFailureDeallocates)
+{
+    AllocationTally tally;
+    EXPECT_THROW(allocate_ref_owner<Track>(CountingAllocator<Track>(&tally), -1), std::invalid_argument);
+    EXPECT_EQ(tally.allocations, 1);
+    EXPECT_EQ(tally.deallocations, 1);
+}
+#endif
+
+TEST_F(AllocateRefOwnerTest, AllocateOwnedFeedsWaitableOwner)
+{
+    AllocationTally tally;
+    using deleter = allocator_deleter<Track, CountingAllocator<Track>>;
+
+    waitable_ref_owner<Track, std::optional, deleter> owner(allocate_owned<Track>(CountingAllocator<Track>(&tally), 3));
+    EXPECT_EQ(owner->id, 3);
+    owner.mark_and_wait_for_deletion();
+    EXPECT_EQ(tally.deallocations, 1);
+}
+
+#if defined(__cpp_lib_memory_resource)
+TEST_F(AllocateRefOwnerTest, PmrOwnerUsesMemoryResource)
+{
+    alignas(std::max_align_t) std::byte buffer[256];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    pmr::ref_owner<Track> owner = pmr::allocate_ref_owner<Track>(&arena, 11);
+    auto*                 addr  = reinterpret_cast<std::byte*>(owner.get());  // NOLINT: address check
+    EXPECT_GE(addr, buffer);
+    EXPECT_LT(addr, buffer + sizeof(buffer));
+
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+    EXPECT_EQ(Track::live_count, 0);
+}
+#endif
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,180 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/atomic_reference.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Frame
+{
+    int value;
+
+    explicit Frame(int v = 0)
+        : value(v)
+    {
+    }
+};
+
+struct FrameBase
+{
+    virtual ~FrameBase() = default;
+};
+
+struct DerivedFrame : FrameBase
+{
+    int value = 5;
+};
+
+TEST(AtomicReferenceTest, StoreAndTakeTransferRegistration)
+{
+    ref_owner<Frame>        owner(new Frame(42));
+    atomic_reference<Frame> slot;
+    EXPECT_FALSE(slot.has_value());
+
+    slot.store(owner.make_ref());
+    EXPECT_TRUE(slot.has_value());
+    EXPECT_EQ(slot.peek(), &owner);
+    EXPECT_EQ(owner.ref_count(), 1u);
+
+    {
+        auto ref = slot.take();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->value, 42);
+        EXPECT_EQ(owner.ref_count(), 1u);
+        EXPECT_FALSE(slot.has_value());
+        EXPECT_FALSE(slot.take().has_value());
+    }
+    EXPECT_EQ(owner.ref_count(), 0u);
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST(AtomicReferenceTest, StoreReleasesPreviousOccupant)
+{
+    ref_owner<Frame>        first(new Frame(1));
+    ref_owner<Frame>        second(new Frame(2));
+    atomic_reference<Frame> slot(first.make_ref());
+
+    slot.store(second.make_ref());
+    EXPECT_EQ(first.ref_count(), 0u);
+    EXPECT_EQ(second.ref_count(), 1u);
+
+    auto previous = slot.exchange(first.make_ref());
+    ASSERT_TRUE(previous.has_value());
+    EXPECT_EQ((*previous)->value, 2);
+    EXPECT_EQ(first.ref_count(), 1u);
+    EXPECT_EQ(second.ref_count(), 1u);
+
+    previous.reset();
+    slot.take();
+    EXPECT_TRUE(first.mark_and_delete_if_ready());
+    EXPECT_TRUE(second.mark_and_delete_if_ready());
+}
+
+TEST(AtomicReferenceTest, DestructionReleasesOccupant)
+{
+    ref_owner<Frame> owner(new Frame(42));
+    {
+        atomic_reference<Frame> slot(owner.make_ref());
+        owner.mark_for_deletion();
+        EXPECT_FALSE(owner.delete_if_deleteable());
+    }
+    EXPECT_EQ(owner.ref_count(), 0u);
+    EXPECT_TRUE(owner.delete_if_deleteable());
+}
+
+TEST(AtomicReferenceTest, CompareExchangePublishesIntoEmptySlot)
+{
+    ref_owner<Frame>        first(new Frame(1));
+    ref_owner<Frame>        second(new Frame(2));
+    atomic_reference<Frame> slot;
+
+    const ref_owner<Frame>* expected = nullptr;
+    auto                    ref1     = first.make_ref();
+    EXPECT_TRUE(slot.compare_exchange_strong(expected, std::move(ref1)));
+    EXPECT_EQ(first.ref_count(), 1u);
+
+    // Slot is occupied: fails, reports occupant, leaves desired intact
+    expected  = nullptr;
+    auto ref2 = second.make_ref();
+    EXPECT_FALSE(slot.compare_exchange_strong(expected, std::move(ref2)));
+    EXPECT_EQ(expected, &first);
+    EXPECT_EQ(ref2->value, 2);  // NOLINT: not moved-from on failure
+    EXPECT_EQ(second.ref_count(), 1u);
+
+    // Matching expected: displaced reference is released
+    EXPECT_TRUE(slot.compare_exchange_strong(expected, std::move(ref2)));
+    EXPECT_EQ(first.ref_count(), 0u);
+    EXPECT_EQ(second.ref_count(), 1u);
+
+    slot.take();
+    EXPECT_TRUE(first.mark_and_delete_if_ready());
+    EXPECT_TRUE(second.mark_and_delete_if_ready());
+}
+
+TEST(AtomicReferenceTest, WorksWithConvertedReferenceTypes)
+{
+    ref_owner<DerivedFrame>                   owner(new DerivedFrame());
+    atomic_reference<FrameBase, DerivedFrame> slot;
+    unique_reference<FrameBase, DerivedFrame> base_ref(owner.make_ref());
+
+    slot.store(std::move(base_ref));
+    auto taken = slot.take();
+    ASSERT_TRUE(taken.has_value());
+    EXPECT_NE(dynamic_cast<DerivedFrame*>(&taken->get()), nullptr);
+
+    taken.reset();
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST(AtomicReferenceTest, ConcurrentHandoffPreservesCount)
+{
+    ref_owner<Frame>        owner(new Frame(42));
+    atomic_reference<Frame> slot;
+    std::atomic<int>        received{0};
+
+    constexpr int kNumProducers = 4;
+    constexpr int kIterations   = 1000;
+
+    std::vector<std::thread> threads;
+    threads.reserve(kNumProducers * 2);
+    for (int t = 0; t < kNumProducers; ++t)
+    {
+        threads.emplace_back([&owner, &slot]() {
+            for (int i = 0; i < kIterations; ++i)
+            {
+                slot.store(owner.make_ref());
+            }
+        });
+        threads.emplace_back([&slot, &received]() {
+            for (int i = 0; i < kIterations; ++i)
+            {
+                if (auto ref = slot.take())
+                {
+                    EXPECT_EQ((*ref)->value, 42);
+                    received.fetch_add(1);
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    slot.take();
+    EXPECT_GT(received.load(), 0);
+    EXPECT_EQ(owner.ref_count(), 0u);
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+}  // namespace
+}  // namespace zoox
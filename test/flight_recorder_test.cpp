@@ -0,0 +1,243 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+// Every translation unit of the program must agree on this
+#define ZOOX_ENABLE_FLIGHT_RECORDER
+
+#include "zoox/flight_recorder.hpp"
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+// Events about one owner recorded at or after since, oldest first. Owners
+// of earlier tests may have lived at the same address, so the recorder's
+// history is cut off at the start of the test.
+std::vector<flight_event> events_of(const flight_dump& dump, const void* owner, std::uint64_t since = 0)
+{
+    std::vector<flight_event> found;
+    for (const flight_event& e : dump.events)
+    {
+        if (e.owner == reinterpret_cast<std::uintptr_t>(owner) && e.tsc >= since)
+        {
+            found.push_back(e);
+        }
+    }
+    return found;
+}
+
+TEST(FlightRecorderTest, RecordsRefOwnerOperations)
+{
+    global_flight_recorder();
+
+    const std::uint64_t since = detail::read_tsc();
+    ref_owner<int>      owner(new int(5));
+    {
+        auto a = owner.try_make_ref();
+        auto b = owner.try_make_ref();
+        ASSERT_TRUE(a && b);
+        owner.mark_for_deletion();
+        EXPECT_FALSE(owner.try_make_ref());
+        EXPECT_FALSE(owner.try_make_refs(2, [](unique_reference<int>&&) {}));  // Rolled back without a trace
+        EXPECT_FALSE(owner.delete_if_deleteable());
+    }
+    EXPECT_TRUE(owner.delete_if_deleteable());
+
+    const std::vector<flight_event> events = events_of(global_flight_recorder().dump(), &owner, since);
+    const std::vector<flight_op>    expected{flight_op::ref_register,        flight_op::ref_register,
+                                          flight_op::mark,                flight_op::ref_register_failed,
+                                          flight_op::delete_blocked,      flight_op::ref_release,
+                                          flight_op::ref_release,         flight_op::deleted};
+    ASSERT_EQ(events.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(events[i].op, expected[i]) << i << ": " << to_string(events[i].op);
+        if (i > 0)
+        {
+            EXPECT_GE(events[i].tsc, events[i - 1].tsc);
+        }
+    }
+    EXPECT_EQ(events[1].count, 1U);  // Second registration saw one reference
+    EXPECT_EQ(events[2].count, 2U);  // Marked with two outstanding
+    EXPECT_EQ(events[4].count, 2U);  // The failed registration's rollback is not a release
+}
+
+TEST(FlightRecorderTest, RecordsExclusiveBorrows)
+{
+    const std::uint64_t since = detail::read_tsc();
+    ref_owner<int>      owner(new int(6));
+    {
+        auto exclusive = owner.try_make_exclusive_ref();
+        ASSERT_TRUE(exclusive);
+        EXPECT_FALSE(owner.try_make_exclusive_ref());
+        EXPECT_FALSE(owner.mark_and_delete_if_ready());
+    }
+    EXPECT_TRUE(owner.delete_if_deleteable());
+
+    // The blocked delete is bracketed by the exclusive register and release
+    const std::vector<flight_event> events = events_of(global_flight_recorder().dump(), &owner, since);
+    const std::vector<flight_op>    expected{flight_op::ref_register, flight_op::ref_register_failed,
+                                          flight_op::mark,         flight_op::delete_blocked,
+                                          flight_op::ref_release,  flight_op::deleted};
+    ASSERT_EQ(events.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        EXPECT_EQ(events[i].op, expected[i]) << i << ": " << to_string(events[i].op);
+    }
+    EXPECT_EQ(events[4].count, 0U);  // Exclusive flag masked out
+}
+
+TEST(FlightRecorderTest, RecordsWaits)
+{
+    const std::uint64_t     since = detail::read_tsc();
+    waitable_ref_owner<int> owner(new int(1));
+    std::thread             holder;
+    {
+        auto ref = owner.try_make_ref();
+        ASSERT_TRUE(ref);
+        holder = std::thread(
+            [r = std::move(*ref)]() mutable
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                auto done = std::move(r);
+            });
+    }
+    owner.mark_and_wait_for_deletion();
+    holder.join();
+
+    const std::vector<flight_event> events = events_of(global_flight_recorder().dump(), &owner, since);
+    ASSERT_GE(events.size(), 4U);
+    bool began = false;
+    bool ended = false;
+    for (const flight_event& e : events)
+    {
+        began = began || e.op == flight_op::wait_begin;
+        ended = ended || (e.op == flight_op::wait_end && e.count == 1);
+    }
+    EXPECT_TRUE(began);
+    EXPECT_TRUE(ended);
+}
+
+TEST(FlightRecorderTest, KeepsTheLatestEventsPerThread)
+{
+    basic_flight_recorder<8> recorder;
+    int                      owner = 0;
+    for (std::size_t i = 0; i < 20; ++i)
+    {
+        recorder.record(flight_op::ref_register, &owner, i);
+    }
+    const flight_dump dump = recorder.dump();
+    ASSERT_EQ(dump.events.size(), 8U);
+    for (std::size_t i = 0; i < 8; ++i)
+    {
+        EXPECT_EQ(dump.events[i].count, 12 + i);
+    }
+    EXPECT_GT(dump.ticks_per_us, 0.0);
+}
+
+TEST(FlightRecorderTest, ThreadsRecordWithoutInterference)
+{
+    basic_flight_recorder<1024> recorder;
+    std::vector<std::thread>    threads;
+    int                         owners[4] = {};
+    std::atomic<int>            finished{0};
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&recorder, &finished, owner = &owners[t]]
+            {
+                for (std::size_t i = 0; i < 3000; ++i)
+                {
+                    recorder.record(flight_op::ref_release, owner, i);
+                }
+                // Stay alive so no thread inherits another's ring index
+                finished.fetch_add(1);
+                while (finished.load() < 4)
+                {
+                    std::this_thread::yield();
+                }
+            });
+    }
+    flight_dump during = recorder.dump();  // Concurrent dump sees only whole records
+    for (const flight_event& e : during.events)
+    {
+        EXPECT_EQ(e.op, flight_op::ref_release);
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    const flight_dump dump = recorder.dump();
+    for (int t = 0; t < 4; ++t)
+    {
+        const std::vector<flight_event> events = events_of(dump, &owners[t]);
+        ASSERT_EQ(events.size(), 1024U);
+        for (std::size_t i = 0; i < events.size(); ++i)
+        {
+            EXPECT_EQ(events[i].count, 3000 - 1024 + i);
+            EXPECT_EQ(events[i].thread, events[0].thread);
+        }
+    }
+}
+
+TEST(FlightRecorderTest, BinaryDumpRoundTrips)
+{
+    basic_flight_recorder<16> recorder;
+    int                       owner = 0;
+    recorder.record(flight_op::mark, &owner, 3);
+    recorder.record(flight_op::deleted, &owner, 0);
+    const flight_dump dump = recorder.dump();
+
+    std::stringstream buffer;
+    write_flight_dump(buffer, dump);
+    flight_dump loaded;
+    ASSERT_TRUE(read_flight_dump(buffer, loaded));
+    EXPECT_EQ(loaded.ticks_per_us, dump.ticks_per_us);
+    ASSERT_EQ(loaded.events.size(), 2U);
+    EXPECT_EQ(loaded.events[0].op, flight_op::mark);
+    EXPECT_EQ(loaded.events[0].count, 3U);
+    EXPECT_EQ(loaded.events[1].owner, reinterpret_cast<std::uintptr_t>(&owner));
+
+    std::stringstream garbage("not a dump");
+    EXPECT_FALSE(read_flight_dump(garbage, loaded));
+}
+
+TEST(FlightRecorderTest, ChromeTraceShowsDrains)
+{
+    flight_dump dump;
+    dump.ticks_per_us = 1000.0;
+    dump.events       = {
+        {1000, 0xab0, 0, 0, flight_op::ref_register, 0},
+        {2000, 0xab0, 1, 0, flight_op::mark, 0},
+        {5000, 0xab0, 1, 1, flight_op::ref_release, 0},
+        {6000, 0xab0, 0, 0, flight_op::deleted, 0},
+    };
+    std::ostringstream json;
+    write_chrome_trace(json, dump);
+    const std::string trace = json.str();
+
+    EXPECT_EQ(trace.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0U);
+    EXPECT_NE(trace.find("\"name\":\"mark\""), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"drain\",\"cat\":\"ref_owner\",\"ph\":\"b\",\"id\":\"0xab0\",\"ts\":1.000"),
+              std::string::npos);
+    EXPECT_NE(trace.find("\"ph\":\"e\",\"id\":\"0xab0\",\"ts\":5.000"), std::string::npos);
+    EXPECT_NE(trace.find("\"name\":\"refs 0xab0\",\"ph\":\"C\",\"ts\":4.000,\"pid\":1,\"args\":{\"refs\":0}"),
+              std::string::npos);
+    EXPECT_EQ(trace.substr(trace.size() - 4), "\n]}\n");
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,244 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/frame_arena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct FrameMessage
+{
+    static std::atomic<int> live_count;
+
+    int    sequence;
+    double payload[4];
+
+    explicit FrameMessage(int s)
+        : sequence(s)
+        , payload{}
+    {
+        live_count.fetch_add(1);
+    }
+    ~FrameMessage()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> FrameMessage::live_count{0};
+
+class FrameArenaTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        FrameMessage::live_count.store(0);
+    }
+};
+
+TEST_F(FrameArenaTest, MakeConstructsInArena)
+{
+    frame_arena<> arena(4096);
+    auto*         owner = arena.make<FrameMessage>(7);
+    ASSERT_NE(owner, nullptr);
+    EXPECT_EQ((*owner)->sequence, 7);
+    EXPECT_EQ(FrameMessage::live_count.load(), 1);
+    EXPECT_EQ(arena.pending_owners(), 1u);
+    EXPECT_GT(arena.bytes_in_use(), sizeof(FrameMessage));
+    {
+        auto ref = owner->make_ref();
+        EXPECT_EQ(ref->sequence, 7);
+    }
+}
+
+#ifdef __cpp_exceptions
+struct ThrowingMessage
+{
+    ThrowingMessage()
+    {
+        throw std::runtime_error("construction failed");
+    }
+};
+
+TEST_F(FrameArenaTest, ThrowingConstructorLeavesArenaUsable)
+{
+    frame_arena<> arena(4096);
+    EXPECT_THROW(arena.make<ThrowingMessage>(), std::runtime_error);
+    EXPECT_EQ(arena.pending_owners(), 0u);
+
+    auto* owner = arena.make<FrameMessage>(3);
+    ASSERT_NE(owner, nullptr);
+    EXPECT_EQ((*owner)->sequence, 3);
+}
+#endif
+
+TEST_F(FrameArenaTest, ReclaimResetsWhenAllDrained)
+{
+    frame_arena<> arena(4096);
+    for (int i = 0; i < 5; ++i)
+    {
+        ASSERT_NE(arena.make<FrameMessage>(i), nullptr);
+    }
+    EXPECT_EQ(FrameMessage::live_count.load(), 5);
+
+    const auto result = arena.reclaim();
+    EXPECT_TRUE(result.reclaimed);
+    EXPECT_EQ(result.outstanding_owners, 0u);
+    EXPECT_EQ(result.deleted_owners, 5u);
+    EXPECT_EQ(FrameMessage::live_count.load(), 0);
+    EXPECT_EQ(arena.bytes_in_use(), 0u);
+    EXPECT_EQ(arena.pending_owners(), 0u);
+}
+
+TEST_F(FrameArenaTest, ReturnsNullWhenFull)
+{
+    frame_arena<> arena(256);
+    int           made = 0;
+    while (arena.make<FrameMessage>(made) != nullptr)
+    {
+        ++made;
+    }
+    EXPECT_GT(made, 0);
+    EXPECT_LE(arena.bytes_in_use(), arena.capacity());
+    EXPECT_TRUE(arena.reclaim().reclaimed);
+    EXPECT_NE(arena.make<FrameMessage>(0), nullptr);
+}
+
+TEST_F(FrameArenaTest, OutstandingReferenceIsCarriedOver)
+{
+    frame_arena<> arena(4096);
+    auto*         held  = arena.make<FrameMessage>(1);
+    auto*         other = arena.make<FrameMessage>(2);
+    ASSERT_NE(held, nullptr);
+    ASSERT_NE(other, nullptr);
+
+    auto ref = held->try_make_ref();
+    ASSERT_TRUE(ref.has_value());
+
+    auto result = arena.reclaim();
+    EXPECT_FALSE(result.reclaimed);
+    EXPECT_EQ(result.outstanding_owners, 1u);
+    EXPECT_EQ(result.deleted_owners, 1u);
+    EXPECT_TRUE(other->is_deleted());
+    EXPECT_FALSE(held->is_deleted());
+    EXPECT_FALSE(held->try_make_ref().has_value());
+    EXPECT_GT(arena.bytes_in_use(), 0u);
+
+    std::vector<int> outstanding;
+    arena.for_each_outstanding([&](const void* object, std::size_t refs) {
+        outstanding.push_back(static_cast<const FrameMessage*>(object)->sequence);
+        EXPECT_EQ(refs, 1u);
+    });
+    ASSERT_EQ(outstanding.size(), 1u);
+    EXPECT_EQ(outstanding[0], 1);
+
+    // Releasing the last reference drains the owner and the next frame's
+    // reclaim resets the arena without recounting earlier deletions
+    ref.reset();
+    EXPECT_EQ(arena.pending_owners(), 0u);
+    result = arena.reclaim();
+    EXPECT_TRUE(result.reclaimed);
+    EXPECT_EQ(result.deleted_owners, 1u);
+    EXPECT_EQ(FrameMessage::live_count.load(), 0);
+    EXPECT_EQ(arena.bytes_in_use(), 0u);
+}
+
+TEST_F(FrameArenaTest, ExclusiveReferenceHoldsFrame)
+{
+    frame_arena<> arena(4096);
+    auto*         owner = arena.make<FrameMessage>(3);
+    ASSERT_NE(owner, nullptr);
+    {
+        auto exclusive = owner->try_make_exclusive_ref();
+        ASSERT_TRUE(exclusive.has_value());
+        EXPECT_FALSE(arena.reclaim().reclaimed);
+        EXPECT_EQ(arena.pending_owners(), 1u);
+    }
+    EXPECT_EQ(arena.pending_owners(), 0u);
+    EXPECT_TRUE(arena.reclaim().reclaimed);
+}
+
+TEST_F(FrameArenaTest, UserSuppliedBuffer)
+{
+    alignas(64) unsigned char buffer[1024];
+    {
+        frame_arena<> arena(buffer, sizeof(buffer));
+        auto*         owner = arena.make<FrameMessage>(9);
+        ASSERT_NE(owner, nullptr);
+        EXPECT_GE(reinterpret_cast<unsigned char*>(owner), buffer);
+        EXPECT_LT(reinterpret_cast<unsigned char*>(owner), buffer + sizeof(buffer));
+    }
+    EXPECT_EQ(FrameMessage::live_count.load(), 0);
+}
+
+TEST_F(FrameArenaTest, ConcurrentFrames)
+{
+    constexpr int kThreads   = 4;
+    constexpr int kPerThread = 64;
+    constexpr int kFrames    = 20;
+
+    frame_arena<> arena(kThreads * kPerThread * 256);
+    for (int frame = 0; frame < kFrames; ++frame)
+    {
+        // Phases 1-4: producers allocate and hand references to consumers
+        std::vector<std::thread> threads;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([&arena, t] {
+                std::vector<frame_owner<FrameMessage>::reference> refs;
+                for (int i = 0; i < kPerThread; ++i)
+                {
+                    auto* owner = arena.make<FrameMessage>(t * kPerThread + i);
+                    ASSERT_NE(owner, nullptr);
+                    refs.push_back(owner->make_ref());
+                }
+                std::thread consumer([moved = std::move(refs)]() mutable { moved.clear(); });
+                consumer.join();
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        // Phase 5
+        const auto result = arena.reclaim();
+        ASSERT_TRUE(result.reclaimed);
+        EXPECT_EQ(result.deleted_owners, static_cast<std::size_t>(kThreads * kPerThread));
+        EXPECT_EQ(FrameMessage::live_count.load(), 0);
+    }
+}
+
+TEST_F(FrameArenaTest, ReleaseRacingReclaimDrainsExactlyOnce)
+{
+    frame_arena<> arena(64 * 1024);
+    for (int round = 0; round < 200; ++round)
+    {
+        auto* owner = arena.make<FrameMessage>(round);
+        ASSERT_NE(owner, nullptr);
+        auto        ref = owner->try_make_ref();
+        std::thread releaser([&ref] { ref.reset(); });
+        auto        result = arena.reclaim();
+        releaser.join();
+        if (!result.reclaimed)
+        {
+            EXPECT_EQ(arena.pending_owners(), 0u);
+            result = arena.reclaim();
+        }
+        ASSERT_TRUE(result.reclaimed);
+        EXPECT_EQ(arena.pending_owners(), 0u);
+    }
+    EXPECT_EQ(FrameMessage::live_count.load(), 0);
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,234 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/frame_executor.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+// Manual clock: phases advance it to simulate the time they take
+struct test_clock
+{
+    using duration                  = std::chrono::nanoseconds;
+    using rep                       = duration::rep;
+    using period                    = duration::period;
+    using time_point                = std::chrono::time_point<test_clock>;
+    static constexpr bool is_steady = true;
+
+    static time_point now() noexcept
+    {
+        return time_point(current);
+    }
+
+    static void advance(duration d) noexcept
+    {
+        current += d;
+    }
+
+    static duration current;
+};
+
+test_clock::duration test_clock::current{0};
+
+struct Message
+{
+    int                     value;
+    static std::atomic<int> live_count;
+
+    explicit Message(int v)
+        : value(v)
+    {
+        live_count.fetch_add(1);
+    }
+    ~Message()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Message::live_count{0};
+
+class FrameExecutorTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Message::live_count.store(0);
+    }
+
+    // 10ms period, 1ms reclaim budget, 1ms guard band
+    frame_executor<test_clock>   frame{frame_executor_options{milliseconds(10), milliseconds(1), milliseconds(1)}};
+    std::vector<frame_violation> violations;
+
+    void record_violations()
+    {
+        frame.on_violation([this](const frame_violation& v) { violations.push_back(v); });
+    }
+};
+
+TEST_F(FrameExecutorTest, RunsPhasesInOrderThenReclaims)
+{
+    std::vector<int> order;
+    EXPECT_EQ(frame.add_phase("load", milliseconds(2), [&](std::uint64_t) { order.push_back(0); }), 0U);
+    EXPECT_EQ(frame.add_phase("process", milliseconds(2), [&](std::uint64_t) { order.push_back(1); }), 1U);
+    frame.add_reclaimer(
+        [&]
+        {
+            order.push_back(2);
+            return std::size_t{0};
+        });
+    EXPECT_EQ(frame.reclaim_phase(), 2U);
+
+    frame_report report = frame.run_frame();
+    EXPECT_EQ(report.frame, 0U);
+    EXPECT_EQ(report.violations, 0U);
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2}));
+    EXPECT_EQ(frame.frame_count(), 1U);
+}
+
+TEST_F(FrameExecutorTest, RejectsPhasesThatDoNotFit)
+{
+    EXPECT_EQ(frame.add_phase("load", milliseconds(6), [](std::uint64_t) {}), 0U);
+    EXPECT_EQ(frame.add_phase("process", milliseconds(3), [](std::uint64_t) {}), frame.reclaim_phase());
+    EXPECT_EQ(frame.reclaim_phase(), 1U);
+    EXPECT_EQ(frame.add_phase("process", milliseconds(2), [](std::uint64_t) {}), 1U);
+}
+
+TEST_F(FrameExecutorTest, ReportsPhaseOverrun)
+{
+    record_violations();
+    frame.add_phase("process", milliseconds(2), [](std::uint64_t) { test_clock::advance(milliseconds(3)); });
+
+    frame.run_frame();
+    ASSERT_EQ(violations.size(), 1U);
+    EXPECT_EQ(violations[0].kind, frame_violation_kind::phase_overrun);
+    EXPECT_EQ(violations[0].phase, 0U);
+    EXPECT_STREQ(violations[0].phase_name, "process");
+    EXPECT_EQ(violations[0].elapsed, milliseconds(3));
+    EXPECT_EQ(frame.phase_stats(0).overruns, 1U);
+    EXPECT_EQ(frame.phase_stats(0).max, milliseconds(3));
+}
+
+TEST_F(FrameExecutorTest, ReportsGuardBandOverrun)
+{
+    record_violations();
+    frame.add_phase("load", milliseconds(4), [](std::uint64_t) { test_clock::advance(milliseconds(4)); });
+    frame.add_phase("process", milliseconds(4), [](std::uint64_t) { test_clock::advance(microseconds(4500)); });
+
+    frame_report report = frame.run_frame();
+    EXPECT_EQ(report.elapsed, microseconds(8500));
+    EXPECT_EQ(report.slack, microseconds(1500));
+    EXPECT_EQ(report.violations, 1U);  // process overran, the guard band held
+
+    frame.add_reclaimer(
+        []
+        {
+            test_clock::advance(microseconds(900));
+            return std::size_t{0};
+        });
+    report = frame.run_frame();
+    EXPECT_EQ(report.slack, microseconds(600));
+    ASSERT_EQ(violations.size(), 3U);
+    EXPECT_EQ(violations[2].kind, frame_violation_kind::guard_band_overrun);
+    EXPECT_EQ(violations[2].budget, milliseconds(9));
+}
+
+TEST_F(FrameExecutorTest, DeletesTrackedOwnersOnlyInReclaimPhase)
+{
+    ref_owner<Message> owner(new Message(1));
+    int                live_after_process = -1;
+    frame.add_phase("process", milliseconds(2),
+                    [&](std::uint64_t)
+                    {
+                        frame.track(owner);
+                        live_after_process = Message::live_count.load();
+                    });
+
+    frame.run_frame();
+    EXPECT_EQ(live_after_process, 1);
+    EXPECT_EQ(Message::live_count.load(), 0);
+    EXPECT_TRUE(owner.is_deleted());
+    EXPECT_EQ(frame.tracked_count(), 0U);
+}
+
+TEST_F(FrameExecutorTest, ReportsReferencesPastTheirPhase)
+{
+    record_violations();
+    ref_owner<Message>                       owner(new Message(1));
+    std::optional<unique_reference<Message>> leaked;
+    std::size_t                              process = 0;
+    process = frame.add_phase("process", milliseconds(2),
+                              [&](std::uint64_t f)
+                              {
+                                  if (f == 0)
+                                  {
+                                      frame.track(owner, process);
+                                      leaked.emplace(owner.make_ref());
+                                  }
+                              });
+    frame.add_phase("transmit", milliseconds(2), [](std::uint64_t) {});
+
+    frame.run_frame();
+    ASSERT_EQ(violations.size(), 2U);
+    EXPECT_EQ(violations[0].kind, frame_violation_kind::reference_past_phase);
+    EXPECT_EQ(violations[0].phase, process);
+    EXPECT_EQ(violations[0].object, owner.get());
+    EXPECT_EQ(violations[0].count, 1U);
+    EXPECT_EQ(violations[1].kind, frame_violation_kind::reference_past_phase);
+    EXPECT_EQ(violations[1].phase, frame.reclaim_phase());
+    EXPECT_EQ(Message::live_count.load(), 1);
+    EXPECT_EQ(frame.tracked_count(), 1U);
+
+    // Carried over: the owner is marked, deleted once the reference goes
+    leaked.reset();
+    EXPECT_EQ(frame.run_frame().violations, 0U);
+    EXPECT_EQ(Message::live_count.load(), 0);
+    EXPECT_EQ(frame.tracked_count(), 0U);
+}
+
+TEST_F(FrameExecutorTest, ReportsReclaimerOutstanding)
+{
+    record_violations();
+    frame.add_reclaimer([] { return std::size_t{3}; });
+
+    frame.run_frame();
+    ASSERT_EQ(violations.size(), 1U);
+    EXPECT_EQ(violations[0].kind, frame_violation_kind::reclaim_outstanding);
+    EXPECT_EQ(violations[0].count, 3U);
+    EXPECT_EQ(frame.violation_count(), 1U);
+}
+
+TEST(FrameExecutorRunTest, RunsOnFixedPeriodUntilStopped)
+{
+    frame_executor<>  frame(frame_executor_options{milliseconds(2), microseconds(500), microseconds(100)});
+    std::atomic<bool> stop{false};
+    std::atomic<int>  frames{0};
+    frame.add_phase("count", milliseconds(1),
+                    [&](std::uint64_t)
+                    {
+                        if (frames.fetch_add(1) + 1 == 5)
+                        {
+                            stop.store(true);
+                        }
+                    });
+
+    const auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(frame.run(stop), 5U);
+    EXPECT_GE(std::chrono::steady_clock::now() - start, milliseconds(8));
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,225 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+// Every translation unit of the program must agree on this
+#define ZOOX_TRACK_HOLDERS
+
+#include "zoox/atomic_reference.hpp"
+#include "zoox/holder_tracking.hpp"
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <deque>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Base
+{
+    virtual ~Base() = default;
+};
+
+struct Derived : Base
+{};
+
+bool is_this_file(const holder_info& h)
+{
+    return std::strstr(h.site.file, "holder_tracking_test.cpp") != nullptr;
+}
+
+TEST(HolderTrackingTest, RecordsCallSiteThreadAndTime)
+{
+    ref_owner<int> owner(new int(1));
+    EXPECT_TRUE(owner.holders().empty());
+
+    const std::uint64_t before = detail::read_tsc();
+    const unsigned      line   = __LINE__ + 1;
+    auto                ref    = owner.try_make_ref();
+    ASSERT_TRUE(ref);
+
+    const std::vector<holder_info> holders = owner.holders();
+    ASSERT_EQ(holders.size(), 1U);
+    EXPECT_TRUE(is_this_file(holders[0])) << holders[0].site.file;
+    EXPECT_EQ(holders[0].site.line, line);
+    EXPECT_EQ(holders[0].thread, detail::current_thread_id());
+    EXPECT_GE(holders[0].tsc, before);
+
+    ref.reset();
+    EXPECT_TRUE(owner.holders().empty());
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST(HolderTrackingTest, EveryCreationPathIsRecorded)
+{
+    ref_owner<int>                     owner(new int(2));
+    std::vector<unique_reference<int>> refs;
+    refs.push_back(owner.make_ref());
+    EXPECT_TRUE(owner.try_make_refs(3, [&refs](unique_reference<int>&& r) { refs.push_back(std::move(r)); }));
+    EXPECT_EQ(owner.holders().size(), 4U);
+    for (const holder_info& h : owner.holders())
+    {
+        EXPECT_TRUE(is_this_file(h));
+    }
+
+    refs.pop_back();
+    EXPECT_EQ(owner.holders().size(), 3U);
+    refs.clear();
+    EXPECT_TRUE(owner.holders().empty());
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST(HolderTrackingTest, MovesKeepTheRecord)
+{
+    ref_owner<Base> owner(new Derived());
+    auto            ref = owner.try_make_ref();
+    ASSERT_TRUE(ref);
+    const unsigned line = owner.holders().at(0).site.line;
+
+    unique_reference<Base> moved(std::move(*ref));
+    ref.reset();
+    auto derived = dynamic_reference_move<Derived>(std::move(moved));
+    ASSERT_TRUE(derived);
+    ASSERT_EQ(owner.holders().size(), 1U);
+    EXPECT_EQ(owner.holders()[0].site.line, line);
+
+    derived.reset();
+    EXPECT_TRUE(owner.holders().empty());
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST(HolderTrackingTest, UpgradesAndMailboxesDropTheRecord)
+{
+    ref_owner<int> owner(new int(3));
+    {
+        auto exclusive = try_upgrade_reference(std::move(*owner.try_make_ref()));
+        ASSERT_TRUE(exclusive);
+        EXPECT_TRUE(owner.holders().empty());
+    }
+
+    atomic_reference<int> mailbox;
+    mailbox.store(owner.make_ref());
+    EXPECT_TRUE(owner.holders().empty());  // Parked references are untracked
+    EXPECT_EQ(owner.ref_count(), 1U);
+    mailbox.take().reset();
+    EXPECT_EQ(owner.ref_count(), 0U);
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST(HolderTrackingTest, DumpNamesTheHolders)
+{
+    ref_owner<int> owner(new int(4));
+    const unsigned line = __LINE__ + 1;
+    auto           ref  = owner.try_make_ref();
+    owner.mark_for_deletion();
+    ASSERT_FALSE(owner.delete_if_deleteable());
+
+    std::ostringstream out;
+    owner.dump_holders(out);
+    const std::string dump = out.str();
+    EXPECT_NE(dump.find("1 references outstanding, 0 untracked"), std::string::npos) << dump;
+    EXPECT_NE(dump.find("holder_tracking_test.cpp:" + std::to_string(line) + " in "), std::string::npos) << dump;
+    EXPECT_NE(dump.find("TestBody"), std::string::npos) << dump;
+    EXPECT_NE(dump.find("thread " + std::to_string(detail::current_thread_id())), std::string::npos) << dump;
+
+    ref.reset();
+    EXPECT_TRUE(owner.delete_if_deleteable());
+}
+
+TEST(HolderTrackingTest, OverflowIsCountedAsUntracked)
+{
+    ref_owner<int>                    owner(new int(5));
+    std::deque<unique_reference<int>> refs;
+    for (std::size_t i = 0; i < detail::holder_slots + 10; ++i)
+    {
+        refs.push_back(owner.make_ref());
+    }
+    EXPECT_EQ(owner.holders().size(), detail::holder_slots);
+
+    std::ostringstream out;
+    owner.dump_holders(out);
+    EXPECT_NE(out.str().find(std::to_string(detail::holder_slots + 10) + " references outstanding, 10 untracked"),
+              std::string::npos)
+        << out.str();
+
+    // Releasing a tracked reference frees its slot for the next borrow
+    refs.pop_front();
+    refs.push_back(owner.make_ref());
+    EXPECT_EQ(owner.holders().size(), detail::holder_slots);
+    refs.clear();
+    EXPECT_TRUE(owner.holders().empty());
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST(HolderTrackingTest, ConcurrentBorrowersAreAllSeen)
+{
+    ref_owner<int>           owner(new int(6));
+    std::atomic<int>         holding{0};
+    std::atomic<bool>        done{false};
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    auto churn = owner.try_make_ref();
+                }
+                auto ref = owner.try_make_ref();
+                holding.fetch_add(1);
+                while (!done.load())
+                {
+                    std::this_thread::yield();
+                }
+            });
+    }
+    while (holding.load() < 4)
+    {
+        static_cast<void>(owner.holders());  // Snapshots race with claims and releases
+        std::this_thread::yield();
+    }
+
+    const std::vector<holder_info> holders = owner.holders();
+    EXPECT_EQ(holders.size(), 4U);
+    for (const holder_info& h : holders)
+    {
+        EXPECT_NE(h.thread, detail::current_thread_id());
+    }
+    done.store(true);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    EXPECT_TRUE(owner.holders().empty());
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+// Reports the tracked borrow-and-release cost; compare with an untracked build
+TEST(HolderTrackingTest, BorrowCost)
+{
+    ref_owner<int> owner(new int(7));
+    constexpr int  iterations = 200000;
+    const auto     start      = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        auto ref = owner.try_make_ref();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    const auto ns      = std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count() / iterations;
+    RecordProperty("ns_per_tracked_borrow", static_cast<int>(ns));
+    EXPECT_TRUE(owner.holders().empty());
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,233 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/io_uring_queue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace zoox
+{
+namespace
+{
+
+struct Dump
+{
+    char                    bytes[4096];
+    static std::atomic<int> live_count;
+
+    explicit Dump(char fill)
+    {
+        std::memset(bytes, fill, sizeof(bytes));
+        live_count.fetch_add(1);
+    }
+    ~Dump()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Dump::live_count{0};
+
+class IoUringQueueTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Dump::live_count.store(0);
+        if (!ring)
+        {
+            GTEST_SKIP() << "io_uring unavailable: " << std::strerror(ring.error());
+        }
+        char name[] = "/tmp/zoox_io_uring_XXXXXX";
+        fd          = mkstemp(name);
+        ASSERT_GE(fd, 0);
+        unlink(name);
+    }
+
+    void TearDown() override
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    // Waits for count completions and returns them
+    std::vector<io_uring_completion> wait_for(std::size_t count)
+    {
+        std::vector<io_uring_completion> done;
+        while (done.size() < count)
+        {
+            EXPECT_GE(ring.submit_and_wait(1), 0);
+            ring.reap([&](const io_uring_completion& c) { done.push_back(c); });
+        }
+        return done;
+    }
+
+    io_uring_queue<> ring{8};
+    int              fd = -1;
+};
+
+TEST_F(IoUringQueueTest, WriteHoldsReferenceUntilReaped)
+{
+    ref_owner<Dump> dump(new Dump('a'));
+    {
+        auto ref = dump.make_ref();
+        ASSERT_TRUE(ring.write(fd, std::move(ref), dump.get()->bytes, sizeof(Dump::bytes), 0, 7));
+    }
+    EXPECT_EQ(ring.in_flight(), 1U);
+    EXPECT_EQ(dump.ref_count(), 1U);
+
+    // The reclaim phase cannot delete the buffer while the write is pending
+    EXPECT_FALSE(dump.mark_and_delete_if_ready());
+
+    const auto done = wait_for(1);
+    EXPECT_EQ(done[0].tag, 7U);
+    EXPECT_EQ(done[0].result, static_cast<std::int32_t>(sizeof(Dump::bytes)));
+    EXPECT_EQ(ring.in_flight(), 0U);
+    EXPECT_TRUE(dump.delete_if_deleteable());
+    EXPECT_EQ(Dump::live_count.load(), 0);
+
+    char check[4096];
+    ASSERT_EQ(pread(fd, check, sizeof(check), 0), static_cast<ssize_t>(sizeof(check)));
+    EXPECT_EQ(check[0], 'a');
+    EXPECT_EQ(check[4095], 'a');
+}
+
+TEST_F(IoUringQueueTest, ReadIntoBorrowedBuffer)
+{
+    const std::string text = "frame 42";
+    ASSERT_EQ(pwrite(fd, text.data(), text.size(), 100), static_cast<ssize_t>(text.size()));
+
+    ref_owner<Dump> dump(new Dump('\0'));
+    ASSERT_TRUE(ring.read(fd, dump.make_ref(), dump.get()->bytes, text.size(), 100));
+    const auto done = wait_for(1);
+    EXPECT_EQ(done[0].result, static_cast<std::int32_t>(text.size()));
+    EXPECT_EQ(std::string(dump.get()->bytes, text.size()), text);
+    EXPECT_TRUE(dump.mark_and_delete_if_ready());
+}
+
+TEST_F(IoUringQueueTest, FullQueueLeavesReferenceWithCaller)
+{
+    ref_owner<Dump> dump(new Dump('b'));
+    std::size_t     queued = 0;
+    for (;;)
+    {
+        auto ref = dump.make_ref();
+        if (!ring.write(fd, std::move(ref), dump.get()->bytes, 16, queued * 16))
+        {
+            EXPECT_EQ(dump.ref_count(), queued + 1);  // ref is still ours
+            break;
+        }
+        ++queued;
+    }
+    EXPECT_EQ(queued, 8U);
+    EXPECT_EQ(dump.ref_count(), queued);
+
+    wait_for(queued);
+    EXPECT_EQ(dump.ref_count(), 0U);
+    EXPECT_TRUE(dump.mark_and_delete_if_ready());
+}
+
+TEST_F(IoUringQueueTest, ErrorsAreReportedAndReleaseTheReference)
+{
+    ref_owner<Dump> dump(new Dump('c'));
+    ASSERT_TRUE(ring.write(-1, dump.make_ref(), dump.get()->bytes, 16, 0));
+    const auto done = wait_for(1);
+    EXPECT_EQ(done[0].result, -EBADF);
+    EXPECT_TRUE(dump.mark_and_delete_if_ready());
+}
+
+TEST_F(IoUringQueueTest, DestructorWaitsForInFlightRequests)
+{
+    ref_owner<Dump> dump(new Dump('d'));
+    {
+        io_uring_queue<> local(4);
+        ASSERT_TRUE(local);
+        ASSERT_TRUE(local.write(fd, dump.make_ref(), dump.get()->bytes, sizeof(Dump::bytes), 0));
+        local.submit();
+    }
+    EXPECT_EQ(dump.ref_count(), 0U);
+    EXPECT_TRUE(dump.mark_and_delete_if_ready());
+}
+
+TEST_F(IoUringQueueTest, FixedBuffersUnregisterAfterDraining)
+{
+    io_uring_fixed_buffers<> buffers(ring, 2, 4096);
+    ASSERT_TRUE(buffers);
+    EXPECT_EQ(buffers.count(), 2U);
+    EXPECT_EQ(buffers.buffer_size(), 4096U);
+
+    std::memset(buffers.buffer(1), 'z', 4096);
+    auto ref = buffers.try_make_ref();
+    ASSERT_TRUE(ref);
+    ASSERT_TRUE(ring.write_fixed(fd, std::move(*ref), 1, 4096, 0, 3));
+
+    EXPECT_FALSE(buffers.unregister());  // Write still holds the set
+    EXPECT_FALSE(buffers.try_make_ref());
+
+    const auto done = wait_for(1);
+    EXPECT_EQ(done[0].tag, 3U);
+    EXPECT_EQ(done[0].result, 4096);
+    EXPECT_TRUE(buffers.unregister());
+    EXPECT_FALSE(buffers);
+
+    char check[4096];
+    ASSERT_EQ(pread(fd, check, sizeof(check), 0), static_cast<ssize_t>(sizeof(check)));
+    EXPECT_EQ(check[100], 'z');
+}
+
+TEST_F(IoUringQueueTest, FixedRejectsOutOfRangeBuffers)
+{
+    io_uring_fixed_buffers<> buffers(ring, 2, 4096);
+    ASSERT_TRUE(buffers);
+    auto ref = buffers.try_make_ref();
+    ASSERT_TRUE(ref);
+
+    EXPECT_FALSE(ring.write_fixed(fd, std::move(*ref), 2, 16, 0));
+    EXPECT_FALSE(ring.read_fixed(fd, std::move(*ref), 0, 4097, 0));
+    EXPECT_EQ(ring.in_flight(), 0U);
+    EXPECT_EQ(buffers.ref_count(), 1U);  // ref is still ours
+
+    ref.reset();
+    EXPECT_TRUE(buffers.unregister());
+}
+
+#ifdef __cpp_exceptions
+TEST_F(IoUringQueueTest, ThrowingCallbackStillReleasesTheReference)
+{
+    ref_owner<Dump> dump(new Dump('e'));
+    ASSERT_TRUE(ring.write(fd, dump.make_ref(), dump.get()->bytes, 16, 0));
+    ASSERT_GE(ring.submit_and_wait(1), 0);
+    EXPECT_THROW(ring.reap([](const io_uring_completion&) { throw std::runtime_error("callback failed"); }),
+                 std::runtime_error);
+    EXPECT_EQ(ring.in_flight(), 0U);
+    EXPECT_EQ(dump.ref_count(), 0U);
+    EXPECT_EQ(ring.reap([](const io_uring_completion&) {}), 0U);  // Not delivered twice
+    EXPECT_TRUE(dump.mark_and_delete_if_ready());
+}
+#endif
+
+TEST(HeldReferenceTest, DestructionReleasesTheReference)
+{
+    ref_owner<Dump> dump(new Dump('f'));
+    {
+        detail::held_reference held;
+        held.hold(dump.make_ref());
+        EXPECT_EQ(dump.ref_count(), 1U);
+    }
+    EXPECT_EQ(dump.ref_count(), 0U);
+    EXPECT_TRUE(dump.mark_and_delete_if_ready());
+}
+
+}  // namespace
+}  // namespace zoox
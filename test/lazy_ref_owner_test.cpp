@@ -0,0 +1,157 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/lazy_ref_owner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Service
+{
+    static std::atomic<int> construction_count;
+    static std::atomic<int> destruction_count;
+
+    int value;
+
+    explicit Service(int v = 7)
+        : value(v)
+    {
+        construction_count.fetch_add(1);
+    }
+    ~Service()
+    {
+        destruction_count.fetch_add(1);
+    }
+};
+
+std::atomic<int> Service::construction_count{0};
+std::atomic<int> Service::destruction_count{0};
+
+Service make_service()
+{
+    return Service(99);
+}
+
+class LazyRefOwnerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Service::construction_count.store(0);
+        Service::destruction_count.store(0);
+    }
+};
+
+// Constant-initialized: no dynamic initializer runs for these
+ZOOX_CONSTINIT lazy_ref_owner<Service>                               g_default_service;
+ZOOX_CONSTINIT lazy_ref_owner<Service, std::optional, Service (*)()> g_factory_service(&make_service);
+ZOOX_CONSTINIT lazy_ref_owner<Service>                               g_unused_service;
+ZOOX_CONSTINIT lazy_ref_owner<Service>                               g_contended_service;
+
+TEST_F(LazyRefOwnerTest, ConstructsOnFirstReference)
+{
+    EXPECT_FALSE(g_default_service.is_constructed());
+    EXPECT_EQ(g_default_service.ref_count(), 0u);
+    {
+        auto ref = g_default_service.make_ref();
+        EXPECT_TRUE(g_default_service.is_constructed());
+        EXPECT_EQ(ref->value, 7);
+        EXPECT_EQ(g_default_service.ref_count(), 1u);
+
+        auto second = g_default_service.try_make_ref();
+        ASSERT_TRUE(second.has_value());
+        EXPECT_EQ(&(*second)->value, &ref->value);
+    }
+    EXPECT_EQ(Service::construction_count.load(), 1);
+    EXPECT_TRUE(g_default_service.mark_and_delete_if_ready());
+    EXPECT_EQ(Service::destruction_count.load(), 1);
+    EXPECT_FALSE(g_default_service.try_make_ref().has_value());
+}
+
+TEST_F(LazyRefOwnerTest, UsesFactory)
+{
+    {
+        auto ref = g_factory_service.try_make_ref();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->value, 99);
+
+        g_factory_service.mark_for_deletion();
+        EXPECT_FALSE(g_factory_service.delete_if_deleteable());
+    }
+    EXPECT_TRUE(g_factory_service.delete_if_deleteable());
+    EXPECT_TRUE(g_factory_service.is_deleted());
+}
+
+TEST_F(LazyRefOwnerTest, MarkBeforeUseRetiresWithoutConstructing)
+{
+    g_unused_service.mark_for_deletion();
+    EXPECT_TRUE(g_unused_service.is_marked_for_deletion());
+    EXPECT_FALSE(g_unused_service.try_make_ref().has_value());
+#ifdef __cpp_exceptions
+    EXPECT_THROW(g_unused_service.make_ref(), ref_owner_marked_exception);
+#endif
+    EXPECT_TRUE(g_unused_service.delete_if_deleteable());
+    EXPECT_FALSE(g_unused_service.delete_if_deleteable());
+    EXPECT_TRUE(g_unused_service.is_deleted());
+    EXPECT_FALSE(g_unused_service.is_constructed());
+    EXPECT_EQ(Service::construction_count.load(), 0);
+}
+
+TEST_F(LazyRefOwnerTest, ConcurrentFirstUseConstructsOnce)
+{
+    constexpr int kNumThreads = 8;
+
+    std::atomic<bool>        go{false};
+    std::vector<std::thread> threads;
+    threads.reserve(kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t)
+    {
+        threads.emplace_back([&go]() {
+            while (!go.load())
+            {
+                std::this_thread::yield();
+            }
+            auto ref = g_contended_service.try_make_ref();
+            ASSERT_TRUE(ref.has_value());
+            EXPECT_EQ((*ref)->value, 7);
+        });
+    }
+    go.store(true);
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_EQ(Service::construction_count.load(), 1);
+    EXPECT_TRUE(g_contended_service.mark_and_delete_if_ready());
+}
+
+// Nothrow-constructible: try_make_ref() is noexcept and construct() has no rollback
+struct Plain
+{
+    int x;
+};
+
+ZOOX_CONSTINIT lazy_ref_owner<Plain> g_plain;
+
+TEST_F(LazyRefOwnerTest, NothrowConstructibleType)
+{
+    static_assert(noexcept(g_plain.try_make_ref()), "nothrow factory gives a noexcept borrow");
+    {
+        auto ref = g_plain.try_make_ref();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->x, 0);  // Value-initialized
+    }
+    EXPECT_TRUE(g_plain.mark_and_delete_if_ready());
+}
+
+}  // namespace
+}  // namespace zoox
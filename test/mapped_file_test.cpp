@@ -0,0 +1,181 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/mapped_file.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace zoox
+{
+namespace
+{
+
+class MappedFileTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        char name[] = "/tmp/zoox_mapped_file_XXXXXX";
+        const int fd = mkstemp(name);
+        ASSERT_GE(fd, 0);
+        path = name;
+        contents.resize(3 * 4096 + 100);
+        for (std::size_t i = 0; i < contents.size(); ++i)
+        {
+            contents[i] = static_cast<unsigned char>(i * 7);
+        }
+        ASSERT_EQ(write(fd, contents.data(), contents.size()), static_cast<ssize_t>(contents.size()));
+        close(fd);
+    }
+
+    void TearDown() override
+    {
+        unlink(path.c_str());
+    }
+
+    std::string                path;
+    std::vector<unsigned char> contents;
+};
+
+TEST_F(MappedFileTest, BorrowsRangesInPlace)
+{
+    mapped_file file(path.c_str());
+    ASSERT_TRUE(file);
+    EXPECT_EQ(file.size(), contents.size());
+    {
+        auto range = file.try_borrow(4000, 200, access_hint::will_need);
+        ASSERT_TRUE(range);
+        EXPECT_EQ(range->size(), 200U);
+        EXPECT_EQ(range->offset(), 4000U);
+        EXPECT_TRUE(std::equal(range->begin(), range->end(), contents.begin() + 4000));
+
+        auto whole = file.try_borrow(0, file.size(), access_hint::sequential);
+        ASSERT_TRUE(whole);
+        EXPECT_EQ(whole->data() + 4000, range->data());
+        EXPECT_EQ(file.ref_count(), 2U);
+    }
+    EXPECT_TRUE(file.mark_and_delete_if_ready());
+}
+
+TEST_F(MappedFileTest, RejectsOutOfBoundsRanges)
+{
+    mapped_file file(path.c_str());
+    EXPECT_FALSE(file.try_borrow(0, contents.size() + 1));
+    EXPECT_FALSE(file.try_borrow(contents.size() + 1, 0));
+    EXPECT_FALSE(file.try_borrow(10, static_cast<std::size_t>(-5)));
+    EXPECT_TRUE(file.try_borrow(contents.size(), 0));
+    EXPECT_TRUE(file.try_borrow(contents.size() - 1, 1, access_hint::random));
+    EXPECT_EQ(file.ref_count(), 0U);
+    EXPECT_TRUE(file.mark_and_delete_if_ready());
+}
+
+TEST_F(MappedFileTest, UnmapsOnlyAfterRangesAreReleased)
+{
+    mapped_file file(path.c_str());
+    {
+        auto range = file.try_borrow(0, 16);
+        ASSERT_TRUE(range);
+
+        EXPECT_FALSE(file.mark_and_delete_if_ready());
+        EXPECT_TRUE(file);  // Still mapped
+        EXPECT_FALSE(file.try_borrow(0, 16));
+        EXPECT_EQ((*range)[1], contents[1]);
+    }
+    EXPECT_TRUE(file.delete_if_deleteable());
+    EXPECT_FALSE(file);
+    EXPECT_EQ(file.size(), 0U);
+    EXPECT_FALSE(file.try_borrow(0, 0));
+}
+
+TEST_F(MappedFileTest, ConcurrentBorrowsPinTheMapping)
+{
+    mapped_file              file(path.c_str());
+    std::vector<std::thread> readers;
+    std::atomic<int>         mismatches{0};
+    for (int t = 0; t < 4; ++t)
+    {
+        readers.emplace_back(
+            [&]
+            {
+                for (std::size_t i = 0; i < 1000; ++i)
+                {
+                    auto range = file.try_borrow(i, 64, access_hint::will_need);
+                    if (!range)
+                    {
+                        return;
+                    }
+                    if ((*range)[63] != contents[i + 63])
+                    {
+                        mismatches.fetch_add(1);
+                    }
+                }
+            });
+    }
+    file.mark_for_deletion();
+    for (auto& r : readers)
+    {
+        r.join();
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_TRUE(file.delete_if_deleteable());
+}
+
+TEST_F(MappedFileTest, MapsCallerDescriptor)
+{
+    const int fd = open(path.c_str(), O_RDONLY);
+    ASSERT_GE(fd, 0);
+    {
+        mapped_file file(fd);
+        ASSERT_TRUE(file);
+        {
+            auto range = file.try_borrow(1, 1);
+            ASSERT_TRUE(range);
+            EXPECT_EQ((*range)[0], contents[1]);
+        }
+        EXPECT_TRUE(file.mark_and_delete_if_ready());
+    }
+    EXPECT_EQ(fcntl(fd, F_GETFD), 0);  // Still open
+    close(fd);
+}
+
+TEST_F(MappedFileTest, FailsForMissingOrEmptyFiles)
+{
+    mapped_file missing("/nonexistent/zoox_mapped_file");
+    EXPECT_FALSE(missing);
+    EXPECT_FALSE(missing.try_borrow(0, 0));
+
+    ASSERT_EQ(truncate(path.c_str(), 0), 0);
+    mapped_file empty(path.c_str());
+    EXPECT_FALSE(empty);
+}
+
+#ifdef __cpp_exceptions
+TEST_F(MappedFileTest, BorrowThrows)
+{
+    mapped_file file(path.c_str());
+    EXPECT_THROW(file.borrow(0, contents.size() + 1), std::out_of_range);
+    EXPECT_EQ(file.ref_count(), 0U);  // The rejected borrow's registration was dropped
+
+    {
+        mapped_range range = file.borrow(8, 8);
+        EXPECT_EQ(range[0], contents[8]);
+    }
+
+    file.mark_for_deletion();
+    EXPECT_THROW(file.borrow(0, 1), ref_owner_marked_exception);
+    EXPECT_TRUE(file.delete_if_deleteable());
+}
+#endif
+
+}  // namespace
+}  // namespace zoox
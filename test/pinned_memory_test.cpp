@@ -0,0 +1,145 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/pinned_memory.hpp"
+
+#include "zoox/frame_arena.hpp"
+#include "zoox/recycling_pool.hpp"
+#include "zoox/ref_owner_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Sample
+{
+    int value;
+
+    explicit Sample(int v)
+        : value(v)
+    {
+    }
+};
+
+struct Buffer
+{
+    explicit Buffer(std::size_t reserve)
+    {
+        items.reserve(reserve);
+    }
+    std::vector<int> items;
+};
+
+void recycle(Buffer& buffer)
+{
+    buffer.items.clear();
+}
+
+TEST(PinnedRegionTest, MapsUsableMemory)
+{
+    pinned_region region(100000);
+    ASSERT_TRUE(region);
+    EXPECT_EQ(region.size(), 100000u);
+    EXPECT_GE(region.mapped_size(), region.size());
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(region.data()) % numa::page_size(), 0u);
+    std::memset(region.data(), 0xab, region.size());
+    EXPECT_EQ(static_cast<unsigned char*>(region.data())[region.size() - 1], 0xab);
+}
+
+TEST(PinnedRegionTest, HugeMappingIsHugePageAligned)
+{
+    pinned_region region(pinned_region::huge_page_size + 1);
+    ASSERT_TRUE(region);
+    // hugetlb or the transparent huge page fallback both align to 2 MiB
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(region.data()) % pinned_region::huge_page_size, 0u);
+    EXPECT_EQ(region.mapped_size(), 2 * pinned_region::huge_page_size);
+}
+
+TEST(PinnedRegionTest, FallsBackWithoutHugePages)
+{
+    pinned_memory_options options;
+    options.huge_pages = false;
+    options.lock       = false;
+    pinned_region region(1000, options);
+    ASSERT_TRUE(region);
+    EXPECT_FALSE(region.huge_pages());
+    EXPECT_FALSE(region.locked());
+    EXPECT_EQ(region.mapped_size(), numa::page_size());
+}
+
+TEST(PinnedRegionTest, MoveTransfersMapping)
+{
+    pinned_region first(4096);
+    void*         data = first.data();
+    pinned_region second(std::move(first));
+    EXPECT_FALSE(first);  // NOLINT: testing moved-from state
+    EXPECT_EQ(second.data(), data);
+    first = std::move(second);
+    EXPECT_EQ(first.data(), data);
+}
+
+TEST(PinnedMemorySourceTest, BacksRefOwnerPool)
+{
+    ref_owner_pool<Sample, 64, std::optional, 8, pinned_memory_source> pool;
+    ASSERT_TRUE(pool.memory_source().region());
+    auto* owner = pool.allocate(5);
+    ASSERT_NE(owner, nullptr);
+    const auto* begin = static_cast<const unsigned char*>(pool.memory_source().region().data());
+    const auto* where = reinterpret_cast<const unsigned char*>(owner);
+    EXPECT_GE(where, begin);
+    EXPECT_LT(where, begin + pool.memory_source().region().size());
+    {
+        auto ref = owner->make_ref();
+        EXPECT_EQ(ref->value, 5);
+    }
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+}
+
+TEST(PinnedMemorySourceTest, BacksRecyclingPool)
+{
+    recycling_pool<Buffer, 4, call_recycle, std::optional, 8, pinned_memory_source> pool(
+        std::allocator_arg, pinned_memory_source(), call_recycle{}, std::size_t{16});
+    auto* owner = pool.acquire();
+    ASSERT_NE(owner, nullptr);
+    (*owner)->items.push_back(1);
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+    owner = pool.acquire();
+    ASSERT_NE(owner, nullptr);
+    EXPECT_TRUE((*owner)->items.empty());
+    EXPECT_GE((*owner)->items.capacity(), 16u);
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+}
+
+TEST(PinnedMemorySourceTest, BacksFrameArena)
+{
+    pinned_memory_options options;
+    options.lock = false;
+    frame_arena<std::optional, pinned_memory_source> arena(1 << 16, pinned_memory_source(options));
+    for (int frame = 0; frame < 3; ++frame)
+    {
+        for (int i = 0; i < 100; ++i)
+        {
+            ASSERT_NE(arena.make<Sample>(i), nullptr);
+        }
+        EXPECT_TRUE(arena.reclaim().reclaimed);
+    }
+}
+
+TEST(PinnedMemorySourceTest, InlinePoolIsUnchanged)
+{
+    ref_owner_pool<Sample, 4> pool;
+    static_assert(sizeof(pool) > 4 * sizeof(ref_owner_pool<Sample, 4>::owner_type), "slots are inline");
+    auto* owner = pool.allocate(1);
+    ASSERT_NE(owner, nullptr);
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+}
+
+}  // namespace
+}  // namespace zoox
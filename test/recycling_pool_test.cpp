@@ -0,0 +1,196 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/recycling_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace perception
+{
+
+struct PointCloud
+{
+    static std::atomic<int> construction_count;
+    static std::atomic<int> destruction_count;
+    static std::atomic<int> recycle_count;
+
+    std::vector<int> points;
+
+    explicit PointCloud(std::size_t reserve = 0)
+    {
+        points.reserve(reserve);
+        construction_count.fetch_add(1);
+    }
+    ~PointCloud()
+    {
+        destruction_count.fetch_add(1);
+    }
+    PointCloud(const PointCloud&)            = delete;
+    PointCloud& operator=(const PointCloud&) = delete;
+};
+
+std::atomic<int> PointCloud::construction_count{0};
+std::atomic<int> PointCloud::destruction_count{0};
+std::atomic<int> PointCloud::recycle_count{0};
+
+// Found by argument-dependent lookup from zoox::call_recycle
+inline void recycle(PointCloud& cloud) noexcept
+{
+    cloud.points.clear();
+    PointCloud::recycle_count.fetch_add(1);
+}
+
+}  // namespace perception
+
+namespace zoox
+{
+namespace
+{
+
+using perception::PointCloud;
+
+class RecyclingPoolTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        PointCloud::construction_count.store(0);
+        PointCloud::destruction_count.store(0);
+        PointCloud::recycle_count.store(0);
+    }
+};
+
+TEST_F(RecyclingPoolTest, ObjectsConstructedOnceAndDestroyedWithPool)
+{
+    {
+        recycling_pool<PointCloud, 4> pool(call_recycle{}, std::size_t{128});
+        EXPECT_EQ(PointCloud::construction_count.load(), 4);
+
+        for (int i = 0; i < 10; ++i)
+        {
+            auto* owner = pool.acquire();
+            ASSERT_NE(owner, nullptr);
+            (*owner)->points.push_back(i);
+            EXPECT_TRUE(owner->mark_and_delete_if_ready());
+        }
+        EXPECT_EQ(PointCloud::construction_count.load(), 4);
+        EXPECT_EQ(PointCloud::destruction_count.load(), 0);
+        EXPECT_EQ(PointCloud::recycle_count.load(), 10);
+    }
+    EXPECT_EQ(PointCloud::destruction_count.load(), 4);
+}
+
+TEST_F(RecyclingPoolTest, UnmarkedSlotIsRecycledBeforeDestruction)
+{
+    {
+        recycling_pool<PointCloud, 2> pool;
+        auto*                         owner = pool.acquire();
+        ASSERT_NE(owner, nullptr);
+        (*owner)->points.push_back(1);
+    }
+    EXPECT_EQ(PointCloud::recycle_count.load(), 1);
+    EXPECT_EQ(PointCloud::destruction_count.load(), 2);
+}
+
+TEST_F(RecyclingPoolTest, RecyclingKeepsReservedCapacity)
+{
+    recycling_pool<PointCloud, 1, call_recycle, std::optional, 0> pool(call_recycle{}, std::size_t{256});
+
+    auto* owner = pool.acquire();
+    ASSERT_NE(owner, nullptr);
+    PointCloud* object = owner->get();
+    (*owner)->points.assign(200, 1);
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+
+    auto* again = pool.acquire();
+    ASSERT_EQ(again, owner);
+    EXPECT_EQ(again->get(), object);
+    EXPECT_TRUE((*again)->points.empty());
+    EXPECT_GE((*again)->points.capacity(), 256u);
+    EXPECT_FALSE(again->is_marked_for_deletion());
+    EXPECT_FALSE(again->is_deleted());
+    EXPECT_TRUE(again->mark_and_delete_if_ready());
+}
+
+TEST_F(RecyclingPoolTest, SlotReturnsOnlyAfterReferencesDrain)
+{
+    recycling_pool<PointCloud, 1, call_recycle, std::optional, 0> pool;
+
+    auto* owner = pool.acquire();
+    ASSERT_NE(owner, nullptr);
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    auto ref = owner->try_make_ref();
+    EXPECT_FALSE(owner->mark_and_delete_if_ready());
+    EXPECT_EQ(PointCloud::recycle_count.load(), 0);
+    EXPECT_EQ(pool.acquire(), nullptr);
+
+    ref.reset();
+    EXPECT_TRUE(owner->delete_if_deleteable());
+    EXPECT_EQ(PointCloud::recycle_count.load(), 1);
+    auto* again = pool.acquire();
+    ASSERT_EQ(again, owner);
+    again->mark_and_delete_if_ready();
+}
+
+TEST_F(RecyclingPoolTest, CustomRecycler)
+{
+    std::atomic<int> calls{0};
+    auto             recycler = [&calls](PointCloud& cloud) noexcept {
+        cloud.points.clear();
+        calls.fetch_add(1);
+    };
+
+    recycling_pool<PointCloud, 2, decltype(recycler)> pool(recycler);
+    auto*                                             owner = pool.acquire();
+    ASSERT_NE(owner, nullptr);
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_EQ(PointCloud::recycle_count.load(), 0);
+}
+
+TEST_F(RecyclingPoolTest, ConcurrentAcquireAndRecycle)
+{
+    constexpr int kNumThreads = 8;
+    constexpr int kIterations = 1000;
+
+    recycling_pool<PointCloud, 16, call_recycle, std::optional, 2> pool(call_recycle{}, std::size_t{16});
+    std::atomic<int>                                                 acquired{0};
+
+    std::vector<std::thread> threads;
+    threads.reserve(kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t)
+    {
+        threads.emplace_back([&pool, &acquired, t]() {
+            for (int i = 0; i < kIterations; ++i)
+            {
+                auto* owner = pool.acquire();
+                if (owner == nullptr)
+                {
+                    continue;
+                }
+                acquired.fetch_add(1);
+                {
+                    auto ref = owner->make_ref();
+                    EXPECT_TRUE(ref->points.empty());
+                    ref->points.push_back(t);
+                }
+                EXPECT_TRUE(owner->mark_and_delete_if_ready());
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_EQ(PointCloud::recycle_count.load(), acquired.load());
+    EXPECT_EQ(PointCloud::construction_count.load(), 16);
+}
+
+}  // namespace
+}  // namespace zoox
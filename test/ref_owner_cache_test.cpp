@@ -0,0 +1,188 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/ref_owner_cache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Tile
+{
+    static std::atomic<int> live_count;
+
+    int id;
+
+    explicit Tile(int i)
+        : id(i)
+    {
+        live_count.fetch_add(1);
+    }
+    ~Tile()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Tile::live_count{0};
+
+// One shard so that eviction order is easy to reason about
+using single_shard_cache = ref_owner_cache<int, Tile, std::hash<int>, std::equal_to<int>, std::optional, 1>;
+
+class RefOwnerCacheTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Tile::live_count.store(0);
+    }
+};
+
+TEST_F(RefOwnerCacheTest, EmplaceAndFind)
+{
+    ref_owner_cache<int, Tile> tiles(64);
+    EXPECT_FALSE(tiles.find(1).has_value());
+    {
+        auto tile = tiles.emplace(1, 1);
+        ASSERT_TRUE(tile.has_value());
+        EXPECT_EQ((*tile)->id, 1);
+    }
+    auto again = tiles.find(1);
+    ASSERT_TRUE(again.has_value());
+    EXPECT_EQ((*again)->id, 1);
+    EXPECT_EQ(tiles.size(), 1u);
+
+    // A hit does not construct a second value
+    auto existing = tiles.emplace(1, 99);
+    EXPECT_EQ((*existing)->id, 1);
+    EXPECT_EQ(Tile::live_count.load(), 1);
+}
+
+TEST_F(RefOwnerCacheTest, EvictsWhenFull)
+{
+    single_shard_cache tiles(4);
+    for (int i = 0; i < 10; ++i)
+    {
+        EXPECT_TRUE(tiles.emplace(i, i).has_value());
+        EXPECT_LE(tiles.size(), 4u);
+    }
+    EXPECT_EQ(tiles.size(), 4u);
+    EXPECT_EQ(Tile::live_count.load(), 4);
+}
+
+TEST_F(RefOwnerCacheTest, NeverEvictsPinnedEntries)
+{
+    single_shard_cache tiles(4);
+    auto               pinned = tiles.emplace(0, 0);
+    for (int i = 1; i < 50; ++i)
+    {
+        tiles.emplace(i, i);
+    }
+    EXPECT_EQ((*pinned)->id, 0);
+    auto found = tiles.find(0);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ((*found)->id, 0);
+}
+
+TEST_F(RefOwnerCacheTest, AllPinnedFailsWithoutStalling)
+{
+    single_shard_cache                         tiles(3);
+    std::vector<single_shard_cache::reference> held;
+    for (int i = 0; i < 3; ++i)
+    {
+        held.push_back(std::move(*tiles.emplace(i, i)));
+    }
+    EXPECT_FALSE(tiles.emplace(3, 3).has_value());
+    EXPECT_EQ(tiles.trim(3), 0u);
+
+    held.pop_back();
+    EXPECT_TRUE(tiles.emplace(3, 3).has_value());
+    EXPECT_FALSE(tiles.find(2).has_value());
+}
+
+TEST_F(RefOwnerCacheTest, RecentlyUsedSurvivesSecondChance)
+{
+    single_shard_cache tiles(3);
+    tiles.emplace(0, 0);
+    tiles.emplace(1, 1);
+    tiles.emplace(2, 2);
+    // The first sweep clears every bit and evicts 0; a hit on 1 then gives it
+    // a second chance over 2
+    tiles.emplace(3, 3);
+    tiles.find(1);
+    tiles.emplace(4, 4);
+    EXPECT_TRUE(tiles.find(1).has_value());
+}
+
+TEST_F(RefOwnerCacheTest, EraseAndTrim)
+{
+    single_shard_cache tiles(4);
+    for (int i = 0; i < 4; ++i)
+    {
+        tiles.emplace(i, i);
+    }
+    auto held = tiles.find(0);
+    EXPECT_TRUE(tiles.erase(0));
+    EXPECT_FALSE(tiles.erase(0));
+    EXPECT_FALSE(tiles.find(0).has_value());
+    EXPECT_EQ((*held)->id, 0);
+    EXPECT_EQ(Tile::live_count.load(), 4);
+
+    EXPECT_EQ(tiles.trim(10), 3u);
+    EXPECT_EQ(tiles.size(), 0u);
+    EXPECT_EQ(Tile::live_count.load(), 1);
+
+    held.reset();
+    // The erased slot is reclaimed when the sweep next passes it
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(tiles.emplace(10 + i, 10 + i).has_value());
+    }
+    EXPECT_EQ(Tile::live_count.load(), 4);
+}
+
+TEST_F(RefOwnerCacheTest, ConcurrentLookupsAndInserts)
+{
+    constexpr int kThreads = 4;
+    constexpr int kKeys    = 256;
+
+    {
+        ref_owner_cache<int, Tile, std::hash<int>, std::equal_to<int>, std::optional, 4> tiles(64);
+        std::vector<std::thread>                                                         threads;
+        for (int t = 0; t < kThreads; ++t)
+        {
+            threads.emplace_back([&tiles, t] {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    const int key  = (i * 7 + t * 13) % kKeys;
+                    auto      tile = tiles.find(key);
+                    if (tile)
+                    {
+                        EXPECT_EQ((*tile)->id, key);
+                    }
+                    else if (auto inserted = tiles.emplace(key, key))
+                    {
+                        EXPECT_EQ((*inserted)->id, key);
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        EXPECT_LE(tiles.size(), tiles.capacity());
+        EXPECT_EQ(Tile::live_count.load(), static_cast<int>(tiles.size()));
+    }
+    EXPECT_EQ(Tile::live_count.load(), 0);
+}
+
+}  // namespace
+}  // namespace zoox
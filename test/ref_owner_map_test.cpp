@@ -0,0 +1,174 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/ref_owner_map.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct TrackState
+{
+    static std::atomic<int> live_count;
+
+    int         id;
+    std::string label;
+
+    TrackState(int i, std::string l)
+        : id(i)
+        , label(std::move(l))
+    {
+        live_count.fetch_add(1);
+    }
+    ~TrackState()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> TrackState::live_count{0};
+
+class RefOwnerMapTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        TrackState::live_count.store(0);
+    }
+};
+
+TEST_F(RefOwnerMapTest, EmplaceAndFind)
+{
+    ref_owner_map<int, TrackState> tracks;
+    EXPECT_TRUE(tracks.emplace(1, 1, "car"));
+    EXPECT_TRUE(tracks.emplace(2, 2, "bike"));
+    EXPECT_FALSE(tracks.emplace(1, 1, "duplicate"));
+    EXPECT_EQ(tracks.size(), 2u);
+    EXPECT_EQ(TrackState::live_count.load(), 2);
+
+    auto track = tracks.find(1);
+    ASSERT_TRUE(track.has_value());
+    EXPECT_EQ((*track)->label, "car");
+    EXPECT_FALSE(tracks.find(3).has_value());
+    EXPECT_TRUE(tracks.contains(2));
+}
+
+TEST_F(RefOwnerMapTest, EraseWhileReferencedKeepsValueAlive)
+{
+    ref_owner_map<int, TrackState> tracks;
+    tracks.emplace(7, 7, "truck");
+    auto held = tracks.find(7);
+    ASSERT_TRUE(held.has_value());
+
+    EXPECT_TRUE(tracks.erase(7));
+    EXPECT_FALSE(tracks.erase(7));
+    EXPECT_FALSE(tracks.find(7).has_value());
+    EXPECT_EQ(tracks.size(), 0u);
+
+    // Still referenced: neither the value nor the node may go
+    EXPECT_EQ(tracks.reclaim(), 1u);
+    EXPECT_EQ(TrackState::live_count.load(), 1);
+    EXPECT_EQ((*held)->label, "truck");
+
+    held.reset();
+    EXPECT_EQ(tracks.reclaim(), 0u);
+    EXPECT_EQ(TrackState::live_count.load(), 0);
+}
+
+TEST_F(RefOwnerMapTest, InsertOrReplace)
+{
+    ref_owner_map<int, TrackState> tracks;
+    tracks.insert_or_replace(1, 1, "old");
+    auto old_ref = tracks.find(1);
+    tracks.insert_or_replace(1, 1, "new");
+    EXPECT_EQ(tracks.size(), 1u);
+    EXPECT_EQ((*tracks.find(1))->label, "new");
+    EXPECT_EQ((*old_ref)->label, "old");
+    old_ref.reset();
+    tracks.reclaim();
+    EXPECT_EQ(TrackState::live_count.load(), 1);
+}
+
+TEST_F(RefOwnerMapTest, DestructorDestroysAll)
+{
+    {
+        ref_owner_map<int, TrackState, std::hash<int>, std::equal_to<int>, std::optional, 2> tracks(4);
+        for (int i = 0; i < 100; ++i)
+        {
+            tracks.emplace(i, i, "t");
+        }
+        for (int i = 0; i < 100; i += 2)
+        {
+            tracks.erase(i);
+        }
+        EXPECT_EQ(tracks.size(), 50u);
+        for (int i = 1; i < 100; i += 2)
+        {
+            EXPECT_EQ((*tracks.find(i))->id, i);
+        }
+    }
+    EXPECT_EQ(TrackState::live_count.load(), 0);
+}
+
+TEST_F(RefOwnerMapTest, ConcurrentReadersAndWriters)
+{
+    constexpr int kKeys    = 64;
+    constexpr int kReaders = 4;
+
+    ref_owner_map<int, TrackState, std::hash<int>, std::equal_to<int>, std::optional, 4> tracks(64);
+    std::atomic<bool> stop{false};
+    std::atomic<long> hits{0};
+
+    std::vector<std::thread> readers;
+    for (int r = 0; r < kReaders; ++r)
+    {
+        readers.emplace_back([&] {
+            long local = 0;
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                for (int key = 0; key < kKeys; ++key)
+                {
+                    if (auto track = tracks.find(key))
+                    {
+                        // The value must be intact even if erased meanwhile
+                        EXPECT_EQ((*track)->id, key);
+                        ++local;
+                    }
+                }
+            }
+            hits.fetch_add(local);
+        });
+    }
+
+    std::thread writer([&] {
+        for (int round = 0; round < 2000; ++round)
+        {
+            const int key = round % kKeys;
+            if (!tracks.emplace(key, key, "w"))
+            {
+                tracks.erase(key);
+            }
+        }
+        stop.store(true);
+    });
+
+    writer.join();
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+    EXPECT_GT(hits.load(), 0);
+    EXPECT_EQ(tracks.reclaim(), 0u);
+    EXPECT_EQ(TrackState::live_count.load(), static_cast<int>(tracks.size()));
+}
+
+}  // namespace
+}  // namespace zoox
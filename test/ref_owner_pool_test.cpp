@@ -0,0 +1,169 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/ref_owner_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct SensorData
+{
+    static std::atomic<int> live_count;
+
+    int reading;
+
+    explicit SensorData(int r)
+        : reading(r)
+    {
+        live_count.fetch_add(1);
+    }
+    ~SensorData()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> SensorData::live_count{0};
+
+class RefOwnerPoolTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        SensorData::live_count.store(0);
+    }
+};
+
+TEST_F(RefOwnerPoolTest, AllocateConstructsInPlace)
+{
+    ref_owner_pool<SensorData, 4> pool;
+    auto*                         owner = pool.allocate(42);
+    ASSERT_NE(owner, nullptr);
+    EXPECT_EQ((*owner)->reading, 42);
+    EXPECT_FALSE(owner->is_marked_for_deletion());
+    EXPECT_EQ(SensorData::live_count.load(), 1);
+    {
+        auto ref = owner->make_ref();
+        EXPECT_EQ(ref->reading, 42);
+    }
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+    EXPECT_EQ(SensorData::live_count.load(), 0);
+}
+
+TEST_F(RefOwnerPoolTest, ExhaustionAndAutomaticSlotReturn)
+{
+    ref_owner_pool<SensorData, 3, std::optional, 0> pool;
+    auto*                                           a = pool.allocate(1);
+    auto*                                           b = pool.allocate(2);
+    auto*                                           c = pool.allocate(3);
+    ASSERT_TRUE(a && b && c);
+    EXPECT_EQ(pool.allocate(4), nullptr);
+
+    // Outstanding reference keeps the slot
+    auto ref = b->try_make_ref();
+    EXPECT_FALSE(b->mark_and_delete_if_ready());
+    EXPECT_EQ(pool.allocate(4), nullptr);
+
+    // Deleting through the normal protocol frees the slot for reuse
+    ref.reset();
+    EXPECT_TRUE(b->delete_if_deleteable());
+    auto* d = pool.allocate(4);
+    ASSERT_EQ(d, b);
+    EXPECT_EQ((*d)->reading, 4);
+
+    a->mark_and_delete_if_ready();
+    c->mark_and_delete_if_ready();
+    d->mark_and_delete_if_ready();
+}
+
+TEST_F(RefOwnerPoolTest, ThreadCacheServesLocalReuse)
+{
+    ref_owner_pool<SensorData, 4> pool;
+    auto*                         first = pool.allocate(1);
+    ASSERT_NE(first, nullptr);
+    EXPECT_TRUE(first->mark_and_delete_if_ready());
+
+    // Freed on this thread, so the cached slot is handed out again
+    auto* second = pool.allocate(2);
+    EXPECT_EQ(second, first);
+    EXPECT_TRUE(second->mark_and_delete_if_ready());
+}
+
+TEST_F(RefOwnerPoolTest, ReusedSlotDefeatsStaleObserver)
+{
+    ref_owner_pool<SensorData, 1> pool;
+    auto*                         owner = pool.allocate(1);
+    ASSERT_NE(owner, nullptr);
+    weak_observer<SensorData, std::optional, ref_owner_pool<SensorData, 1>::slot_deleter> observer(*owner);
+    EXPECT_TRUE(owner->mark_and_delete_if_ready());
+
+    auto* reused = pool.allocate(2);
+    ASSERT_EQ(reused, owner);
+    EXPECT_FALSE(observer.try_upgrade().has_value());
+    EXPECT_EQ(reused->ref_count(), 0u);
+    EXPECT_TRUE(reused->mark_and_delete_if_ready());
+}
+
+TEST_F(RefOwnerPoolTest, ConcurrentAllocateAndFree)
+{
+    constexpr std::size_t kCapacity   = 32;
+    constexpr int         kNumThreads = 8;
+    constexpr int         kIterations = 2000;
+
+    ref_owner_pool<SensorData, kCapacity, std::optional, 2> pool;
+    std::atomic<int>                                        allocations{0};
+
+    std::vector<std::thread> threads;
+    threads.reserve(kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t)
+    {
+        threads.emplace_back([&pool, &allocations, t]() {
+            for (int i = 0; i < kIterations; ++i)
+            {
+                auto* owner = pool.allocate(t);
+                if (owner == nullptr)
+                {
+                    continue;
+                }
+                allocations.fetch_add(1);
+                {
+                    auto ref = owner->make_ref();
+                    EXPECT_EQ(ref->reading, t);
+                }
+                EXPECT_TRUE(owner->mark_and_delete_if_ready());
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_GT(allocations.load(), 0);
+    EXPECT_EQ(SensorData::live_count.load(), 0);
+
+    // Every slot is reachable again once the worker threads' caches are
+    // recycled; with at most 2 cached per exited thread, at least
+    // kCapacity - kNumThreads * 2 remain on the shared list
+    std::vector<ref_owner_pool<SensorData, kCapacity, std::optional, 2>::owner_type*> owners;
+    while (auto* owner = pool.allocate(0))
+    {
+        owners.push_back(owner);
+    }
+    EXPECT_GE(owners.size(), kCapacity - kNumThreads * 2);
+    for (auto* owner : owners)
+    {
+        owner->mark_and_delete_if_ready();
+    }
+}
+
+}  // namespace
+}  // namespace zoox
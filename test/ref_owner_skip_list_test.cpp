@@ -0,0 +1,231 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/ref_owner_skip_list.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Detection
+{
+    static std::atomic<int> live_count;
+
+    long stamp;
+
+    explicit Detection(long s)
+        : stamp(s)
+    {
+        live_count.fetch_add(1);
+    }
+    ~Detection()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Detection::live_count{0};
+
+class RefOwnerSkipListTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Detection::live_count.store(0);
+    }
+};
+
+TEST_F(RefOwnerSkipListTest, EmplaceFindErase)
+{
+    ref_owner_skip_list<long, Detection> list;
+    EXPECT_TRUE(list.emplace(20, 20));
+    EXPECT_TRUE(list.emplace(10, 10));
+    EXPECT_TRUE(list.emplace(30, 30));
+    EXPECT_FALSE(list.emplace(20, 99));
+    EXPECT_EQ(list.size(), 3u);
+
+    auto found = list.find(20);
+    ASSERT_TRUE(found.has_value());
+    EXPECT_EQ((*found)->stamp, 20);
+    EXPECT_FALSE(list.find(25).has_value());
+
+    EXPECT_TRUE(list.erase(10));
+    EXPECT_FALSE(list.erase(10));
+    EXPECT_FALSE(list.contains(10));
+    EXPECT_EQ(list.size(), 2u);
+    EXPECT_EQ(list.reclaim(), 0u);
+    EXPECT_EQ(Detection::live_count.load(), 2);
+}
+
+TEST_F(RefOwnerSkipListTest, IteratesInOrder)
+{
+    ref_owner_skip_list<long, Detection> list;
+    for (long key : {50L, 10L, 40L, 20L, 30L, 60L})
+    {
+        list.emplace(key, key);
+    }
+    std::vector<long> keys;
+    for (auto c = list.begin(); c; c.advance())
+    {
+        keys.push_back(c.key());
+        EXPECT_EQ(c->stamp, c.key());
+    }
+    EXPECT_EQ(keys, (std::vector<long>{10, 20, 30, 40, 50, 60}));
+
+    std::vector<long> range;
+    list.for_each_in_range(20, 50, [&](long key, Detection&) { range.push_back(key); });
+    EXPECT_EQ(range, (std::vector<long>{20, 30, 40}));
+
+    auto c = list.lower_bound(35);
+    ASSERT_TRUE(c);
+    EXPECT_EQ(c.key(), 40);
+    EXPECT_FALSE(list.lower_bound(61));
+}
+
+TEST_F(RefOwnerSkipListTest, CursorSurvivesEraseOfItsNode)
+{
+    ref_owner_skip_list<long, Detection> list;
+    for (long key = 1; key <= 5; ++key)
+    {
+        list.emplace(key, key);
+    }
+    auto c = list.lower_bound(2);
+    ASSERT_TRUE(c);
+
+    // Erase the node under the cursor and its successor
+    EXPECT_TRUE(list.erase(2));
+    EXPECT_TRUE(list.erase(3));
+    EXPECT_EQ(list.reclaim(), 1u);  // 2 is still borrowed
+    EXPECT_EQ(c->stamp, 2);
+    EXPECT_FALSE(c.make_ref().has_value());
+
+    ASSERT_TRUE(c.advance());
+    EXPECT_EQ(c.key(), 4);
+    EXPECT_EQ(list.reclaim(), 0u);
+    EXPECT_EQ(Detection::live_count.load(), 3);
+}
+
+TEST_F(RefOwnerSkipListTest, ErasedValueLivesWhileReferenced)
+{
+    ref_owner_skip_list<long, Detection> list;
+    list.emplace(1, 1);
+    auto ref = list.find(1);
+    list.erase(1);
+    EXPECT_EQ(list.reclaim(), 1u);
+    EXPECT_EQ((*ref)->stamp, 1);
+    ref.reset();
+    EXPECT_EQ(list.reclaim(), 0u);
+    EXPECT_EQ(Detection::live_count.load(), 0);
+}
+
+TEST_F(RefOwnerSkipListTest, DestructorDestroysAll)
+{
+    {
+        ref_owner_skip_list<long, Detection, std::less<long>, std::optional, 4> list;
+        for (long key = 0; key < 200; ++key)
+        {
+            list.emplace(key, key);
+        }
+        for (long key = 0; key < 200; key += 3)
+        {
+            list.erase(key);
+        }
+    }
+    EXPECT_EQ(Detection::live_count.load(), 0);
+}
+
+TEST_F(RefOwnerSkipListTest, ConcurrentScansWithInsertAndErase)
+{
+    constexpr long kKeys = 256;
+
+    ref_owner_skip_list<long, Detection> list;
+    std::atomic<bool>                    stop{false};
+
+    std::vector<std::thread> scanners;
+    for (int t = 0; t < 3; ++t)
+    {
+        scanners.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                long previous = -1;
+                for (auto c = list.lower_bound(kKeys / 4); c && c.key() < 3 * kKeys / 4; c.advance())
+                {
+                    // Ordered, and the value is intact while borrowed
+                    EXPECT_GT(c.key(), previous);
+                    EXPECT_EQ(c->stamp, c.key());
+                    previous = c.key();
+                }
+                if (auto ref = list.find(kKeys / 2))
+                {
+                    EXPECT_EQ((*ref)->stamp, kKeys / 2);
+                }
+            }
+        });
+    }
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 2; ++t)
+    {
+        writers.emplace_back([&list, t] {
+            for (int round = 0; round < 3000; ++round)
+            {
+                const long key = (round * 37 + t * 11) % kKeys;
+                if (!list.emplace(key, key))
+                {
+                    list.erase(key);
+                }
+            }
+        });
+    }
+    for (auto& writer : writers)
+    {
+        writer.join();
+    }
+    stop.store(true);
+    for (auto& scanner : scanners)
+    {
+        scanner.join();
+    }
+    EXPECT_EQ(list.reclaim(), 0u);
+    EXPECT_EQ(Detection::live_count.load(), static_cast<int>(list.size()));
+}
+
+// Cache-line aligned, more than operator new guarantees by default
+struct alignas(64) AlignedDetection
+{
+    long stamp;
+
+    explicit AlignedDetection(long s)
+        : stamp(s)
+    {
+    }
+};
+
+TEST_F(RefOwnerSkipListTest, OverAlignedValuesAreAligned)
+{
+    ref_owner_skip_list<long, AlignedDetection> list;
+    for (long key = 0; key < 32; ++key)
+    {
+        ASSERT_TRUE(list.emplace(key, key));
+    }
+    for (long key = 0; key < 32; ++key)
+    {
+        auto found = list.find(key);
+        ASSERT_TRUE(found.has_value());
+        EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&found->get()) % alignof(AlignedDetection), 0U);
+        EXPECT_EQ((*found)->stamp, key);
+    }
+    EXPECT_TRUE(list.erase(5));
+    EXPECT_EQ(list.reclaim(), 0u);
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,218 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/ref_owner_slot_map.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <new>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Track
+{
+    static std::atomic<int> live_count;
+
+    int id;
+
+    explicit Track(int i)
+        : id(i)
+    {
+        live_count.fetch_add(1);
+    }
+    ~Track()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Track::live_count{0};
+
+using track_map = ref_owner_slot_map<Track, std::optional, 8>;
+
+// compact_reference needs a map with static storage duration
+track_map tracks(16);
+
+using track_ref = compact_reference<tracks>;
+
+class RefOwnerSlotMapTest : public ::testing::Test
+{
+protected:
+    void TearDown() override
+    {
+        // Leave the shared map empty for the next test
+        std::vector<slot_handle> live;
+        tracks.for_each([&](slot_handle handle, Track&) { live.push_back(handle); });
+        for (const slot_handle handle : live)
+        {
+            tracks.erase(handle);
+        }
+        EXPECT_EQ(tracks.collect(), 0u);
+        EXPECT_EQ(Track::live_count.load(), 0);
+    }
+};
+
+TEST_F(RefOwnerSlotMapTest, HandlesAndReferencesAreCompact)
+{
+    static_assert(sizeof(slot_handle) == 4, "32-bit handle");
+    static_assert(sizeof(track_ref) == 4, "compact_reference stores only the handle");
+    static_assert(track_map::generation_bits == 24, "remaining bits are generation");
+}
+
+#ifdef __cpp_exceptions
+TEST_F(RefOwnerSlotMapTest, CapacityBeyondHandleRangeThrows)
+{
+    using small_map = ref_owner_slot_map<Track, std::optional, 4>;
+    EXPECT_THROW(small_map(small_map::max_capacity + 1), std::bad_alloc);
+    small_map full(small_map::max_capacity);
+    EXPECT_EQ(full.capacity(), small_map::max_capacity);
+}
+#endif
+
+TEST_F(RefOwnerSlotMapTest, InsertResolveErase)
+{
+    const slot_handle handle = tracks.insert(42);
+    ASSERT_TRUE(handle);
+    EXPECT_TRUE(tracks.contains(handle));
+    EXPECT_EQ(tracks.size(), 1u);
+    {
+        auto ref = track_ref::try_make(handle);
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->id, 42);
+        EXPECT_EQ(ref->handle(), handle);
+
+        auto full = tracks.try_make_ref(handle);
+        ASSERT_TRUE(full.has_value());
+        EXPECT_EQ((*full)->id, 42);
+    }
+    EXPECT_TRUE(tracks.erase(handle));
+    EXPECT_FALSE(tracks.erase(handle));
+    EXPECT_FALSE(tracks.contains(handle));
+    EXPECT_EQ(Track::live_count.load(), 0);
+}
+
+TEST_F(RefOwnerSlotMapTest, StaleHandleNeverResolvesToNewOccupant)
+{
+    const slot_handle first = tracks.insert(1);
+    tracks.erase(first);
+    // Only one slot is free, so the next insert reuses it with a new generation
+    std::vector<slot_handle> fill;
+    for (int i = 0; i < 16; ++i)
+    {
+        fill.push_back(tracks.insert(100 + i));
+    }
+    EXPECT_FALSE(tracks.insert(999));
+    EXPECT_FALSE(track_ref::try_make(first).has_value());
+    EXPECT_FALSE(tracks.try_make_ref(first).has_value());
+    for (const slot_handle handle : fill)
+    {
+        EXPECT_NE(handle, first);
+    }
+}
+
+TEST_F(RefOwnerSlotMapTest, EraseWhileReferencedDefersToCollect)
+{
+    const slot_handle handle = tracks.insert(5);
+    auto              ref    = track_ref::try_make(handle);
+    ASSERT_TRUE(ref.has_value());
+
+    EXPECT_TRUE(tracks.erase(handle));
+    EXPECT_FALSE(track_ref::try_make(handle).has_value());
+    EXPECT_EQ(tracks.pending(), 1u);
+    EXPECT_EQ(tracks.collect(), 1u);
+    EXPECT_EQ((*ref)->id, 5);
+    EXPECT_EQ(Track::live_count.load(), 1);
+
+    ref.reset();
+    EXPECT_EQ(tracks.collect(), 0u);
+    EXPECT_EQ(Track::live_count.load(), 0);
+}
+
+TEST_F(RefOwnerSlotMapTest, ConvertsToFullReference)
+{
+    const slot_handle handle = tracks.insert(8);
+    auto              full   = std::move(*track_ref::try_make(handle)).to_reference();
+    EXPECT_EQ(full->id, 8);
+    tracks.erase(handle);
+    EXPECT_EQ(tracks.pending(), 1u);
+}
+
+TEST_F(RefOwnerSlotMapTest, ForEachVisitsLiveEntries)
+{
+    std::vector<slot_handle> handles;
+    for (int i = 0; i < 6; ++i)
+    {
+        handles.push_back(tracks.insert(i));
+    }
+    tracks.erase(handles[1]);
+    tracks.erase(handles[4]);
+
+    // Slot order depends on which slots earlier tests freed
+    std::vector<int> seen;
+    tracks.for_each([&](slot_handle handle, Track& track) {
+        EXPECT_TRUE(tracks.contains(handle));
+        seen.push_back(track.id);
+    });
+    std::sort(seen.begin(), seen.end());
+    EXPECT_EQ(seen, (std::vector<int>{0, 2, 3, 5}));
+}
+
+TEST_F(RefOwnerSlotMapTest, ConcurrentReadersWithOwnerThreadChurn)
+{
+    std::vector<slot_handle> handles;
+    for (int i = 0; i < 8; ++i)
+    {
+        handles.push_back(tracks.insert(i));
+    }
+    std::atomic<slot_handle> shared[8];
+    for (int i = 0; i < 8; ++i)
+    {
+        shared[i].store(handles[i]);
+    }
+
+    std::atomic<bool>        stop{false};
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r)
+    {
+        readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                for (auto& cell : shared)
+                {
+                    const slot_handle handle = cell.load();
+                    if (auto ref = track_ref::try_make(handle))
+                    {
+                        EXPECT_GE((*ref)->id, 0);
+                    }
+                }
+            }
+        });
+    }
+
+    // Owner thread: erase, collect and reinsert under the readers
+    for (int round = 0; round < 2000; ++round)
+    {
+        auto&             cell = shared[round % 8];
+        const slot_handle old  = cell.load();
+        tracks.erase(old);
+        tracks.collect();
+        const slot_handle fresh = tracks.insert(round);
+        ASSERT_TRUE(fresh);
+        cell.store(fresh);
+    }
+    stop.store(true);
+    for (auto& reader : readers)
+    {
+        reader.join();
+    }
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,194 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/ref_owner_stats.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Frame
+{
+    int id = 0;
+};
+
+static_assert(std::is_same<stats_ref_owner<Frame, no_ref_owner_stats>, ref_owner<Frame>>::value,
+              "disabled stats must be the plain ref_owner");
+static_assert(std::is_same<stats_ref_owner<Frame>, instrumented_ref_owner<Frame>>::value,
+              "enabled stats must be instrumented");
+
+TEST(LatencyHistogramTest, BucketsByPowerOfTwo)
+{
+    using std::chrono::nanoseconds;
+    EXPECT_EQ(latency_histogram::bucket_for(nanoseconds(0)), 0U);
+    EXPECT_EQ(latency_histogram::bucket_for(nanoseconds(1)), 1U);
+    EXPECT_EQ(latency_histogram::bucket_for(nanoseconds(1000)), 10U);
+    EXPECT_EQ(latency_histogram::bucket_for(nanoseconds(1024)), 11U);
+    EXPECT_EQ(latency_histogram::bucket_for(std::chrono::hours(1)), latency_histogram::bucket_count - 1);
+    EXPECT_EQ(latency_histogram::bucket_for(nanoseconds(-5)), 0U);
+
+    latency_histogram h;
+    EXPECT_EQ(h.percentile(0.5), nanoseconds(0));
+    h.buckets[3]  = 90;
+    h.buckets[10] = 10;
+    EXPECT_EQ(h.count(), 100U);
+    EXPECT_EQ(h.percentile(0.5), nanoseconds(8));
+    EXPECT_EQ(h.percentile(0.9), nanoseconds(8));
+    EXPECT_EQ(h.percentile(0.99), nanoseconds(1024));
+}
+
+TEST(RefOwnerStatsTest, CountsReferenceCreation)
+{
+    ref_owner_stats               stats;
+    instrumented_ref_owner<Frame> frame(new Frame, stats);
+    {
+        auto a = frame.try_make_ref();
+        auto b = frame.try_make_ref();
+        auto c = frame.try_make_ref();
+        ASSERT_TRUE(a && b && c);
+    }
+    auto held = frame.try_make_ref();
+    ASSERT_TRUE(held);
+
+    using reference = instrumented_ref_owner<Frame>::reference;
+    std::vector<reference> batch;
+    EXPECT_TRUE(frame.try_make_refs(4, [&](reference&& r) { batch.push_back(std::move(r)); }));
+
+    frame.mark_for_deletion();
+    EXPECT_FALSE(frame.try_make_ref());
+    EXPECT_FALSE(frame.try_make_refs(2, [](reference&&) {}));
+
+    const ref_owner_stats_snapshot s = stats.snapshot();
+    EXPECT_EQ(s.try_make_ref_succeeded, 8U);
+    EXPECT_EQ(s.try_make_ref_failed, 3U);
+    EXPECT_EQ(s.ref_count_high_water, 5U);
+
+    batch.clear();
+    held.reset();
+    EXPECT_TRUE(frame.delete_if_deleteable());
+}
+
+TEST(RefOwnerStatsTest, RecordsDrainAndDeleteLatency)
+{
+    ref_owner_stats               stats;
+    instrumented_ref_owner<Frame> frame(new Frame, stats);
+    {
+        auto ref = frame.try_make_ref();
+        ASSERT_TRUE(ref);
+        EXPECT_FALSE(frame.mark_and_delete_if_ready());
+        EXPECT_FALSE(frame.delete_if_deleteable());
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+
+        const ref_owner_stats_snapshot s = stats.snapshot();
+        EXPECT_EQ(s.deletes_blocked, 2U);
+        EXPECT_EQ(s.mark_to_drain.count(), 0U);
+    }
+
+    ref_owner_stats_snapshot s = stats.snapshot();
+    ASSERT_EQ(s.mark_to_drain.count(), 1U);
+    EXPECT_GE(s.mark_to_drain.percentile(1.0), std::chrono::milliseconds(2));
+    EXPECT_EQ(s.mark_to_delete.count(), 0U);
+
+    EXPECT_TRUE(frame.delete_if_deleteable());
+    EXPECT_FALSE(frame.delete_if_deleteable());  // Already deleted: not "blocked"
+    s = stats.snapshot();
+    EXPECT_EQ(s.mark_to_delete.count(), 1U);
+    EXPECT_GE(s.mark_to_delete.percentile(1.0), s.mark_to_drain.percentile(1.0));
+    EXPECT_EQ(s.deletes_blocked, 2U);
+}
+
+TEST(RefOwnerStatsTest, MarkWithNothingOutstandingDrainsOnce)
+{
+    ref_owner_stats               stats;
+    instrumented_ref_owner<Frame> frame(new Frame, stats);
+    frame.mark_for_deletion();
+    frame.mark_for_deletion();
+    EXPECT_FALSE(frame.try_make_ref());  // Rolled-back registration is not a second drain
+    EXPECT_TRUE(frame.delete_if_deleteable());
+
+    const ref_owner_stats_snapshot s = stats.snapshot();
+    EXPECT_EQ(s.mark_to_drain.count(), 1U);
+    EXPECT_EQ(s.mark_to_delete.count(), 1U);
+    EXPECT_EQ(s.deletes_blocked, 0U);
+}
+
+TEST(RefOwnerStatsTest, ExclusiveReleaseDrains)
+{
+    ref_owner_stats               stats;
+    instrumented_ref_owner<Frame> frame(new Frame, stats);
+    {
+        auto exclusive = frame.try_make_exclusive_ref();
+        ASSERT_TRUE(exclusive);
+        frame.mark_for_deletion();
+        EXPECT_EQ(stats.snapshot().mark_to_drain.count(), 0U);
+    }
+    EXPECT_EQ(stats.snapshot().mark_to_drain.count(), 1U);
+    EXPECT_TRUE(frame.delete_if_deleteable());
+}
+
+TEST(RefOwnerStatsTest, PerTypeStatsByDefault)
+{
+    struct Tile
+    {};
+    const std::uint64_t before = ref_owner_stats::for_type<Tile>().snapshot().try_make_ref_succeeded;
+    {
+        instrumented_ref_owner<Tile> a(new Tile);
+        instrumented_ref_owner<Tile> b(new Tile);
+        EXPECT_EQ(&a.stats(), &ref_owner_stats::for_type<Tile>());
+        EXPECT_TRUE(a.try_make_ref());
+        EXPECT_TRUE(b.try_make_ref());
+        EXPECT_TRUE(a.mark_and_delete_if_ready());
+        EXPECT_TRUE(b.mark_and_delete_if_ready());
+    }
+    const ref_owner_stats_snapshot s = ref_owner_stats::for_type<Tile>().snapshot();
+    EXPECT_EQ(s.try_make_ref_succeeded - before, 2U);
+}
+
+TEST(RefOwnerStatsTest, ConcurrentRecordingLosesNothing)
+{
+    ref_owner_stats               stats;
+    instrumented_ref_owner<Frame> frame(new Frame, stats);
+    std::vector<std::thread>      threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    auto ref = frame.try_make_ref();
+                    EXPECT_TRUE(ref);
+                }
+            });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    const ref_owner_stats_snapshot s = stats.snapshot();
+    EXPECT_EQ(s.try_make_ref_succeeded, 4000U);
+    EXPECT_GE(s.ref_count_high_water, 1U);
+    EXPECT_LE(s.ref_count_high_water, 4U);
+    EXPECT_TRUE(frame.mark_and_delete_if_ready());
+}
+
+TEST(RefOwnerStatsTest, StatsRefOwnerCompilesAwayWhenDisabled)
+{
+    stats_ref_owner<Frame, no_ref_owner_stats> plain(new Frame);
+    stats_ref_owner<Frame>                     counted(new Frame);
+    EXPECT_TRUE(plain.try_make_ref());
+    EXPECT_TRUE(counted.try_make_ref());
+    EXPECT_TRUE(plain.mark_and_delete_if_ready());
+    EXPECT_TRUE(counted.mark_and_delete_if_ready());
+}
+
+}  // namespace
+}  // namespace zoox
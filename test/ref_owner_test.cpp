@@ -6,7 +6,9 @@
 #include <gtest/gtest.h>
 
 #include <atomic>
+#include <stdexcept>
 #include <thread>
+#include <vector>
 
 namespace zoox
 {
@@ -199,6 +201,56 @@ TEST_F(RefOwnerTest, TryMakeRefReturnsNulloptAfterMarkedForDeletion)
     ptr.delete_if_deleteable();
 }
 
+TEST_F(RefOwnerTest, TryMakeRefsRegistersBatch)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+
+    std::vector<unique_reference<TestObject>> refs;
+    EXPECT_TRUE(ptr.try_make_refs(3, [&](unique_reference<TestObject>&& ref) { refs.push_back(std::move(ref)); }));
+    ASSERT_EQ(refs.size(), 3U);
+    EXPECT_EQ(ptr.ref_count(), 3U);
+    EXPECT_EQ(refs[2].get().value, 42);
+
+    refs.clear();
+    EXPECT_EQ(ptr.ref_count(), 0U);
+    EXPECT_TRUE(ptr.mark_and_delete_if_ready());
+}
+
+TEST_F(RefOwnerTest, TryMakeRefsFailsAfterMarkedForDeletion)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    ptr.mark_for_deletion();
+
+    int handed = 0;
+    EXPECT_FALSE(ptr.try_make_refs(4, [&](unique_reference<TestObject>&&) { ++handed; }));
+    EXPECT_EQ(handed, 0);
+    EXPECT_EQ(ptr.ref_count(), 0U);
+    EXPECT_TRUE(ptr.delete_if_deleteable());
+}
+
+#ifdef __cpp_exceptions
+TEST_F(RefOwnerTest, TryMakeRefsReleasesUnhandedRefsOnThrow)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+
+    std::vector<unique_reference<TestObject>> refs;
+    EXPECT_THROW(ptr.try_make_refs(4,
+                                   [&](unique_reference<TestObject>&& ref)
+                                   {
+                                       if (refs.size() == 2)
+                                       {
+                                           throw std::runtime_error("consumer full");
+                                       }
+                                       refs.push_back(std::move(ref));
+                                   }),
+                 std::runtime_error);
+    EXPECT_EQ(ptr.ref_count(), 2U);
+
+    refs.clear();
+    EXPECT_TRUE(ptr.mark_and_delete_if_ready());
+}
+#endif
+
 #ifdef __cpp_exceptions
 TEST_F(RefOwnerTest, MakeRefThrowsAfterMarkedForDeletion)
 {
@@ -619,6 +671,273 @@ TEST_F(RefOwnerTest, ReferenceMove_RefCountCorrectOnDestruction)
     EXPECT_TRUE(ptr.is_deleted());
 }
 
+// =============================================================================
+// Exclusive Reference Tests
+// =============================================================================
+
+TEST_F(RefOwnerTest, ExclusiveRef_SucceedsWithNoOtherRefs)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    {
+        auto writer = ptr.try_make_exclusive_ref();
+        ASSERT_TRUE(writer.has_value());
+        (*writer)->value = 43;
+        EXPECT_TRUE(ptr.is_exclusively_borrowed());
+        EXPECT_TRUE(ptr.has_outstanding_references());
+        EXPECT_EQ(ptr.ref_count(), 1u);
+    }
+    EXPECT_FALSE(ptr.is_exclusively_borrowed());
+    EXPECT_EQ(ptr.ref_count(), 0u);
+    EXPECT_EQ(ptr->value, 43);
+    EXPECT_TRUE(ptr.mark_and_delete_if_ready());
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_FailsWhileSharedRefHeld)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    auto reader = ptr.make_ref();
+
+    EXPECT_FALSE(ptr.try_make_exclusive_ref().has_value());
+    EXPECT_EQ(ptr.ref_count(), 1u);
+    EXPECT_FALSE(ptr.is_exclusively_borrowed());
+
+    ptr.mark_for_deletion();
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_BlocksSharedRefs)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    auto writer = ptr.try_make_exclusive_ref();
+    ASSERT_TRUE(writer.has_value());
+
+    EXPECT_FALSE(ptr.try_make_ref().has_value());
+    EXPECT_FALSE(ptr.try_make_exclusive_ref().has_value());
+#ifdef __cpp_exceptions
+    EXPECT_THROW(ptr.make_ref(), ref_owner_exclusive_exception);
+#endif
+    EXPECT_EQ(ptr.ref_count(), 1u);
+
+    writer.reset();
+    EXPECT_TRUE(ptr.try_make_ref().has_value());
+    ptr.mark_and_delete_if_ready();
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_BlocksDeletion)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    auto writer = ptr.try_make_exclusive_ref();
+    ASSERT_TRUE(writer.has_value());
+
+    EXPECT_FALSE(ptr.mark_and_delete_if_ready());
+    EXPECT_EQ(TestObject::destruction_count.load(), 0);
+
+    writer.reset();
+    EXPECT_TRUE(ptr.delete_if_deleteable());
+    EXPECT_EQ(TestObject::destruction_count.load(), 1);
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_FailsAfterMarkedForDeletion)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    ptr.mark_for_deletion();
+
+    EXPECT_FALSE(ptr.try_make_exclusive_ref().has_value());
+    EXPECT_EQ(ptr.ref_count(), 0u);
+    EXPECT_TRUE(ptr.delete_if_deleteable());
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_UpgradeAndDowngrade)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    auto reader = ptr.make_ref();
+
+    auto writer = zoox::try_upgrade_reference(std::move(reader));
+    ASSERT_TRUE(writer.has_value());
+    EXPECT_TRUE(ptr.is_exclusively_borrowed());
+    EXPECT_EQ(ptr.ref_count(), 1u);
+    (*writer)->value = 7;
+
+    auto reader_again = zoox::downgrade_reference(std::move(*writer));
+    EXPECT_FALSE(ptr.is_exclusively_borrowed());
+    EXPECT_EQ(ptr.ref_count(), 1u);
+    EXPECT_EQ(reader_again->value, 7);
+
+    writer.reset();  // moved-from, must not release anything
+    EXPECT_EQ(ptr.ref_count(), 1u);
+
+    auto second_reader = ptr.try_make_ref();
+    EXPECT_TRUE(second_reader.has_value());
+    EXPECT_EQ(ptr.ref_count(), 2u);
+
+    ptr.mark_for_deletion();
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_UpgradeFailsWithOtherReaders)
+{
+    ref_owner<TestObject> ptr(new TestObject(42));
+    auto reader1 = ptr.make_ref();
+    auto reader2 = ptr.make_ref();
+
+    auto writer = zoox::try_upgrade_reference(std::move(reader1));
+    EXPECT_FALSE(writer.has_value());
+    EXPECT_EQ(reader1->value, 42);  // NOLINT: not moved-from on failure
+    EXPECT_EQ(ptr.ref_count(), 2u);
+
+    ptr.mark_for_deletion();
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_WaitableNotifiedOnRelease)
+{
+    waitable_ref_owner<TestObject> ptr(new TestObject(42));
+    auto writer = ptr.try_make_exclusive_ref();
+    ASSERT_TRUE(writer.has_value());
+
+    std::thread waiter([&ptr]() { ptr.mark_and_wait_for_deletion(); });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writer.reset();
+
+    waiter.join();
+    EXPECT_EQ(TestObject::destruction_count.load(), 1);
+}
+
+TEST_F(RefOwnerTest, ExclusiveRef_ConcurrentReadersAndWriters)
+{
+    ref_owner<TestObject> ptr(new TestObject(0));
+    std::atomic<int>      writes{0};
+
+    constexpr int kNumThreads = 8;
+    constexpr int kIterations = 1000;
+
+    std::vector<std::thread> threads;
+    threads.reserve(kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t)
+    {
+        threads.emplace_back([&ptr, &writes, t]() {
+            for (int i = 0; i < kIterations; ++i)
+            {
+                if ((t % 2) == 0)
+                {
+                    auto writer = ptr.try_make_exclusive_ref();
+                    if (writer.has_value())
+                    {
+                        // Plain int: a racing reader would be caught by TSAN
+                        (*writer)->value += 1;
+                        writes.fetch_add(1);
+                    }
+                }
+                else
+                {
+                    auto reader = ptr.try_make_ref();
+                    if (reader.has_value())
+                    {
+                        EXPECT_GE((*reader)->value, 0);
+                    }
+                }
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_EQ(ptr->value, writes.load());
+    EXPECT_FALSE(ptr.has_outstanding_references());
+    EXPECT_TRUE(ptr.mark_and_delete_if_ready());
+}
+
+// =============================================================================
+// weak_observer Tests
+// =============================================================================
+
+TEST_F(RefOwnerTest, WeakObserver_DoesNotCount)
+{
+    ref_owner<TestObject>     ptr(new TestObject(42));
+    weak_observer<TestObject> observer(ptr);
+
+    EXPECT_EQ(ptr.ref_count(), 0u);
+    EXPECT_FALSE(observer.expired());
+    EXPECT_TRUE(ptr.mark_and_delete_if_ready());
+    EXPECT_TRUE(observer.expired());
+}
+
+TEST_F(RefOwnerTest, WeakObserver_UpgradeRegistersReference)
+{
+    ref_owner<TestObject>     ptr(new TestObject(42));
+    weak_observer<TestObject> observer(ptr);
+    {
+        auto ref = observer.try_upgrade();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->value, 42);
+        EXPECT_EQ(ptr.ref_count(), 1u);
+    }
+    EXPECT_EQ(ptr.ref_count(), 0u);
+    ptr.mark_and_delete_if_ready();
+}
+
+TEST_F(RefOwnerTest, WeakObserver_UpgradeFailsAfterMark)
+{
+    ref_owner<TestObject>     ptr(new TestObject(42));
+    weak_observer<TestObject> observer(ptr);
+
+    ptr.mark_for_deletion();
+    EXPECT_FALSE(observer.try_upgrade().has_value());
+    EXPECT_EQ(ptr.ref_count(), 0u);
+    EXPECT_TRUE(ptr.delete_if_deleteable());
+    EXPECT_FALSE(observer.try_upgrade().has_value());
+}
+
+TEST_F(RefOwnerTest, WeakObserver_EmptyObserver)
+{
+    weak_observer<TestObject> observer;
+    EXPECT_TRUE(observer.expired());
+    EXPECT_FALSE(observer.try_upgrade().has_value());
+}
+
+TEST_F(RefOwnerTest, WeakObserver_UpgradeFailsAfterOwnerMovedFrom)
+{
+    ref_owner<TestObject>     ptr1(new TestObject(42));
+    weak_observer<TestObject> observer(ptr1);
+
+    ref_owner<TestObject> ptr2(std::move(ptr1));
+    EXPECT_TRUE(observer.expired());
+    EXPECT_FALSE(observer.try_upgrade().has_value());
+    EXPECT_EQ(ptr1.ref_count(), 0u);  // NOLINT: testing moved-from state
+
+    ptr2.mark_and_delete_if_ready();
+    ptr1.mark_for_deletion();
+}
+
+// Pools recycle owners through the protected rearm()
+class RearmableOwner : public ref_owner<TestObject>
+{
+public:
+    using ref_owner<TestObject>::ref_owner;
+    using ref_owner<TestObject>::rearm;
+};
+
+TEST_F(RefOwnerTest, WeakObserver_UpgradeFailsAfterRearm)
+{
+    RearmableOwner            owner(new TestObject(1));
+    weak_observer<TestObject> observer(owner);
+    ASSERT_TRUE(owner.mark_and_delete_if_ready());
+
+    // The rearmed, unmarked owner must not satisfy the observer
+    owner.rearm(new TestObject(2));
+    EXPECT_TRUE(observer.expired());
+    EXPECT_FALSE(observer.try_upgrade().has_value());
+    EXPECT_EQ(owner.ref_count(), 0u);
+
+    weak_observer<TestObject> fresh(owner);
+    auto                      ref = fresh.try_upgrade();
+    ASSERT_TRUE(ref.has_value());
+    EXPECT_EQ((*ref)->value, 2);
+    ref.reset();
+
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
 // =============================================================================
 // Custom Deleter Tests
 // =============================================================================
@@ -0,0 +1,262 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/reference_channel.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Frame
+{
+    int sequence;
+};
+
+using frame_ref = unique_reference<Frame>;
+
+class ReferenceChannelTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        for (int i = 0; i < kOwners; ++i)
+        {
+            owners_.push_back(std::make_unique<ref_owner<Frame>>(new Frame{i}));
+        }
+    }
+
+    void TearDown() override
+    {
+        for (auto& owner : owners_)
+        {
+            EXPECT_EQ(owner->ref_count(), 0u);
+            EXPECT_TRUE(owner->mark_and_delete_if_ready());
+        }
+    }
+
+    static constexpr int kOwners = 8;
+
+    std::vector<std::unique_ptr<ref_owner<Frame>>> owners_;
+};
+
+TEST_F(ReferenceChannelTest, SpscPushPopInOrder)
+{
+    spsc_channel<frame_ref, 4> channel;
+    EXPECT_FALSE(channel.try_pop().has_value());
+    for (int i = 0; i < 4; ++i)
+    {
+        EXPECT_TRUE(channel.try_push(owners_[i]->make_ref()));
+    }
+    EXPECT_EQ(owners_[0]->ref_count(), 1u);
+
+    // Full: the reference stays with the caller
+    auto extra = owners_[4]->make_ref();
+    EXPECT_FALSE(channel.try_push(std::move(extra)));
+    EXPECT_EQ(extra->sequence, 4);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        auto ref = channel.try_pop();
+        ASSERT_TRUE(ref.has_value());
+        EXPECT_EQ((*ref)->sequence, i);
+    }
+    EXPECT_EQ(channel.size(), 0u);
+}
+
+TEST_F(ReferenceChannelTest, BatchPushAndPop)
+{
+    mpmc_channel<frame_ref, 8> channel;
+    std::vector<frame_ref>     batch;
+    for (int i = 0; i < 6; ++i)
+    {
+        batch.push_back(owners_[i]->make_ref());
+    }
+    EXPECT_EQ(channel.try_push_n(batch.data(), batch.size()), 6u);
+    batch.clear();
+
+    std::vector<int> seen;
+    EXPECT_EQ(channel.try_pop_n([&](frame_ref&& ref) { seen.push_back(ref->sequence); }, 4), 4u);
+    EXPECT_EQ(channel.try_pop_n([&](frame_ref&& ref) { seen.push_back(ref->sequence); }, 4), 2u);
+    EXPECT_EQ(seen, (std::vector<int>{0, 1, 2, 3, 4, 5}));
+
+    spsc_channel<frame_ref, 4> small;
+    for (int i = 0; i < 6; ++i)
+    {
+        batch.push_back(owners_[i]->make_ref());
+    }
+    EXPECT_EQ(small.try_push_n(batch.data(), batch.size()), 4u);
+    EXPECT_EQ(batch[4]->sequence, 4);  // Not pushed, still valid
+    batch.clear();
+    EXPECT_EQ(small.try_pop_n([](frame_ref&&) {}, 10), 4u);
+}
+
+#ifdef __cpp_exceptions
+TEST_F(ReferenceChannelTest, ThrowingConsumerLeavesChannelsUsable)
+{
+    const auto throw_on_second = [](int& calls)
+    {
+        return [&calls](frame_ref&&)
+        {
+            if (++calls == 2)
+            {
+                throw std::runtime_error("consumer failed");
+            }
+        };
+    };
+
+    // spsc: the rest of the batch stays queued, nothing is destroyed twice
+    {
+        spsc_channel<frame_ref, 8> spsc;
+        for (int i = 0; i < 4; ++i)
+        {
+            spsc.try_push(owners_[i]->make_ref());
+        }
+        int calls = 0;
+        EXPECT_THROW(spsc.try_pop_n(throw_on_second(calls), 4), std::runtime_error);
+        EXPECT_EQ(owners_[0]->ref_count(), 0u);
+        EXPECT_EQ(owners_[1]->ref_count(), 0u);
+        EXPECT_EQ(spsc.size(), 2u);
+        std::vector<int> seen;
+        EXPECT_EQ(spsc.try_pop_n([&](frame_ref&& ref) { seen.push_back(ref->sequence); }, 4), 2u);
+        EXPECT_EQ(seen, (std::vector<int>{2, 3}));
+    }
+
+    // mpmc: the claimed rest of the batch is released and every cell freed
+    {
+        mpmc_channel<frame_ref, 4> mpmc;
+        for (int i = 0; i < 4; ++i)
+        {
+            mpmc.try_push(owners_[i]->make_ref());
+        }
+        int calls = 0;
+        EXPECT_THROW(mpmc.try_pop_n(throw_on_second(calls), 4), std::runtime_error);
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_EQ(owners_[i]->ref_count(), 0u) << i;
+        }
+        for (int i = 0; i < 4; ++i)
+        {
+            EXPECT_TRUE(mpmc.try_push(owners_[i + 4]->make_ref())) << i;
+        }
+        EXPECT_EQ(mpmc.try_pop_n([](frame_ref&&) {}, 4), 4u);
+    }
+}
+#endif
+
+TEST_F(ReferenceChannelTest, DestructorReleasesLeftovers)
+{
+    {
+        spsc_channel<frame_ref, 8> spsc;
+        mpmc_channel<frame_ref, 8> mpmc;
+        spsc.try_push(owners_[0]->make_ref());
+        spsc.try_push(owners_[1]->make_ref());
+        mpmc.try_push(owners_[2]->make_ref());
+        EXPECT_EQ(owners_[2]->ref_count(), 1u);
+    }
+    // TearDown checks every count is back to zero
+}
+
+TEST_F(ReferenceChannelTest, CloseWakesBlockedConsumer)
+{
+    mpmc_channel<frame_ref, 4> channel;
+    std::thread                consumer([&] {
+        int received = 0;
+        while (auto ref = channel.pop())
+        {
+            ++received;
+        }
+        EXPECT_EQ(received, 1);
+    });
+    channel.push(owners_[0]->make_ref());
+    channel.close();
+    consumer.join();
+    EXPECT_FALSE(channel.push(owners_[1]->make_ref()));
+}
+
+TEST_F(ReferenceChannelTest, SpscBlockingPipeline)
+{
+    constexpr int kMessages = 20000;
+
+    spsc_channel<frame_ref, 16> channel;
+    std::thread                 producer([&] {
+        for (int i = 0; i < kMessages; ++i)
+        {
+            ASSERT_TRUE(channel.push(owners_[i % kOwners]->make_ref()));
+        }
+        channel.close();
+    });
+    int expected = 0;
+    while (auto ref = channel.pop())
+    {
+        EXPECT_EQ((*ref)->sequence, expected % kOwners);
+        ++expected;
+    }
+    producer.join();
+    EXPECT_EQ(expected, kMessages);
+}
+
+TEST_F(ReferenceChannelTest, MpmcManyProducersManyConsumers)
+{
+    constexpr int kProducers   = 3;
+    constexpr int kConsumers   = 3;
+    constexpr int kPerProducer = 10000;
+
+    mpmc_channel<frame_ref, 64> channel;
+    std::atomic<long>           sum{0};
+    std::atomic<int>            count{0};
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c)
+    {
+        consumers.emplace_back([&] {
+            while (auto ref = channel.pop())
+            {
+                sum.fetch_add((*ref)->sequence);
+                count.fetch_add(1);
+            }
+        });
+    }
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p)
+    {
+        producers.emplace_back([&, p] {
+            for (int i = 0; i < kPerProducer; i += 2)
+            {
+                frame_ref   pair[2] = {owners_[p]->make_ref(), owners_[p]->make_ref()};
+                std::size_t pushed  = 0;
+                while (pushed < 2)
+                {
+                    pushed += channel.try_push_n(pair + pushed, 2 - pushed);
+                    if (pushed < 2)
+                    {
+                        ASSERT_TRUE(channel.push(std::move(pair[pushed])));
+                        ++pushed;
+                    }
+                }
+            }
+        });
+    }
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+    channel.close();
+    for (auto& consumer : consumers)
+    {
+        consumer.join();
+    }
+    EXPECT_EQ(count.load(), kProducers * kPerProducer);
+    EXPECT_EQ(sum.load(), static_cast<long>(kPerProducer) * (0 + 1 + 2));
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,252 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/replicated_ref_owner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct MapLayer
+{
+    static std::atomic<int> live_count;
+
+    std::vector<int> cells;
+
+    explicit MapLayer(std::vector<int> c)
+        : cells(std::move(c))
+    {
+        live_count.fetch_add(1);
+    }
+    MapLayer(const MapLayer& other)
+        : cells(other.cells)
+    {
+        live_count.fetch_add(1);
+    }
+    MapLayer(MapLayer&& other) noexcept
+        : cells(std::move(other.cells))
+    {
+        live_count.fetch_add(1);
+    }
+    ~MapLayer()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> MapLayer::live_count{0};
+
+class ReplicatedRefOwnerTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        MapLayer::live_count.store(0);
+    }
+};
+
+TEST_F(ReplicatedRefOwnerTest, DefaultsToOneReplicaPerNode)
+{
+    replicated_ref_owner<MapLayer> layer(MapLayer({1, 2, 3}));
+    EXPECT_EQ(layer.replica_count(), numa::node_count());
+    EXPECT_GE(layer.replica_count(), 1u);
+
+    {
+        auto ref = layer.make_ref();
+        static_assert(std::is_same_v<decltype(ref.get()), const MapLayer&>, "replicas are read-only");
+        EXPECT_EQ(ref->cells.size(), 3u);
+        EXPECT_EQ(layer.ref_count(), 1u);
+    }
+    EXPECT_TRUE(layer.mark_and_delete_if_ready());
+}
+
+TEST(NumaTopologyTest, CpuToNodeTableCoversTheCurrentCpu)
+{
+    const std::vector<std::uint8_t> nodes = numa::detail::read_cpu_nodes();
+    ASSERT_FALSE(nodes.empty());
+    const int cpu = sched_getcpu();
+    ASSERT_GE(cpu, 0);
+    EXPECT_LT(static_cast<std::size_t>(cpu), nodes.size());
+    for (const std::uint8_t node : nodes)
+    {
+        EXPECT_LT(node, numa::node_count());
+    }
+    EXPECT_LT(numa::current_node(), numa::node_count());
+}
+
+TEST(NumaTopologyTest, NodeAllocationsArePageAlignedMappings)
+{
+    const std::size_t size   = numa::page_size() + 1;
+    void*             memory = numa::allocate_on_node(size, numa::node_count() - 1);
+    ASSERT_NE(memory, nullptr);
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(memory) % numa::page_size(), 0U);
+    std::memset(memory, 0xA5, size);  // Both pages are backed
+    numa::deallocate(memory, size);
+}
+
+TEST_F(ReplicatedRefOwnerTest, EachReplicaIsAnIndependentCopy)
+{
+    replicated_ref_owner<MapLayer> layer(MapLayer({7, 8}), 3);
+    EXPECT_EQ(layer.replica_count(), 3u);
+    EXPECT_EQ(MapLayer::live_count.load(), 3);
+
+    auto r0 = layer.try_make_ref_on(0);
+    auto r1 = layer.try_make_ref_on(1);
+    auto r2 = layer.try_make_ref_on(2);
+    ASSERT_TRUE(r0 && r1 && r2);
+    EXPECT_NE(&r0->get(), &r1->get());
+    EXPECT_NE(&r1->get(), &r2->get());
+    EXPECT_EQ((*r2)->cells, (std::vector<int>{7, 8}));
+    EXPECT_EQ(layer.ref_count(), 3u);
+
+    r0.reset();
+    r1.reset();
+    r2.reset();
+    EXPECT_TRUE(layer.mark_and_delete_if_ready());
+}
+
+TEST_F(ReplicatedRefOwnerTest, MarkAppliesToEveryReplica)
+{
+    replicated_ref_owner<MapLayer> layer(MapLayer({1}), 2);
+    layer.mark_for_deletion();
+
+    EXPECT_TRUE(layer.is_marked_for_deletion());
+    EXPECT_FALSE(layer.try_make_ref_on(0).has_value());
+    EXPECT_FALSE(layer.try_make_ref_on(1).has_value());
+    EXPECT_TRUE(layer.delete_if_deleteable());
+}
+
+TEST_F(ReplicatedRefOwnerTest, DeletionWaitsForEveryReplicaToDrain)
+{
+    {
+        replicated_ref_owner<MapLayer> layer(MapLayer({1}), 2);
+        auto                           remote = layer.try_make_ref_on(1);
+        ASSERT_TRUE(remote.has_value());
+
+        EXPECT_FALSE(layer.mark_and_delete_if_ready());
+        EXPECT_FALSE(layer.is_deleted());
+        EXPECT_EQ(MapLayer::live_count.load(), 2);  // No replica deleted early
+
+        remote.reset();
+        EXPECT_TRUE(layer.delete_if_deleteable());
+        EXPECT_TRUE(layer.is_deleted());
+        EXPECT_FALSE(layer.delete_if_deleteable());
+        EXPECT_EQ(MapLayer::live_count.load(), 0);
+    }
+}
+
+TEST_F(ReplicatedRefOwnerTest, ConcurrentBorrowersAcrossReplicas)
+{
+    replicated_ref_owner<MapLayer> layer(MapLayer({5}), 4);
+
+    constexpr int kNumThreads = 8;
+    constexpr int kIterations = 500;
+
+    std::vector<std::thread> threads;
+    threads.reserve(kNumThreads);
+    for (int t = 0; t < kNumThreads; ++t)
+    {
+        threads.emplace_back([&layer, t]() {
+            for (int i = 0; i < kIterations; ++i)
+            {
+                auto ref = layer.try_make_ref_on(static_cast<std::size_t>(t + i));
+                ASSERT_TRUE(ref.has_value());
+                EXPECT_EQ((*ref)->cells.front(), 5);
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    EXPECT_FALSE(layer.has_outstanding_references());
+    EXPECT_TRUE(layer.mark_and_delete_if_ready());
+}
+
+// The first destructor to run parks until release is set
+struct ParkingDestructor
+{
+    static std::atomic<bool> park_next;
+    static std::atomic<bool> parked;
+    static std::atomic<bool> release;
+
+    ~ParkingDestructor()
+    {
+        if (park_next.exchange(false))
+        {
+            parked.store(true);
+            while (!release.load())
+            {
+                std::this_thread::yield();
+            }
+        }
+    }
+};
+
+std::atomic<bool> ParkingDestructor::park_next{false};
+std::atomic<bool> ParkingDestructor::parked{false};
+std::atomic<bool> ParkingDestructor::release{false};
+
+TEST_F(ReplicatedRefOwnerTest, ConcurrentDeletersSeeExactlyOneSuccess)
+{
+    replicated_ref_owner<ParkingDestructor> layer(ParkingDestructor(), 3);
+    layer.mark_for_deletion();
+    ParkingDestructor::park_next.store(true);
+
+    // The first deleter parks inside replica 0's destructor, the second
+    // deletes replicas 1 and 2 meanwhile; only the first finishes the set
+    bool first = false;
+    std::thread deleter([&]() { first = layer.delete_if_deleteable(); });
+    while (!ParkingDestructor::parked.load())
+    {
+        std::this_thread::yield();
+    }
+    EXPECT_FALSE(layer.delete_if_deleteable());
+    ParkingDestructor::release.store(true);
+    deleter.join();
+
+    EXPECT_TRUE(first);
+    EXPECT_TRUE(layer.is_deleted());
+    EXPECT_FALSE(layer.delete_if_deleteable());
+}
+
+#ifdef __cpp_exceptions
+// Copying throws once copies_left reaches zero
+struct ThrowingCopy
+{
+    static int copies_left;
+
+    ThrowingCopy() = default;
+    ThrowingCopy(ThrowingCopy&&) noexcept = default;
+    ThrowingCopy(const ThrowingCopy&)
+    {
+        if (copies_left-- <= 0)
+        {
+            throw std::runtime_error("copy failed");
+        }
+    }
+};
+
+int ThrowingCopy::copies_left = 0;
+
+TEST_F(ReplicatedRefOwnerTest, ThrowingCopyUnwindsEveryReplica)
+{
+    ThrowingCopy::copies_left = 1;  // Second copy (third replica) throws
+    EXPECT_THROW(replicated_ref_owner<ThrowingCopy>(ThrowingCopy(), 3), std::runtime_error);
+}
+#endif
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,215 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/shared_memory_owner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace zoox
+{
+namespace
+{
+
+struct Frame
+{
+    std::uint64_t sequence;
+    float         points[1024];
+};
+
+using frame_owner    = shm_ref_owner<Frame>;
+using frame_borrower = shm_borrower<Frame>;
+
+// Runs f in a child process; returns its exit status (or -1)
+template <typename F>
+int run_in_child(F&& f)
+{
+    const pid_t pid = fork();
+    if (pid == 0)
+    {
+        _exit(f());
+    }
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status))
+    {
+        return -1;
+    }
+    return WEXITSTATUS(status);
+}
+
+class SharedMemoryOwnerTest : public ::testing::Test
+{
+protected:
+    shared_segment segment = shared_segment::create_memfd("zoox_test", frame_owner::required_size());
+};
+
+TEST_F(SharedMemoryOwnerTest, PublishesNothingUntilRearmed)
+{
+    ASSERT_TRUE(segment);
+    frame_owner owner(segment);
+    ASSERT_TRUE(owner);
+    EXPECT_TRUE(owner.is_deleted());
+    EXPECT_EQ(owner.get(), nullptr);
+    EXPECT_FALSE(owner.try_make_ref());
+
+    EXPECT_TRUE(owner.rearm(Frame{7, {}}));
+    EXPECT_EQ(owner.generation(), 1U);
+    ASSERT_NE(owner.get(), nullptr);
+    EXPECT_EQ(owner.get()->sequence, 7U);
+}
+
+TEST_F(SharedMemoryOwnerTest, BorrowsThroughAnotherMapping)
+{
+    frame_owner owner(segment);
+    owner.rearm(Frame{42, {1.5F}});
+
+    shared_segment second = shared_segment::from_fd(dup(segment.fd()));
+    ASSERT_TRUE(second);
+    ASSERT_NE(second.data(), segment.data());
+
+    frame_borrower borrower(second);
+    ASSERT_TRUE(borrower);
+    auto ref = borrower.try_make_ref();
+    ASSERT_TRUE(ref);
+    EXPECT_EQ((*ref)->sequence, 42U);
+    EXPECT_EQ((*ref)->points[0], 1.5F);
+    EXPECT_NE(&ref->get(), owner.get());
+    EXPECT_EQ(static_cast<const void*>(static_cast<unsigned char*>(segment.data()) + ref->offset()),
+              static_cast<const void*>(owner.get()));
+    EXPECT_EQ(owner.ref_count(), 1U);
+}
+
+TEST_F(SharedMemoryOwnerTest, DeletionWaitsForEveryHolder)
+{
+    frame_owner    owner(segment);
+    frame_borrower borrower(segment);
+    owner.rearm(Frame{1, {}});
+
+    {
+        auto mine   = owner.try_make_ref();
+        auto theirs = borrower.try_make_ref();
+        ASSERT_TRUE(mine && theirs);
+
+        EXPECT_FALSE(owner.mark_and_delete_if_ready());
+        EXPECT_FALSE(borrower.try_make_ref());
+        EXPECT_FALSE(owner.rearm(Frame{2, {}}));
+    }
+    EXPECT_TRUE(owner.delete_if_deleteable());
+    EXPECT_TRUE(owner.rearm(Frame{2, {}}));
+    EXPECT_EQ(borrower.generation(), 2U);
+
+    auto ref = borrower.try_make_ref();
+    ASSERT_TRUE(ref);
+    EXPECT_EQ((*ref)->sequence, 2U);
+}
+
+TEST_F(SharedMemoryOwnerTest, ChildProcessBorrowsInPlace)
+{
+    frame_owner owner(segment);
+    owner.rearm(Frame{99, {}});
+    const int fd = segment.fd();
+
+    const int status = run_in_child(
+        [fd]
+        {
+            shared_segment mapped = shared_segment::from_fd(dup(fd));
+            frame_borrower borrower(mapped);
+            auto           ref = borrower.try_make_ref();
+            if (!ref || (*ref)->sequence != 99)
+            {
+                return 1;
+            }
+            (*ref)->points[3] = 3.0F;  // Visible to the parent: same pages
+            return 0;
+        });
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(owner.get()->points[3], 3.0F);
+    EXPECT_EQ(owner.ref_count(), 0U);
+    EXPECT_TRUE(owner.mark_and_delete_if_ready());
+}
+
+TEST_F(SharedMemoryOwnerTest, ReclaimsReferencesOfCrashedHolder)
+{
+    frame_owner owner(segment);
+    owner.rearm(Frame{5, {}});
+    const int fd = segment.fd();
+
+    const int status = run_in_child(
+        [fd]
+        {
+            shared_segment mapped   = shared_segment::from_fd(dup(fd));
+            auto*          borrower = new frame_borrower(mapped);
+            auto*          ref      = new frame_borrower::reference(*borrower->try_make_ref());
+            static_cast<void>(ref);
+            _exit(0);  // Crash: nothing is released
+            return 1;
+        });
+    EXPECT_EQ(status, 0);
+    EXPECT_EQ(owner.ref_count(), 1U);
+    EXPECT_FALSE(owner.mark_and_delete_if_ready());
+
+    EXPECT_EQ(owner.reclaim_dead_holders(), 1U);
+    EXPECT_EQ(owner.ref_count(), 0U);
+    EXPECT_TRUE(owner.delete_if_deleteable());
+
+    // The crashed holder's slot is free again
+    frame_borrower borrower(segment);
+    EXPECT_TRUE(borrower);
+}
+
+TEST(SharedMemoryOwnerLayoutTest, HolderSlotsAreLimited)
+{
+    shared_segment segment = shared_segment::create_memfd("zoox_test", frame_owner::required_size(2));
+    frame_owner    owner(segment, 2);
+    ASSERT_TRUE(owner);
+
+    frame_borrower first(segment);
+    frame_borrower second(segment);
+    EXPECT_TRUE(first);
+    EXPECT_FALSE(second);
+}
+
+TEST(SharedMemoryOwnerLayoutTest, RejectsMismatchedSegments)
+{
+    shared_segment small = shared_segment::create_memfd("zoox_test", frame_owner::required_size() - 1);
+    EXPECT_FALSE(frame_owner(small));
+
+    shared_segment             segment = shared_segment::create_memfd("zoox_test", frame_owner::required_size());
+    frame_owner                owner(segment);
+    shm_borrower<std::int32_t> wrong_type(segment);
+    EXPECT_FALSE(wrong_type);
+
+    shared_segment blank = shared_segment::create_memfd("zoox_test", frame_owner::required_size());
+    frame_borrower unlaid(blank);
+    EXPECT_FALSE(unlaid);
+}
+
+TEST(SharedMemoryOwnerLayoutTest, NamedSegment)
+{
+    const std::string name    = "/zoox_shm_test_" + std::to_string(getpid());
+    shared_segment    created = shared_segment::create_shm(name.c_str(), frame_owner::required_size());
+    ASSERT_TRUE(created);
+    EXPECT_FALSE(shared_segment::create_shm(name.c_str(), frame_owner::required_size()));
+
+    frame_owner owner(created);
+    owner.rearm(Frame{11, {}});
+
+    shared_segment opened = shared_segment::open_shm(name.c_str());
+    ASSERT_TRUE(opened);
+    EXPECT_EQ(opened.size(), created.size());
+    frame_borrower borrower(opened);
+    auto           ref = borrower.try_make_ref();
+    ASSERT_TRUE(ref);
+    EXPECT_EQ((*ref)->sequence, 11U);
+
+    EXPECT_TRUE(shared_segment::unlink_shm(name.c_str()));
+    EXPECT_FALSE(shared_segment::open_shm(name.c_str()));
+}
+
+}  // namespace
+}  // namespace zoox
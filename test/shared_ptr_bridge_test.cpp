@@ -0,0 +1,172 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/shared_ptr_bridge.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+#include <malloc.h>
+
+namespace zoox
+{
+namespace
+{
+
+struct Cloud
+{
+    int                     points;
+    static std::atomic<int> live_count;
+
+    explicit Cloud(int n)
+        : points(n)
+    {
+        live_count.fetch_add(1);
+    }
+    ~Cloud()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Cloud::live_count{0};
+
+// Stand-in for a third-party API that keeps what it is given
+struct Consumer
+{
+    std::vector<std::shared_ptr<const Cloud>> kept;
+
+    void take(std::shared_ptr<const Cloud> cloud)
+    {
+        kept.push_back(std::move(cloud));
+    }
+};
+
+class SharedPtrBridgeTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Cloud::live_count.store(0);
+    }
+};
+
+TEST_F(SharedPtrBridgeTest, LastCopyReleasesTheReference)
+{
+    shared_ptr_bridge<Cloud> bridge;
+    ref_owner<Cloud>         cloud(new Cloud(12));
+    {
+        std::shared_ptr<Cloud> shared = bridge.try_share(cloud);
+        ASSERT_TRUE(shared);
+        EXPECT_EQ(shared.get(), cloud.get());
+        EXPECT_EQ(shared->points, 12);
+        EXPECT_EQ(cloud.ref_count(), 1U);
+        EXPECT_EQ(bridge.in_use(), 1U);
+
+        std::shared_ptr<Cloud> copy = shared;
+        shared.reset();
+        EXPECT_EQ(cloud.ref_count(), 1U);  // One registration for every copy
+        EXPECT_FALSE(cloud.mark_and_delete_if_ready());
+        EXPECT_EQ(copy->points, 12);
+    }
+    EXPECT_EQ(bridge.in_use(), 0U);
+    EXPECT_EQ(cloud.ref_count(), 0U);
+    EXPECT_TRUE(cloud.delete_if_deleteable());
+    EXPECT_EQ(Cloud::live_count.load(), 0);
+}
+
+TEST_F(SharedPtrBridgeTest, SharingDoesNotAllocate)
+{
+    shared_ptr_bridge<Cloud> bridge;
+    ref_owner<Cloud>         cloud(new Cloud(3));
+    Consumer                 consumer;
+    consumer.kept.reserve(16);
+    bridge.try_share(cloud).reset();  // Set up this thread's cache
+
+    // Heap bytes in use stay flat while the shared_ptrs are alive
+    const std::size_t heap_before = mallinfo2().uordblks;
+    for (int i = 0; i < 8; ++i)
+    {
+        consumer.take(bridge.try_share<const Cloud>(cloud));
+        auto ref = cloud.try_make_ref();
+        ASSERT_TRUE(ref);
+        consumer.take(bridge.share<const Cloud>(std::move(*ref)));
+    }
+    EXPECT_EQ(mallinfo2().uordblks, heap_before);
+    EXPECT_EQ(bridge.in_use(), 16U);
+    EXPECT_EQ(cloud.ref_count(), 16U);
+
+    consumer.kept.clear();
+    EXPECT_EQ(bridge.in_use(), 0U);
+    EXPECT_TRUE(cloud.mark_and_delete_if_ready());
+}
+
+TEST_F(SharedPtrBridgeTest, EmptyWhenMarkedOrExhausted)
+{
+    shared_ptr_bridge<Cloud, std::optional, std::default_delete<Cloud>, 2, 1> bridge;
+    ref_owner<Cloud>                                                          cloud(new Cloud(1));
+
+    auto first  = bridge.try_share(cloud);
+    auto second = bridge.try_share(cloud);
+    ASSERT_TRUE(first);
+    ASSERT_TRUE(second);
+    EXPECT_FALSE(bridge.try_share(cloud));
+    EXPECT_EQ(cloud.ref_count(), 2U);
+
+    {
+        auto ref = cloud.try_make_ref();
+        ASSERT_TRUE(ref);
+        EXPECT_FALSE(bridge.share(std::move(*ref)));
+        EXPECT_EQ(ref->get().points, 1);  // Still the caller's
+        EXPECT_EQ(cloud.ref_count(), 3U);
+    }
+
+    first.reset();
+    cloud.mark_for_deletion();
+    EXPECT_FALSE(bridge.try_share(cloud));
+    EXPECT_EQ(bridge.in_use(), 1U);
+
+    second.reset();
+    EXPECT_TRUE(cloud.delete_if_deleteable());
+}
+
+TEST_F(SharedPtrBridgeTest, CopiesDroppedOnOtherThreads)
+{
+    shared_ptr_bridge<Cloud> bridge;
+    ref_owner<Cloud>         cloud(new Cloud(7));
+    std::atomic<int>         mismatches{0};
+
+    for (int round = 0; round < 50; ++round)
+    {
+        std::shared_ptr<const Cloud> shared = bridge.try_share<const Cloud>(cloud);
+        ASSERT_TRUE(shared);
+        std::vector<std::thread> readers;
+        for (int t = 0; t < 4; ++t)
+        {
+            readers.emplace_back(
+                [&mismatches, copy = shared]
+                {
+                    if (copy->points != 7)
+                    {
+                        mismatches.fetch_add(1);
+                    }
+                });
+        }
+        shared.reset();
+        for (auto& r : readers)
+        {
+            r.join();
+        }
+        EXPECT_EQ(cloud.ref_count(), 0U);
+    }
+    EXPECT_EQ(mismatches.load(), 0);
+    EXPECT_EQ(bridge.in_use(), 0U);
+    EXPECT_TRUE(cloud.mark_and_delete_if_ready());
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,275 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/topic_bus.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace zoox
+{
+namespace
+{
+
+struct Message
+{
+    int                     value;
+    static std::atomic<int> live_count;
+
+    explicit Message(int v)
+        : value(v)
+    {
+        live_count.fetch_add(1);
+    }
+    Message(const Message& other)
+        : value(other.value)
+    {
+        live_count.fetch_add(1);
+    }
+    ~Message()
+    {
+        live_count.fetch_sub(1);
+    }
+};
+
+std::atomic<int> Message::live_count{0};
+
+class TopicBusTest : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        Message::live_count.store(0);
+    }
+};
+
+TEST_F(TopicBusTest, PublishWithoutSubscribersConstructsNothing)
+{
+    topic_bus<Message> bus;
+    publish_result     result = bus.publish(1);
+    EXPECT_EQ(result.delivered, 0U);
+    EXPECT_EQ(Message::live_count.load(), 0);
+}
+
+TEST_F(TopicBusTest, FanOutSharesOneMessage)
+{
+    topic_bus<Message> bus;
+    auto               a = bus.subscribe();
+    auto               b = bus.subscribe();
+    auto               c = bus.subscribe();
+    EXPECT_EQ(bus.subscriber_count(), 3U);
+
+    publish_result result = bus.publish(42);
+    EXPECT_EQ(result.delivered, 3U);
+    EXPECT_EQ(result.dropped, 0U);
+    EXPECT_EQ(Message::live_count.load(), 1);
+
+    auto ra = a.try_receive();
+    auto rb = b.try_receive();
+    auto rc = c.try_receive();
+    ASSERT_TRUE(ra && rb && rc);
+    EXPECT_EQ(ra->get().value, 42);
+    EXPECT_EQ(&ra->get(), &rb->get());
+    EXPECT_EQ(&rb->get(), &rc->get());
+    EXPECT_FALSE(a.try_receive());
+}
+
+TEST_F(TopicBusTest, ReclaimWaitsForEverySubscriber)
+{
+    topic_bus<Message> bus;
+    auto               a = bus.subscribe();
+    auto               b = bus.subscribe();
+    bus.publish(7);
+
+    {
+        auto ra = a.try_receive();
+        ASSERT_TRUE(ra);
+    }
+    EXPECT_EQ(bus.reclaim(), 1U);
+    EXPECT_EQ(Message::live_count.load(), 1);
+
+    {
+        auto rb = b.try_receive();
+        ASSERT_TRUE(rb);
+        EXPECT_EQ(bus.reclaim(), 1U);
+    }
+    EXPECT_EQ(bus.reclaim(), 0U);
+    EXPECT_EQ(Message::live_count.load(), 0);
+}
+
+TEST_F(TopicBusTest, FullQueueDropsForThatSubscriberOnly)
+{
+    topic_bus<Message, std::optional, 2> bus;
+    auto                                 slow = bus.subscribe();
+    auto                                 fast = bus.subscribe();
+
+    EXPECT_EQ(bus.publish(1).dropped, 0U);
+    EXPECT_TRUE(fast.try_receive());
+    EXPECT_EQ(bus.publish(2).dropped, 0U);
+    EXPECT_TRUE(fast.try_receive());
+
+    publish_result result = bus.publish(3);
+    EXPECT_EQ(result.delivered, 1U);
+    EXPECT_EQ(result.dropped, 1U);
+    EXPECT_EQ(slow.dropped(), 1U);
+    EXPECT_EQ(fast.dropped(), 0U);
+    EXPECT_EQ(slow.pending(), 2U);
+
+    auto third = fast.try_receive();
+    ASSERT_TRUE(third);
+    EXPECT_EQ(third->get().value, 3);
+}
+
+TEST_F(TopicBusTest, UnsubscribeReleasesQueuedMessages)
+{
+    topic_bus<Message> bus;
+    auto               keep = bus.subscribe();
+    {
+        auto leave = bus.subscribe();
+        bus.publish(1);
+        bus.publish(2);
+        EXPECT_EQ(leave.pending(), 2U);
+    }
+    EXPECT_EQ(bus.subscriber_count(), 1U);
+
+    while (keep.try_receive())
+    {
+    }
+    bus.reclaim();
+    EXPECT_EQ(bus.reclaim(), 0U);
+    EXPECT_EQ(Message::live_count.load(), 0);
+}
+
+TEST_F(TopicBusTest, ReclaimIntervalReclaimsDuringPublish)
+{
+    topic_bus_options options;
+    options.reclaim_interval = 4;
+    topic_bus<Message> bus(options);
+    auto               sub = bus.subscribe();
+
+    for (int i = 0; i < 16; ++i)
+    {
+        bus.publish(i);
+        EXPECT_TRUE(sub.try_receive());
+    }
+    EXPECT_LE(Message::live_count.load(), 3);
+    bus.reclaim();
+    EXPECT_EQ(Message::live_count.load(), 0);
+}
+
+TEST_F(TopicBusTest, CloseWakesBlockedReceiver)
+{
+    topic_bus<Message> bus;
+    auto               sub = bus.subscribe();
+
+    std::thread receiver(
+        [&]
+        {
+            int received = 0;
+            while (auto msg = sub.receive())
+            {
+                ++received;
+            }
+            EXPECT_EQ(received, 1);
+        });
+    bus.publish(1);
+    bus.close();
+    receiver.join();
+
+    EXPECT_TRUE(bus.is_closed());
+    EXPECT_EQ(bus.publish(2).delivered, 0U);
+    bus.reclaim();
+    EXPECT_EQ(Message::live_count.load(), 0);
+}
+
+TEST_F(TopicBusTest, ConcurrentPublishersAndSubscribers)
+{
+    constexpr int kPublishers  = 3;
+    constexpr int kSubscribers = 3;
+    constexpr int kPerThread   = 2000;
+
+    topic_bus<Message, std::optional, 64> bus;
+    std::vector<topic_bus<Message, std::optional, 64>::subscription> subs;
+    for (int i = 0; i < kSubscribers; ++i)
+    {
+        subs.push_back(bus.subscribe());
+    }
+
+    std::atomic<int>         publishers_done{0};
+    std::atomic<std::size_t> delivered{0};
+    std::atomic<std::size_t> received{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < kPublishers; ++p)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                for (int i = 0; i < kPerThread; ++i)
+                {
+                    delivered.fetch_add(bus.publish(i).delivered);
+                }
+                publishers_done.fetch_add(1);
+            });
+    }
+    for (auto& sub : subs)
+    {
+        threads.emplace_back(
+            [&]
+            {
+                while (publishers_done.load() < kPublishers || sub.pending() != 0)
+                {
+                    received.fetch_add(sub.try_receive_n([](auto&&) {}, 16));
+                }
+            });
+    }
+    std::thread reclaimer(
+        [&]
+        {
+            while (publishers_done.load() < kPublishers)
+            {
+                bus.reclaim();
+            }
+        });
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    reclaimer.join();
+
+    EXPECT_EQ(received.load(), delivered.load());
+    EXPECT_EQ(bus.reclaim(), 0U);
+    EXPECT_EQ(Message::live_count.load(), 0);
+}
+
+TEST_F(TopicBusTest, SubscribeChurnDuringPublish)
+{
+    topic_bus<Message> bus;
+    auto               stable = bus.subscribe();
+    std::atomic<bool>  done{false};
+
+    std::thread churn(
+        [&]
+        {
+            while (!done.load())
+            {
+                auto transient = bus.subscribe();
+                transient.try_receive();
+            }
+        });
+    for (int i = 0; i < 2000; ++i)
+    {
+        bus.publish(i);
+        EXPECT_TRUE(stable.try_receive());
+    }
+    done.store(true);
+    churn.join();
+
+    EXPECT_EQ(bus.reclaim(), 0U);
+    EXPECT_EQ(Message::live_count.load(), 0);
+}
+
+}  // namespace
+}  // namespace zoox
@@ -0,0 +1,80 @@
+// Copyright (c) Zoox.
+// SPDX-License-Identifier: MIT
+
+#include "zoox/memory_w_ref_owner.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+namespace zoox
+{
+namespace
+{
+
+// True if this executable's .note.stapsdt describes zoox:<name>
+bool has_probe(const std::string& image, const char* name)
+{
+    const std::string entry = std::string("zoox") + '\0' + name + '\0';
+    return image.find(entry) != std::string::npos;
+}
+
+std::string read_self()
+{
+    std::ifstream file("/proc/self/exe", std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+TEST(UsdtProbesTest, ProbesAreEmittedForEveryOperation)
+{
+    if (!ZOOX_PROBES_ENABLED)
+    {
+        GTEST_SKIP() << "probes are compiled out on this target";
+    }
+
+    // Exercise every probe site so each one is instantiated in this binary
+    ref_owner<int> owner(new int(1));
+    {
+        auto ref = owner.try_make_ref();
+        ASSERT_TRUE(ref);
+        EXPECT_TRUE(owner.try_make_refs(2, [](unique_reference<int>&&) {}));
+        owner.mark_for_deletion();
+        EXPECT_FALSE(owner.delete_if_deleteable());
+    }
+    EXPECT_TRUE(owner.delete_if_deleteable());
+
+    ref_owner<int> exclusive(new int(3));
+    {
+        auto borrow = exclusive.try_make_exclusive_ref();
+        ASSERT_TRUE(borrow);
+        EXPECT_FALSE(exclusive.try_make_exclusive_ref());
+    }
+    EXPECT_TRUE(exclusive.mark_and_delete_if_ready());
+
+    waitable_ref_owner<int> waitable(new int(2));
+    EXPECT_TRUE(waitable.try_make_ref());
+    EXPECT_TRUE(waitable.mark_and_wait_for_deletion(std::chrono::milliseconds(10)));
+
+    const std::string image = read_self();
+    ASSERT_FALSE(image.empty());
+    EXPECT_NE(image.find(".note.stapsdt"), std::string::npos);
+    for (const char* name :
+         {"ref_register", "refs_register", "ref_release", "mark", "delete", "wait_begin", "wait_end", "notify"})
+    {
+        EXPECT_TRUE(has_probe(image, name)) << name;
+    }
+}
+
+TEST(UsdtProbesTest, ArgumentsAreEightByteValues)
+{
+    EXPECT_EQ(detail::probe_arg(static_cast<const void*>(nullptr)), 0U);
+    EXPECT_EQ(detail::probe_arg(true), 1U);
+    EXPECT_EQ(detail::probe_arg(ref_owner_delete_outcome::refs_outstanding), 3U);
+    EXPECT_EQ(detail::probe_arg(std::size_t{42}), 42U);
+}
+
+}  // namespace
+}  // namespace zoox